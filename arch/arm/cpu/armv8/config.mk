@@ -9,6 +9,9 @@ PLATFORM_RELFLAGS += -fno-common -ffixed-x18
 PF_NO_UNALIGNED := $(call cc-option, -mstrict-align)
 PLATFORM_CPPFLAGS += $(PF_NO_UNALIGNED)
 
+# keep atomics inline, the outline ones in libgcc need the C library
+PLATFORM_CPPFLAGS += $(call cc-option, -mno-outline-atomics)
+
 EFI_LDS := elf_aarch64_efi.lds
 EFI_CRT0 := crt0_aarch64_efi.o
 EFI_RELOC := reloc_aarch64_efi.o
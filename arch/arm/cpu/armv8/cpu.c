@@ -13,6 +13,7 @@
 
 #include <common.h>
 #include <command.h>
+#include <smp_job.h>
 #include <asm/system.h>
 #include <asm/secure.h>
 #include <linux/compiler.h>
@@ -39,6 +40,10 @@ int cleanup_before_linux(void)
 	 *
 	 * disable interrupt and turn off caches etc ...
 	 */
+#if !defined(CONFIG_SPL_BUILD) && defined(CONFIG_SMP_JOB)
+	/* while the caches are on, as the queue needs them */
+	smp_job_stop();
+#endif
 	disable_interrupts();
 
 	/*
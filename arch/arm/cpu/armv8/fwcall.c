@@ -117,6 +117,24 @@ void __noreturn __efi_runtime psci_system_off(void)
 		;
 }
 
+unsigned long psci_call(unsigned long fn, unsigned long arg0,
+			unsigned long arg1, unsigned long arg2)
+{
+	struct pt_regs regs;
+
+	regs.regs[0] = fn;
+	regs.regs[1] = arg0;
+	regs.regs[2] = arg1;
+	regs.regs[3] = arg2;
+
+	if (use_smc_for_psci)
+		smc_call(&regs);
+	else
+		hvc_call(&regs);
+
+	return regs.regs[0];
+}
+
 #ifdef CONFIG_CMD_POWEROFF
 int do_poweroff(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
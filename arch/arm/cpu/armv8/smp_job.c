@@ -0,0 +1,183 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <fdt_support.h>
+#include <malloc.h>
+#include <smp_job.h>
+#include <asm/psci.h>
+#include <asm/system.h>
+#include <linux/libfdt.h>
+#include <linux/sizes.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+#define SMP_JOB_STACK_SIZE	SZ_16K
+#define MPIDR_HWID_MASK		0xff00ffffffUL
+#define SMP_JOB_STOP_MS		100
+
+/*
+ * How a secondary CPU starts, read by smp_job_entry with the MMU off: the
+ * stack, global data and the MMU set up as on the boot CPU. The stack is
+ * above, in the same allocation.
+ */
+struct smp_job_boot {
+	ulong sp;
+	ulong gd;
+	ulong vbar;
+	ulong mair;
+	ulong tcr;
+	ulong ttbr0;
+	ulong sctlr;
+};
+
+struct smp_job_cpu {
+	ulong mpidr;
+	struct smp_job_boot *boot;
+};
+
+/* The boot CPU first, then those started */
+static struct smp_job_cpu cpu[CONFIG_SMP_JOB_CPUS];
+static uint cpus = 1;
+
+void smp_job_entry(void);
+void smp_job_armv8_main(void);
+
+/* Read system register @name of the current exception level, EL1 or EL2 */
+#define read_sysreg_el(name)						\
+	({								\
+		ulong __val;						\
+									\
+		if (current_el() == 2)					\
+			asm volatile("mrs %0, " #name "_el2" : "=r" (__val)); \
+		else							\
+			asm volatile("mrs %0, " #name "_el1" : "=r" (__val)); \
+		__val;							\
+	})
+
+static int smp_job_start_cpu(struct smp_job_cpu *c, ulong mpidr)
+{
+	struct smp_job_boot *boot = c->boot;
+	long ret;
+
+	if (!boot) {
+		boot = memalign(ARCH_DMA_MINALIGN, SMP_JOB_STACK_SIZE);
+		if (!boot)
+			return -ENOMEM;
+		c->boot = boot;
+	}
+	boot->sp = (ulong)boot + SMP_JOB_STACK_SIZE;
+	boot->gd = (ulong)gd;
+	boot->vbar = read_sysreg_el(vbar);
+	boot->mair = read_sysreg_el(mair);
+	boot->tcr = read_sysreg_el(tcr);
+	boot->ttbr0 = read_sysreg_el(ttbr0);
+	boot->sctlr = get_sctlr();
+	flush_dcache_range((ulong)boot,
+			   (ulong)boot + ALIGN(sizeof(*boot), ARCH_DMA_MINALIGN));
+
+	ret = psci_call(ARM_PSCI_0_2_FN64_CPU_ON, mpidr, (ulong)smp_job_entry,
+			(ulong)boot);
+	if (ret) {
+		debug("smp_job: cannot start CPU %lx: %ld\n", mpidr, ret);
+		return -EIO;
+	}
+	c->mpidr = mpidr;
+
+	return 0;
+}
+
+uint smp_job_arch_start(uint max)
+{
+	const void *blob = gd->fdt_blob;
+	const char *type, *method;
+	const fdt32_t *reg;
+	int parent, node, ac, len;
+	ulong mpidr;
+
+	cpu[0].mpidr = read_mpidr() & MPIDR_HWID_MASK;
+	cpus = 1;
+
+	/*
+	 * The queue takes exclusive loads and stores, which need the MMU and
+	 * D-cache, and the CPUs are started by the firmware at EL3
+	 */
+	if (current_el() == 3 || !dcache_status())
+		return 0;
+	parent = fdt_path_offset(blob, "/cpus");
+	if (parent < 0)
+		return 0;
+	ac = fdt_address_cells(blob, parent);
+	if (ac < 1 || ac > 2)
+		return 0;
+
+	fdt_for_each_subnode(node, blob, parent) {
+		if (cpus > max)
+			break;
+		type = fdt_getprop(blob, node, "device_type", NULL);
+		method = fdt_getprop(blob, node, "enable-method", NULL);
+		reg = fdt_getprop(blob, node, "reg", &len);
+		if (!type || strcmp(type, "cpu") || !method ||
+		    strcmp(method, "psci") || !reg || len < ac * 4)
+			continue;
+		mpidr = fdt_read_number(reg, ac) & MPIDR_HWID_MASK;
+		if (mpidr != cpu[0].mpidr &&
+		    !smp_job_start_cpu(&cpu[cpus], mpidr))
+			cpus++;
+	}
+
+	return cpus - 1;
+}
+
+void smp_job_arch_stop(void)
+{
+	ulong start = get_timer(0);
+	uint i;
+
+	for (i = 1; i < cpus; i++) {
+		while (psci_call(ARM_PSCI_0_2_FN64_AFFINITY_INFO, cpu[i].mpidr,
+				 0, 0) != PSCI_AFFINITY_LEVEL_OFF) {
+			if (get_timer(start) > SMP_JOB_STOP_MS) {
+				printf("CPU %lx does not power down\n",
+				       cpu[i].mpidr);
+				break;
+			}
+		}
+	}
+	cpus = 1;
+}
+
+void smp_job_arch_kick(void)
+{
+	asm volatile("dsb ishst\n\tsev" : : : "memory");
+}
+
+void smp_job_arch_idle(void)
+{
+	asm volatile("wfe" : : : "memory");
+}
+
+uint smp_job_arch_cpu(void)
+{
+	ulong mpidr = read_mpidr() & MPIDR_HWID_MASK;
+	uint i;
+
+	for (i = 1; i < cpus; i++) {
+		if (cpu[i].mpidr == mpidr)
+			return i;
+	}
+
+	return 0;
+}
+
+/* Called by smp_job_entry once the MMU is on */
+void smp_job_armv8_main(void)
+{
+	smp_job_secondary();
+
+	/* PSCI cleans the caches of the CPU as it powers it down */
+	psci_call(ARM_PSCI_0_2_FN_CPU_OFF, 0, 0, 0);
+}
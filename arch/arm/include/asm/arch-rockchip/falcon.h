@@ -0,0 +1,84 @@
+/* SPDX-License-Identifier:     GPL-2.0+ */
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ */
+
+#ifndef _ROCKCHIP_FALCON_H_
+#define _ROCKCHIP_FALCON_H_
+
+#include <spl.h>
+
+/*
+ * Falcon mode: 'spl export falcon' in U-Boot prepares a kernel and device
+ * tree as booti would and stores the fixed-up device tree, together with
+ * where the kernel is found, at CONFIG_ROCKCHIP_FALCON_ARGS_SECTOR of MMC
+ * device CONFIG_ROCKCHIP_FALCON_MMC_DEV. SPL then loads the kernel from
+ * the FAT partition and hands it to BL31 as BL33 instead of U-Boot.
+ */
+#define FALCON_MAGIC		0x4e434c46	/* "FLCN" */
+#define FALCON_NAME_LEN		64
+
+/**
+ * struct falcon_args - header in the first sector of the Falcon area
+ *
+ * The fixed-up device tree follows in the next sectors.
+ *
+ * @magic:	FALCON_MAGIC, anything else means no Falcon boot
+ * @hcrc:	CRC32 of the header, with @hcrc 0
+ * @part:	Partition of the MMC device holding @kernel and @fdt
+ * @kernel_addr: Kernel entry, where booti placed the Image
+ * @fdt_addr:	Address of the fixed-up device tree
+ * @fdt_size:	Size of the fixed-up device tree
+ * @fdt_crc:	CRC32 of the fixed-up device tree
+ * @src_fdt_size: Size of @fdt when exported
+ * @src_fdt_crc: CRC32 of @fdt when exported
+ * @kernel:	Name of the kernel Image file
+ * @fdt:	Name of the device tree file
+ */
+struct falcon_args {
+	u32 magic;
+	u32 hcrc;
+	u32 part;
+	u32 kernel_addr;
+	u32 fdt_addr;
+	u32 fdt_size;
+	u32 fdt_crc;
+	u32 src_fdt_size;
+	u32 src_fdt_crc;
+	char kernel[FALCON_NAME_LEN];
+	char fdt[FALCON_NAME_LEN];
+};
+
+/**
+ * falcon_args_valid() - Check the header of the Falcon area
+ *
+ * @args:	Header read from the Falcon area
+ * @return true if it describes a kernel to boot
+ */
+bool falcon_args_valid(struct falcon_args *args);
+
+/**
+ * falcon_mem_ok() - Check that SPL leaves memory free for Linux
+ *
+ * SPL's text, stack and malloc() area are below CONFIG_SPL_STACK_R_ADDR
+ * and its BSS is at CONFIG_SPL_BSS_START_ADDR, so neither the kernel nor
+ * its device tree can be loaded there.
+ *
+ * @start:	Start address
+ * @size:	Size in bytes
+ * @return true if SPL does not use any of it
+ */
+bool falcon_mem_ok(ulong start, ulong size);
+
+/**
+ * spl_falcon_setup() - Set up SPL to start Linux instead of U-Boot
+ *
+ * Does nothing if a key is pressed on the console, which U-Boot then
+ * takes as a hotkey, or if the Falcon area is empty or out of date. Else
+ * the kernel and device tree are loaded and BL31 is told to start Linux.
+ *
+ * @spl_image:	Image loaded from the FIT, with BL31 and U-Boot
+ */
+void spl_falcon_setup(struct spl_image_info *spl_image);
+
+#endif
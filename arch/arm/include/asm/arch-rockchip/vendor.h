@@ -10,6 +10,7 @@
 #define VENDOR_WIFI_MAC_ID	2 /* wifi mac */
 #define VENDOR_LAN_MAC_ID	3 /* lan mac */
 #define VENDOR_BLUETOOTH_ID	4 /* bluetooth mac */
+#define VENDOR_DISPLAY_CACHE_ID	32 /* resolved display timing */
 
 struct vendor_item {
 	u16  id;
@@ -255,6 +255,18 @@ void smc_call(struct pt_regs *args);
 void __noreturn psci_system_reset(void);
 void __noreturn psci_system_off(void);
 
+/**
+ * psci_call() - Call the PSCI firmware
+ *
+ * @fn:		Function ID (ARM_PSCI_0_2_FN...)
+ * @arg0:	First argument
+ * @arg1:	Second argument
+ * @arg2:	Third argument
+ * @return what the function returns in x0
+ */
+unsigned long psci_call(unsigned long fn, unsigned long arg0,
+			unsigned long arg1, unsigned long arg2);
+
 #ifdef CONFIG_ARMV8_PSCI
 extern char __secure_start[];
 extern char __secure_end[];
@@ -577,11 +577,22 @@ void arch_preboot_os(uint32_t bootm_state)
 		hotkey_run(HK_CLI_OS_PRE);
 }
 
+#ifdef CONFIG_DRM_ROCKCHIP_PANEL_ASYNC
+void board_idle_poll(void)
+{
+	/* carry on powering up the panel while nobody types */
+	rockchip_display_poll();
+}
+#endif
+
 void board_quiesce_devices(void)
 {
 	hotkey_run(HK_CMDLINE);
 	hotkey_run(HK_CLI_OS_GO);
 
+	/* The kernel takes over a fully powered up panel */
+	rockchip_display_wait();
+
 #ifdef CONFIG_ROCKCHIP_PRELOADER_ATAGS
 	/* Destroy atags makes next warm boot safer */
 	atags_destroy();
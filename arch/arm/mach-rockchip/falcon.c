@@ -0,0 +1,353 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:     GPL-2.0+
+ */
+
+#include <common.h>
+#include <blk.h>
+#include <bootm.h>
+#include <cmd_spl.h>
+#include <fat.h>
+#include <fs.h>
+#include <mapmem.h>
+#include <memalign.h>
+#include <mmc.h>
+#include <spl.h>
+#include <u-boot/crc.h>
+#include <asm/sections.h>
+#include <asm/unaligned.h>
+#include <asm/arch/falcon.h>
+#include <linux/libfdt.h>
+#include <linux/sizes.h>
+
+bool falcon_args_valid(struct falcon_args *args)
+{
+	struct falcon_args hdr = *args;
+
+	if (args->magic != FALCON_MAGIC)
+		return false;
+	hdr.hcrc = 0;
+	if (crc32(0, (const uchar *)&hdr, sizeof(hdr)) != args->hcrc)
+		return false;
+
+	return memchr(args->kernel, '\0', FALCON_NAME_LEN) &&
+	       memchr(args->fdt, '\0', FALCON_NAME_LEN);
+}
+
+static bool falcon_overlaps(ulong start, ulong size, ulong base, ulong len)
+{
+	return start < base + len && base < start + size;
+}
+
+bool falcon_mem_ok(ulong start, ulong size)
+{
+	if (start < CONFIG_SPL_STACK_R_ADDR || start + size < start)
+		return false;
+#ifdef CONFIG_SPL_BSS_START_ADDR
+	if (falcon_overlaps(start, size, CONFIG_SPL_BSS_START_ADDR,
+			    CONFIG_SPL_BSS_MAX_SIZE))
+		return false;
+#endif
+
+	return true;
+}
+
+#ifdef CONFIG_SPL_BUILD
+/* See Documentation/arm64/booting.txt in the Linux kernel */
+#define IMAGE_TEXT_OFFSET	0x08
+#define IMAGE_SIZE		0x10
+#define IMAGE_MAGIC		0x38
+#define IMAGE_HEADER_SIZE	0x40
+#define LINUX_ARM64_IMAGE_MAGIC	0x644d5241
+
+/*
+ * Check that @size bytes at @start keep off SPL, see falcon_mem_ok(), and
+ * off the device tree passed to BL31.
+ */
+static bool falcon_range_ok(struct spl_image_info *spl_image, ulong start,
+			    ulong size)
+{
+	void *blob = spl_image->fdt_addr;
+
+	if (!falcon_mem_ok(start, size))
+		return false;
+	if (falcon_overlaps(start, size, (ulong)__bss_start,
+			    __bss_end - __bss_start))
+		return false;
+	if (blob && falcon_overlaps(start, size, map_to_sysmem(blob),
+				    fdt_totalsize(blob)))
+		return false;
+
+	return true;
+}
+
+/* Check that @args->fdt is still the device tree which was exported */
+static int falcon_check_fdt(struct falcon_args *args)
+{
+	void *buf = map_sysmem(CONFIG_SYS_LOAD_ADDR, args->src_fdt_size);
+	loff_t size, actread;
+
+	if (fat_size(args->fdt, &size) || size != args->src_fdt_size ||
+	    file_fat_read_at(args->fdt, 0, buf, size, &actread) ||
+	    actread != size ||
+	    crc32(0, buf, size) != args->src_fdt_crc) {
+		printf("Falcon: %s changed, run 'spl export falcon' again\n",
+		       args->fdt);
+		return -ESTALE;
+	}
+
+	return 0;
+}
+
+static int falcon_load_kernel(struct spl_image_info *spl_image,
+			      struct falcon_args *args)
+{
+	ulong addr = args->kernel_addr;
+	ulong text_offset, image_size;
+	loff_t size, actread;
+	u8 *ih;
+
+	if (fat_size(args->kernel, &size)) {
+		printf("Falcon: cannot find %s\n", args->kernel);
+		return -ENOENT;
+	}
+	if (!falcon_range_ok(spl_image, addr, size) ||
+	    falcon_overlaps(addr, size, args->fdt_addr, args->fdt_size)) {
+		printf("Falcon: %s does not fit at %lx\n", args->kernel, addr);
+		return -ENOSPC;
+	}
+	ih = map_sysmem(addr, size);
+	if (file_fat_read_at(args->kernel, 0, ih, size, &actread) ||
+	    actread != size || size < IMAGE_HEADER_SIZE) {
+		printf("Falcon: cannot read %s\n", args->kernel);
+		return -EIO;
+	}
+
+	/* booti placed the Image by its header, which may have changed */
+	if (get_unaligned_le32(ih + IMAGE_MAGIC) != LINUX_ARM64_IMAGE_MAGIC) {
+		printf("Falcon: %s is not an arm64 Image\n", args->kernel);
+		return -ENOEXEC;
+	}
+	image_size = get_unaligned_le64(ih + IMAGE_SIZE);
+	if (image_size) {
+		text_offset = get_unaligned_le64(ih + IMAGE_TEXT_OFFSET);
+	} else {
+		image_size = 16 << 20;
+		text_offset = 0x80000;
+	}
+	if ((addr & (SZ_2M - 1)) != text_offset ||
+	    !falcon_range_ok(spl_image, addr, image_size) ||
+	    falcon_overlaps(addr, image_size, args->fdt_addr,
+			    args->fdt_size)) {
+		printf("Falcon: %s changed, run 'spl export falcon' again\n",
+		       args->kernel);
+		return -ESTALE;
+	}
+
+	return 0;
+}
+
+static int falcon_load(struct spl_image_info *spl_image,
+		       struct blk_desc *desc, struct falcon_args *args)
+{
+	ulong count = DIV_ROUND_UP(args->fdt_size, desc->blksz);
+	void *fdt;
+	int ret;
+
+	if (count >= CONFIG_ROCKCHIP_FALCON_ARGS_SECTORS ||
+	    !falcon_range_ok(spl_image, args->fdt_addr,
+			     count * desc->blksz)) {
+		printf("Falcon: device tree does not fit at %x\n",
+		       args->fdt_addr);
+		return -ENOSPC;
+	}
+
+	ret = fat_register_device(desc, args->part);
+	if (ret) {
+		printf("Falcon: no FAT partition %u\n", args->part);
+		return ret;
+	}
+	ret = falcon_check_fdt(args);
+	if (ret)
+		return ret;
+
+	fdt = map_sysmem(args->fdt_addr, args->fdt_size);
+	if (blk_dread(desc, CONFIG_ROCKCHIP_FALCON_ARGS_SECTOR + 1, count,
+		      fdt) != count ||
+	    crc32(0, fdt, args->fdt_size) != args->fdt_crc ||
+	    fdt_check_header(fdt)) {
+		puts("Falcon: bad device tree\n");
+		return -EINVAL;
+	}
+
+	return falcon_load_kernel(spl_image, args);
+}
+
+static void falcon_setup(struct spl_image_info *spl_image,
+			 struct blk_desc *desc)
+{
+	ALLOC_CACHE_ALIGN_BUFFER(u8, buf, desc->blksz);
+	struct falcon_args *args = (struct falcon_args *)buf;
+
+	if (blk_dread(desc, CONFIG_ROCKCHIP_FALCON_ARGS_SECTOR, 1, buf) != 1 ||
+	    !falcon_args_valid(args))
+		return;
+
+	bootstage_start(BOOTSTAGE_ID_ACCUM_SPL_FALCON, "spl_falcon");
+	if (falcon_load(spl_image, desc, args))
+		return;
+	bootstage_accum(BOOTSTAGE_ID_ACCUM_SPL_FALCON);
+
+	printf("Falcon: starting %s with %s\n", args->kernel, args->fdt);
+	spl_image->entry_point_bl33 = args->kernel_addr;
+	spl_image->fdt_addr_bl33 = map_sysmem(args->fdt_addr, 0);
+}
+
+void spl_falcon_setup(struct spl_image_info *spl_image)
+{
+	struct mmc *mmc;
+
+	/* leave the key for U-Boot to take as a hotkey */
+	if (tstc()) {
+		puts("Falcon: key pressed, starting U-Boot\n");
+		return;
+	}
+
+	mmc = find_mmc_device(CONFIG_ROCKCHIP_FALCON_MMC_DEV);
+	if (mmc && !mmc_init(mmc))
+		falcon_setup(spl_image, mmc_get_blk_desc(mmc));
+}
+#else
+static int falcon_write_desc(struct blk_desc *desc, struct falcon_args *args,
+			     void *fdt)
+{
+	ALLOC_CACHE_ALIGN_BUFFER(u8, buf, desc->blksz);
+	ulong count = 0;
+
+	if (fdt) {
+		count = DIV_ROUND_UP(args->fdt_size, desc->blksz);
+		if (count >= CONFIG_ROCKCHIP_FALCON_ARGS_SECTORS) {
+			printf("Device tree too large, %u bytes\n",
+			       args->fdt_size);
+			return -E2BIG;
+		}
+	}
+
+	/* the header goes last, so SPL never sees it with a partial FDT */
+	if (count && blk_dwrite(desc, CONFIG_ROCKCHIP_FALCON_ARGS_SECTOR + 1,
+				count, fdt) != count)
+		return -EIO;
+	memset(buf, '\0', desc->blksz);
+	memcpy(buf, args, sizeof(*args));
+	if (blk_dwrite(desc, CONFIG_ROCKCHIP_FALCON_ARGS_SECTOR, 1, buf) != 1)
+		return -EIO;
+
+	return 0;
+}
+
+/* Write @args and the @fdt it describes, if any, to the Falcon area */
+static int falcon_write(struct falcon_args *args, void *fdt)
+{
+	struct blk_desc *desc;
+
+	desc = blk_get_devnum_by_type(IF_TYPE_MMC,
+				      CONFIG_ROCKCHIP_FALCON_MMC_DEV);
+	if (!desc) {
+		printf("No MMC device %d\n", CONFIG_ROCKCHIP_FALCON_MMC_DEV);
+		return -ENODEV;
+	}
+
+	return falcon_write_desc(desc, args, fdt);
+}
+
+/* Load @name from FAT partition @part to @addr, returning its size */
+static int falcon_load_file(int part, const char *name, ulong addr,
+			    loff_t *sizep)
+{
+	char dev_part[16];
+
+	if (strlen(name) >= FALCON_NAME_LEN) {
+		printf("File name too long: %s\n", name);
+		return -ENAMETOOLONG;
+	}
+	snprintf(dev_part, sizeof(dev_part), "%d:%x",
+		 CONFIG_ROCKCHIP_FALCON_MMC_DEV, part);
+	if (fs_set_blk_dev("mmc", dev_part, FS_TYPE_FAT) ||
+	    fs_read(name, addr, 0, 0, sizep)) {
+		printf("Cannot load %s from FAT partition mmc %s\n", name,
+		       dev_part);
+		return -ENOENT;
+	}
+
+	return 0;
+}
+
+int spl_export_falcon(int argc, char * const argv[])
+{
+	struct falcon_args args;
+	char *booti_argv[3];
+	ulong kernel_addr, fdt_addr, image_size;
+	loff_t size;
+	void *fdt;
+	int ret;
+
+	memset(&args, '\0', sizeof(args));
+	if (argc == 1 && !strcmp(argv[0], "off"))
+		return falcon_write(&args, NULL);
+	if (argc != 5)
+		return CMD_RET_USAGE;
+
+	kernel_addr = simple_strtoul(argv[0], NULL, 16);
+	fdt_addr = simple_strtoul(argv[1], NULL, 16);
+	args.part = simple_strtoul(argv[2], NULL, 16);
+	if (falcon_load_file(args.part, argv[3], kernel_addr, &size) ||
+	    falcon_load_file(args.part, argv[4], fdt_addr, &size))
+		return -ENOENT;
+	strcpy(args.kernel, argv[3]);
+	strcpy(args.fdt, argv[4]);
+	args.src_fdt_size = size;
+	args.src_fdt_crc = crc32(0, map_sysmem(fdt_addr, size), size);
+
+	booti_argv[0] = argv[0];
+	booti_argv[1] = "-";
+	booti_argv[2] = argv[1];
+	ret = booti_prep(ARRAY_SIZE(booti_argv), booti_argv);
+	if (ret)
+		return ret;
+
+	fdt = images.ft_addr;
+	args.magic = FALCON_MAGIC;
+	args.kernel_addr = images.ep;
+	args.fdt_addr = map_to_sysmem(fdt);
+	args.fdt_size = fdt_totalsize(fdt);
+
+	/* SPL would refuse these and quietly start U-Boot on every boot */
+	booti_image_dest(map_sysmem(images.ep, 0), images.ep, &kernel_addr,
+			 &image_size);
+	if (!falcon_mem_ok(args.kernel_addr, image_size)) {
+		printf("Falcon: %s at %x-%lx is used by SPL, load it higher\n",
+		       args.kernel, args.kernel_addr,
+		       args.kernel_addr + image_size);
+		return -EINVAL;
+	}
+	if (!falcon_mem_ok(args.fdt_addr, args.fdt_size) ||
+	    falcon_overlaps(args.kernel_addr, image_size, args.fdt_addr,
+			    args.fdt_size)) {
+		printf("Falcon: device tree at %x is used by SPL or %s\n",
+		       args.fdt_addr, args.kernel);
+		return -EINVAL;
+	}
+	args.fdt_crc = crc32(0, fdt, args.fdt_size);
+	args.hcrc = crc32(0, (const uchar *)&args, sizeof(args));
+	ret = falcon_write(&args, fdt);
+	if (ret)
+		return ret;
+
+	printf("Falcon: %s at %x, %s at %x, saved to mmc %d\n", args.kernel,
+	       args.kernel_addr, args.fdt, args.fdt_addr,
+	       CONFIG_ROCKCHIP_FALCON_MMC_DEV);
+
+	return 0;
+}
+#endif
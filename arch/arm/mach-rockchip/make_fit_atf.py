@@ -4,12 +4,17 @@ A script to generate FIT image source for rockchip boards
 with ARM Trusted Firmware
 and multiple device trees (given on the command line)
 
-usage: $0 <dt_name> [<dt_name> [<dt_name] ...]
+usage: $0 [-c lz4|lzma] <dt_name> [<dt_name> [<dt_name] ...]
+
+With -c, U-Boot and the ATF segments are compressed with the lz4 or lzma
+tool and marked as such in the FIT, for SPL to decompress them. Segments
+loaded to SRAM are left uncompressed, see DRAM_TOP.
 """
 
 import os
 import sys
 import getopt
+import subprocess
 
 # pip install pyelftools
 from elftools.elf.elffile import ELFFile
@@ -23,6 +28,18 @@ ELF_SEG_P_OFFSET='p_offset'
 ELF_SEG_P_FILESZ='p_filesz'
 ELF_SEG_P_MEMSZ='p_memsz'
 
+# Commands writing the compressed file given to stdout
+COMP_CMDS = {
+    'lz4': ['lz4', '-9', '-c'],
+    'lzma': ['lzma', '-9', '-c'],
+}
+comp = 'none'
+
+# Anything loaded at or above this is SRAM or device memory on all Rockchip
+# SoCs. SPL maps it as device memory, where the unaligned accesses of the
+# decompressors fault, so segments going there are never compressed.
+DRAM_TOP = 0xf8000000
+
 DT_HEADER="""/*
  * Copyright (C) 2017 Fuzhou Rockchip Electronics Co., Ltd
  *
@@ -39,11 +56,11 @@ DT_HEADER="""/*
 	images {
 		uboot@1 {
 			description = "U-Boot (64-bit)";
-			data = /incbin/("u-boot-nodtb.bin");
+			data = /incbin/("%s");
 			type = "standalone";
 			os = "U-Boot";
 			arch = "arm64";
-			compression = "none";
+			compression = "%s";
 			load = <0x%08x>;
 		};
 """
@@ -56,18 +73,43 @@ DT_END="""
 };
 """
 
+def load_comp(load_addr):
+    """
+    Get the compression of an image loaded at an address.
+    """
+    if load_addr >= DRAM_TOP:
+        return 'none'
+    return comp
+
+def comp_name(file_name, load_addr):
+    """
+    Get the name of the compressed version of a file.
+    """
+    if load_comp(load_addr) == 'none':
+        return file_name
+    return '%s.%s' % (file_name, comp)
+
+def compress_file(file_name, load_addr):
+    """
+    Write the compressed version of a file, if compressing.
+    """
+    if load_comp(load_addr) == 'none':
+        return
+    with open(comp_name(file_name, load_addr), 'wb') as out:
+        subprocess.check_call(COMP_CMDS[comp] + [file_name], stdout=out)
+
 def append_atf_node(file, atf_index, phy_addr):
     """
     Append ATF DT node to input FIT dts file.
     """
-    data = 'bl31_0x%08x.bin' % phy_addr
+    data = comp_name('bl31_0x%08x.bin' % phy_addr, phy_addr)
     print >> file, '\t\tatf@%d {' % atf_index
     print >> file, '\t\t\tdescription = \"ARM Trusted Firmware\";'
     print >> file, '\t\t\tdata = /incbin/("%s");' % data
     print >> file, '\t\t\ttype = "firmware";'
     print >> file, '\t\t\tarch = "arm64";'
     print >> file, '\t\t\tos = "arm-trusted-firmware";'
-    print >> file, '\t\t\tcompression = "none";'
+    print >> file, '\t\t\tcompression = "%s";' % load_comp(phy_addr)
     print >> file, '\t\t\tload = <0x%08x>;' % phy_addr
     if atf_index == 1:
         print >> file, '\t\t\tentry = <0x%08x>;' % phy_addr
@@ -119,15 +161,10 @@ def append_conf_node(file, dtbs, atf_cnt):
     print >> file, '\t};'
     print >> file, ''
 
-def generate_atf_fit_dts(fit_file_name, bl31_file_name, uboot_file_name, dtbs_file_name):
+def get_uboot_load_addr(uboot_file_name):
     """
-    Generate FIT script for ATF image.
+    Get the load address of U-Boot from its only loadable segment.
     """
-    if fit_file_name != sys.stdout:
-        fit_file = open(fit_file_name, "wb")
-    else:
-        fit_file = sys.stdout
-
     num_load_seg = 0
     p_paddr = 0xFFFFFFFF
     with open(uboot_file_name) as uboot_file:
@@ -139,8 +176,20 @@ def generate_atf_fit_dts(fit_file_name, bl31_file_name, uboot_file_name, dtbs_fi
                 num_load_seg = num_load_seg + 1
 
     assert (p_paddr != 0xFFFFFFFF and num_load_seg == 1)
+    return p_paddr
+
+def generate_atf_fit_dts(fit_file_name, bl31_file_name, uboot_file_name, dtbs_file_name):
+    """
+    Generate FIT script for ATF image.
+    """
+    if fit_file_name != sys.stdout:
+        fit_file = open(fit_file_name, "wb")
+    else:
+        fit_file = sys.stdout
 
-    print >> fit_file, DT_HEADER % p_paddr
+    p_paddr = get_uboot_load_addr(uboot_file_name)
+    print >> fit_file, DT_HEADER % (comp_name('u-boot-nodtb.bin', p_paddr),
+                                    load_comp(p_paddr), p_paddr)
 
     with open(bl31_file_name) as bl31_file:
         bl31 = ELFFile(bl31_file)
@@ -171,6 +220,7 @@ def generate_atf_binary(bl31_file_name):
                 file_name = 'bl31_0x%08x.bin' % paddr
                 with open(file_name, "wb") as atf:
                     atf.write(seg.data());
+                compress_file(file_name, paddr)
 
 def get_bl31_segments_info(bl31_file_name):
     """
@@ -194,11 +244,12 @@ def get_bl31_segments_info(bl31_file_name):
             print 'paddr: %08x' % paddr
 
 def main():
+    global comp
     uboot_elf="./u-boot"
     bl31_elf="./bl31.elf"
     FIT_ITS=sys.stdout
 
-    opts, args = getopt.getopt(sys.argv[1:], "o:u:b:h")
+    opts, args = getopt.getopt(sys.argv[1:], "o:u:b:c:h")
     for opt, val in opts:
         if opt == "-o":
             FIT_ITS=val
@@ -206,6 +257,11 @@ def main():
             uboot_elf=val
         elif opt == "-b":
             bl31_elf=val
+        elif opt == "-c":
+            if val != 'none' and val not in COMP_CMDS:
+                print >> sys.stderr, 'Unknown compression %s' % val
+                sys.exit(1)
+            comp=val
         elif opt == "-h":
             print __doc__
             sys.exit(2)
@@ -216,6 +272,7 @@ def main():
 
     generate_atf_fit_dts(FIT_ITS, bl31_elf, uboot_elf, dtbs)
     generate_atf_binary(bl31_elf);
+    compress_file('u-boot-nodtb.bin', get_uboot_load_addr(uboot_elf))
 
 if __name__ == "__main__":
     main()
@@ -10,6 +10,7 @@
 #include <ram.h>
 #include <spl.h>
 #include <asm/arch/bootrom.h>
+#include <asm/arch/falcon.h>
 #ifdef CONFIG_ROCKCHIP_PRELOADER_ATAGS
 #include <asm/arch/rk_atags.h>
 #endif
@@ -255,6 +256,9 @@ void spl_perform_fixups(struct spl_image_info *spl_image)
 {
 #ifdef CONFIG_ROCKCHIP_PRELOADER_ATAGS
 	atags_set_bootdev_by_spl_bootdevice(spl_image->boot_device);
+#endif
+#ifdef CONFIG_SPL_ROCKCHIP_FALCON
+	spl_falcon_setup(spl_image);
 #endif
 	return;
 }
@@ -182,6 +182,27 @@ void *os_realloc(void *ptr, size_t length)
 	return buf;
 }
 
+const void *os_mmap_file(int fd, off_t offset, size_t length)
+{
+	off_t start = offset & ~((off_t)getpagesize() - 1);
+	void *ptr;
+
+	ptr = mmap(NULL, length + offset - start, PROT_READ, MAP_SHARED, fd,
+		   start);
+	if (ptr == MAP_FAILED)
+		return NULL;
+
+	return ptr + offset - start;
+}
+
+void os_munmap_file(const void *ptr, size_t length)
+{
+	uintptr_t addr = (uintptr_t)ptr;
+	uintptr_t start = addr & ~((uintptr_t)getpagesize() - 1);
+
+	munmap((void *)start, length + addr - start);
+}
+
 void os_usleep(unsigned long usec)
 {
 	usleep(usec);
@@ -0,0 +1,77 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/types.h>
+
+#include <smp_job.h>
+
+/* Longest a CPU sleeps in smp_job_arch_idle() if a kick is missed */
+#define SMP_JOB_IDLE_NS		1000000
+
+/* Each secondary CPU is a host thread */
+static pthread_t thread[CONFIG_SMP_JOB_CPUS];
+static uint threads;
+static __thread uint cpu;
+
+static pthread_mutex_t idle_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t idle_cond = PTHREAD_COND_INITIALIZER;
+
+static void *smp_job_thread(void *arg)
+{
+	cpu = (uintptr_t)arg;
+	smp_job_secondary();
+
+	return NULL;
+}
+
+uint smp_job_arch_start(uint max)
+{
+	for (threads = 0; threads < max; threads++) {
+		if (pthread_create(&thread[threads], NULL, smp_job_thread,
+				   (void *)(uintptr_t)(threads + 1)))
+			break;
+	}
+
+	return threads;
+}
+
+void smp_job_arch_stop(void)
+{
+	while (threads)
+		pthread_join(thread[--threads], NULL);
+}
+
+void smp_job_arch_kick(void)
+{
+	pthread_mutex_lock(&idle_lock);
+	pthread_cond_broadcast(&idle_cond);
+	pthread_mutex_unlock(&idle_lock);
+}
+
+void smp_job_arch_idle(void)
+{
+	struct timespec ts;
+
+	/* a kick just before the wait is missed, so do not wait for long */
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_nsec += SMP_JOB_IDLE_NS;
+	if (ts.tv_nsec >= 1000000000) {
+		ts.tv_sec++;
+		ts.tv_nsec -= 1000000000;
+	}
+	pthread_mutex_lock(&idle_lock);
+	pthread_cond_timedwait(&idle_cond, &idle_lock, &ts);
+	pthread_mutex_unlock(&idle_lock);
+}
+
+uint smp_job_arch_cpu(void)
+{
+	return cpu;
+}
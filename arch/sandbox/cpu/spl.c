@@ -5,6 +5,9 @@
 
 #include <common.h>
 #include <dm.h>
+#include <image.h>
+#include <mapmem.h>
+#include <memalign.h>
 #include <os.h>
 #include <spl.h>
 #include <asm/spl.h>
@@ -25,6 +28,70 @@ u32 spl_boot_device(void)
 	return BOOT_DEVICE_BOARD;
 }
 
+#define SPL_FIT_BLKSZ	512
+
+void *board_spl_fit_buffer(ulong size)
+{
+	return map_sysmem((gd->ram_size - size) & ~(ARCH_DMA_MINALIGN - 1),
+			  size);
+}
+
+/* Read the FIT file as a block device would, sector by sector */
+static ulong spl_board_fit_read(struct spl_load_info *load, ulong sector,
+				ulong count, void *buf)
+{
+	int fd = (long)load->priv;
+	ssize_t ret;
+
+	if (os_lseek(fd, sector * load->bl_len, OS_SEEK_SET) < 0)
+		return 0;
+	ret = os_read(fd, buf, count * load->bl_len);
+	if (ret < 0)
+		return 0;
+
+	/* the last sector of the file may be partial */
+	return DIV_ROUND_UP(ret, load->bl_len);
+}
+
+/*
+ * Load u-boot.img, if it is next to U-Boot, as SPL would on a board. U-Boot
+ * is still run from its executable, this only shows what loading costs.
+ */
+static int spl_board_load_fit(struct spl_image_info *spl_image,
+			      const char *fname)
+{
+	ALLOC_CACHE_ALIGN_BUFFER(u8, header, SPL_FIT_BLKSZ);
+	const struct spl_fit_stats *stats;
+	struct spl_load_info load;
+	char fit_name[256];
+	int fd, ret;
+
+	snprintf(fit_name, sizeof(fit_name), "%s.img", fname);
+	fd = os_open(fit_name, OS_O_RDONLY);
+	if (fd < 0)
+		return 0;
+
+	memset(&load, '\0', sizeof(load));
+	load.priv = (void *)(long)fd;
+	load.bl_len = SPL_FIT_BLKSZ;
+	load.read = spl_board_fit_read;
+	if (spl_board_fit_read(&load, 0, 1, header) != 1 ||
+	    image_get_magic((struct image_header *)header) != FDT_MAGIC) {
+		os_close(fd);
+		return -EINVAL;
+	}
+	ret = spl_load_simple_fit(spl_image, &load, 0, header);
+	os_close(fd);
+	if (ret)
+		return ret;
+
+	stats = spl_fit_get_stats();
+	printf("SPL: FIT read %lu bytes, copied %lu, loaded %lu\n",
+	       stats->read, stats->copied, stats->loaded);
+
+	return 0;
+}
+
 static int spl_board_load_image(struct spl_image_info *spl_image,
 				struct spl_boot_device *bootdev)
 {
@@ -37,6 +104,12 @@ static int spl_board_load_image(struct spl_image_info *spl_image,
 		return ret;
 	}
 
+	ret = spl_board_load_fit(spl_image, fname);
+	if (ret) {
+		printf("(%s.img failed to load, error %d)\n", fname, ret);
+		return ret;
+	}
+
 	/* Hopefully this will not return */
 	return os_spl_to_uboot(fname);
 }
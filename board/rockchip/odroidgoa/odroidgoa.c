@@ -184,6 +184,11 @@ err:
 
 int rk_board_late_init(void)
 {
+#ifdef CONFIG_DRM_ROCKCHIP_PANEL_ASYNC
+	/* start powering up the panel early, it completes in the background */
+	lcd_init();
+#endif
+
 	switch (get_rg351_rev())
 	{
 		case MODEL_RG351V:
@@ -5,10 +5,12 @@
  */
 
 #include <common.h>
+#include <blk.h>
 #include <key.h>
 #include <dm.h>
 #include <console.h>
 #include <rockchip_display_cmds.h>
+#include <video_rockchip.h>
 #include <asm/io.h>
 #include <asm/arch/grf_px30.h>
 #include <asm/arch/hardware.h>
@@ -115,6 +117,40 @@ void odroid_wait_pwrkey(void)
 	run_command("poweroff", 0);
 }
 
+/*
+ * Unzip a logo stored in spi flash into bmp_mem. The compressed logo is used
+ * in place if the flash is memory-mapped, else it is read into bmp_copy.
+ */
+static int odroid_load_spi_logo(int logo_mode)
+{
+#if CONFIG_IS_ENABLED(BLK)
+	struct blk_desc *desc;
+	struct blk_map map;
+	unsigned long start, cnt, len;
+	int ret;
+
+	desc = blk_get_devnum_by_type(IF_TYPE_SPINOR, 1);
+	if (!desc)
+		return -ENODEV;
+
+	start = simple_strtoul(env_get(st_logo_modes[logo_mode]), NULL, 16);
+	cnt = simple_strtoul(env_get("sz_logo"), NULL, 16);
+	ret = blk_dmap(desc, start, cnt, (void *)bmp_copy, &map);
+	if (ret) {
+		printf("[%s] read logo fail: %d\n", __func__, ret);
+		return ret;
+	}
+
+	len = cnt * desc->blksz;
+	ret = gunzip((void *)bmp_mem, LCD_LOGO_SIZE, (void *)map.buf, &len);
+	blk_dunmap(desc, &map);
+
+	return ret;
+#else
+	return -ENOSYS;
+#endif
+}
+
 int odroid_display_status(int logo_mode, int logo_storage, const char *str)
 {
 	char cmd[128];
@@ -126,6 +162,12 @@ int odroid_display_status(int logo_mode, int logo_storage, const char *str)
 		return -1;
 	}
 
+	/*
+	 * Callers wait for a key or just delay with the status on screen, the
+	 * panel is not powered up in the background meanwhile.
+	 */
+	rockchip_display_wait();
+
 	/* draw logo bmp */
 	if (!bmp_mem) {
 		bmp_mem = lcd_get_mem();
@@ -134,13 +176,7 @@ int odroid_display_status(int logo_mode, int logo_storage, const char *str)
 
 	switch (logo_storage) {
 	case LOGO_STORAGE_SPIFLASH:
-		sprintf(cmd, "rksfc read %p %s %s", (void *)bmp_copy,
-			env_get(st_logo_modes[logo_mode]),
-			env_get("sz_logo"));
-		run_command(cmd, 0);
-
-		sprintf(cmd, "unzip %p %p", (void *)bmp_copy, (void *)bmp_mem);
-		run_command(cmd, 0);
+		odroid_load_spi_logo(logo_mode);
 
 		if (show_bmp(bmp_mem))
 			printf("[%s] show_bmp Fail!\n", __func__);
@@ -161,13 +197,7 @@ int odroid_display_status(int logo_mode, int logo_storage, const char *str)
 	case LOGO_STORAGE_ANYWHERE:
 	default:
 		/* try spi flash first */
-		sprintf(cmd, "rksfc read %p %s %s", (void *)bmp_copy,
-			env_get(st_logo_modes[logo_mode]),
-			env_get("sz_logo"));
-		run_command(cmd, 0);
-
-		sprintf(cmd, "unzip %p %p", (void *)bmp_copy, (void *)bmp_mem);
-		run_command(cmd, 0);
+		odroid_load_spi_logo(logo_mode);
 
 		if (show_bmp(bmp_mem)) {
 			/* then, check sd card */
@@ -35,18 +35,20 @@ struct Image_header {
 
 #define LINUX_ARM64_IMAGE_MAGIC	0x644d5241
 
-static int booti_setup(bootm_headers_t *images)
+/* An Image read straight to where it runs, see booti_image_placed() */
+static struct {
+	ulong addr;
+	ulong dst;
+} booti_placed;
+
+int booti_image_dest(const void *hdr, ulong addr, ulong *dstp, ulong *sizep)
 {
-	struct Image_header *ih;
+	const struct Image_header *ih = hdr;
 	uint64_t dst;
 	uint64_t image_size, text_offset;
 
-	ih = (struct Image_header *)map_sysmem(images->ep, 0);
-
-	if (ih->magic != le32_to_cpu(LINUX_ARM64_IMAGE_MAGIC)) {
-		puts("Bad Linux ARM64 Image magic!\n");
-		return 1;
-	}
+	if (ih->magic != le32_to_cpu(LINUX_ARM64_IMAGE_MAGIC))
+		return -ENOEXEC;
 
 	/*
 	 * Prior to Linux commit a2c1d73b94ed, the text_offset field
@@ -54,7 +56,6 @@ static int booti_setup(bootm_headers_t *images)
 	 * field is zero, and we can assume a fixed value of 0x80000.
 	 */
 	if (ih->image_size == 0) {
-		puts("Image lacks image_size field, assuming 16MiB\n");
 		image_size = 16 << 20;
 		text_offset = 0x80000;
 	} else {
@@ -69,22 +70,54 @@ static int booti_setup(bootm_headers_t *images)
 	 * since memory below it is not accessible via the linear mapping.
 	 */
 	if (le64_to_cpu(ih->flags) & BIT(3))
-		dst = images->ep - text_offset;
+		dst = addr - text_offset;
 	else
 		dst = gd->bd->bi_dram[0].start;
 
-	dst = ALIGN(dst, SZ_2M) + text_offset;
+	*dstp = ALIGN(dst, SZ_2M) + text_offset;
+	if (sizep)
+		*sizep = image_size;
+
+	return 0;
+}
+
+void booti_image_placed(ulong addr, ulong dst)
+{
+	booti_placed.addr = addr;
+	booti_placed.dst = dst;
+}
+
+static int booti_setup(bootm_headers_t *images)
+{
+	struct Image_header *ih;
+	ulong dst, image_size;
+	void *src;
+
+	/* the loader left the header behind, the Image is where it runs */
+	if (images->ep == booti_placed.addr &&
+	    images->ep != booti_placed.dst &&
+	    !memcmp(map_sysmem(images->ep, 0),
+		    map_sysmem(booti_placed.dst, 0), sizeof(*ih)))
+		images->ep = booti_placed.dst;
 
+	ih = (struct Image_header *)map_sysmem(images->ep, 0);
+	if (booti_image_dest(ih, images->ep, &dst, &image_size)) {
+		puts("Bad Linux ARM64 Image magic!\n");
+		return 1;
+	}
+	if (ih->image_size == 0)
+		puts("Image lacks image_size field, assuming 16MiB\n");
 	unmap_sysmem(ih);
 
 	if (images->ep != dst) {
-		void *src;
+		printf("Moving Image from 0x%lx to 0x%lx, %lu bytes\n",
+		       images->ep, dst, image_size);
 
-		debug("Moving Image from 0x%lx to 0x%llx\n", images->ep, dst);
-
-		src = (void *)images->ep;
+		bootstage_start(BOOTSTAGE_ID_ACCUM_KERNEL_MOVE, "kernel_move");
+		src = map_sysmem(images->ep, image_size);
 		images->ep = dst;
-		memmove((void *)dst, src, image_size);
+		memmove(map_sysmem(dst, image_size), src, image_size);
+		bootstage_accum(BOOTSTAGE_ID_ACCUM_KERNEL_MOVE);
 	}
 
 	return 0;
@@ -170,6 +203,23 @@ int do_booti(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 	return ret;
 }
 
+int booti_prep(int argc, char * const argv[])
+{
+	cmd_tbl_t *cmdtp = find_cmd("booti");
+
+	if (booti_start(cmdtp, 0, argc, argv, &images))
+		return -ENOEXEC;
+
+	images.os.os = IH_OS_LINUX;
+	images.os.arch = IH_ARCH_ARM64;
+
+	return do_bootm_states(cmdtp, 0, argc, argv,
+#ifdef CONFIG_SYS_BOOT_RAMDISK_HIGH
+			       BOOTM_STATE_RAMDISK |
+#endif
+			       BOOTM_STATE_OS_PREP, &images, 1);
+}
+
 #ifdef CONFIG_SYS_LONGHELP
 static char booti_help_text[] =
 	"[addr [initrd[:size]] [fdt]]\n"
@@ -27,14 +27,20 @@ U_BOOT_CMD(
 static int do_load_wrapper(cmd_tbl_t *cmdtp, int flag, int argc,
 				char * const argv[])
 {
-	efi_set_bootdev(argv[1], (argc > 2) ? argv[2] : "",
-			(argc > 4) ? argv[4] : "");
+	/* skip 'load -k' */
+	int i = argc > 1 && !strcmp(argv[1], "-k");
+
+	efi_set_bootdev(argv[1 + i], (argc > 2 + i) ? argv[2 + i] : "",
+			(argc > 4 + i) ? argv[4 + i] : "");
 	return do_load(cmdtp, flag, argc, argv, FS_TYPE_ANY);
 }
 
 U_BOOT_CMD(
-	load,	7,	0,	do_load_wrapper,
+	load,	8,	0,	do_load_wrapper,
 	"load binary file from a filesystem",
+#ifdef CONFIG_CMD_BOOTI_PLACE
+	"[-k] "
+#endif
 	"<interface> [<dev[:part]> [<addr> [<filename> [bytes [pos]]]]]\n"
 	"    - Load binary file 'filename' from partition 'part' on device\n"
 	"       type 'interface' instance 'dev' to address 'addr' in memory.\n"
@@ -42,6 +48,12 @@ U_BOOT_CMD(
 	"      If 'bytes' is 0 or omitted, the file is read until the end.\n"
 	"      'pos' gives the file byte position to start reading from.\n"
 	"      If 'pos' is 0 or omitted, the file is read from the start."
+#ifdef CONFIG_CMD_BOOTI_PLACE
+	"\n"
+	"      With -k, an arm64 Image is read to where booti runs it and\n"
+	"      only its header to 'addr', for booti to find it. 'fileaddr'\n"
+	"      is set to where the Image went."
+#endif
 )
 
 static int do_save_wrapper(cmd_tbl_t *cmdtp, int flag, int argc,
@@ -0,0 +1,58 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <malloc.h>
+#include <malloc_slab.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+static int do_malloc_stats(cmd_tbl_t *cmdtp, int flag, int argc,
+			   char * const argv[])
+{
+#if CONFIG_VAL(SYS_MALLOC_F_LEN)
+	printf("early: %lu of %lu bytes used before relocation\n",
+	       gd->malloc_ptr, gd->malloc_limit);
+#endif
+	printf("heap: %08lx-%08lx, %lu bytes taken from it\n",
+	       mem_malloc_start, mem_malloc_end,
+	       mem_malloc_brk - mem_malloc_start);
+#ifdef CONFIG_SYS_MALLOC_SLAB
+	if (gd->malloc_slab)
+		malloc_slab_stats(gd->malloc_slab);
+#endif
+
+	return 0;
+}
+
+static cmd_tbl_t cmd_malloc_sub[] = {
+	U_BOOT_CMD_MKENT(stats, 1, 1, do_malloc_stats, "", ""),
+};
+
+static int do_malloc(cmd_tbl_t *cmdtp, int flag, int argc,
+		     char * const argv[])
+{
+	cmd_tbl_t *c;
+
+	if (argc < 2)
+		return CMD_RET_USAGE;
+
+	/* Strip off leading 'malloc' command argument */
+	argc--;
+	argv++;
+
+	c = find_cmd_tbl(argv[0], cmd_malloc_sub, ARRAY_SIZE(cmd_malloc_sub));
+	if (c)
+		return c->cmd(cmdtp, flag, argc, argv);
+	else
+		return CMD_RET_USAGE;
+}
+
+U_BOOT_CMD(malloc, 2, 1, do_malloc,
+	"malloc() heap information",
+	"stats - show the heap and the slab size classes"
+);
@@ -19,6 +19,8 @@
 #include <console.h>
 #include <hash.h>
 #include <inttypes.h>
+#include <malloc.h>
+#include <malloc_trace.h>
 #include <mapmem.h>
 #include <watchdog.h>
 #include <asm/io.h>
@@ -1181,8 +1183,20 @@ __weak void board_show_dram(phys_size_t size)
 static int do_mem_info(cmd_tbl_t *cmdtp, int flag, int argc,
 		       char * const argv[])
 {
+	struct malloc_frag frag;
+
 	board_show_dram(gd->ram_size);
 
+	/* how much of the free heap is out of reach of a large malloc() */
+	malloc_frag(&frag);
+	printf("heap:  %lu bytes free in %lu chunks, largest %lu, %lu%% fragmented\n",
+	       frag.free, frag.chunks, frag.largest,
+	       frag.free ? 100 - frag.largest / ((frag.free + 99) / 100) : 0);
+#if CONFIG_IS_ENABLED(MALLOC_TRACE)
+	putc('\n');
+	malloc_trace_show(argc > 1 ? simple_strtoul(argv[1], NULL, 10) : 10);
+#endif
+
 	return 0;
 }
 #endif
@@ -1248,8 +1262,10 @@ U_BOOT_CMD(
 
 #ifdef CONFIG_CMD_MEMINFO
 U_BOOT_CMD(
-	meminfo,	3,	1,	do_mem_info,
+	meminfo,	2,	1,	do_mem_info,
 	"display memory information",
-	""
+	"[count]\n"
+	"    - show DRAM size and heap fragmentation, with CONFIG_MALLOC_TRACE\n"
+	"      also the 'count' largest owners and call sites (default 10)"
 );
 #endif
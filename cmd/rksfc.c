@@ -32,6 +32,16 @@ static int do_rksfc(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 
 			return ret;
 		}
+		if (strncmp(argv[1], "stats", 5) == 0) {
+			rksfc_print_stats();
+			return CMD_RET_SUCCESS;
+		}
+		if (strncmp(argv[1], "info", 4) == 0) {
+			ret = blk_common_cmd(argc, argv, dev_type,
+					     &rksfc_curr_dev);
+			rksfc_print_stats();
+			return ret;
+		}
 	}
 
 	if (argc == 3) {
@@ -50,7 +60,8 @@ U_BOOT_CMD(
 	rksfc, 8, 1, do_rksfc,
 	"rockchip sfc sub-system",
 	"scan - scan Sfc devices\n"
-	"rksfc info - show all available Sfc devices\n"
+	"rksfc info - show all available Sfc devices and read counters\n"
+	"rksfc stats - show Sfc transfer and read counters\n"
 	"rksfc device [dev] - show or set current Sfc device\n"
 	"      dev 0 - spinand\n"
 	"      dev 1 - spinor\n"
@@ -0,0 +1,175 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <malloc.h>
+#include <smp_job.h>
+#include <u-boot/crc.h>
+#include <u-boot/sha256.h>
+
+/* Independent buffers the work is split into */
+#define SMPJOB_BUFS		64
+#define SMPJOB_DEFAULT_SIZE	(16 << 20)
+
+struct smpjob_sums {
+	u32 crc[SMPJOB_BUFS];
+	u8 sha[SMPJOB_BUFS][SHA256_SUM_LEN];
+};
+
+/**
+ * struct smpjob_bench - buffers for the jobs
+ *
+ * @src:	Source data, SMPJOB_BUFS buffers of @len bytes
+ * @dst:	Where to set or copy to, as large
+ * @len:	Size of one buffer
+ * @sums:	CRC32 and SHA256 of each source buffer
+ */
+struct smpjob_bench {
+	u8 *src;
+	u8 *dst;
+	ulong len;
+	struct smpjob_sums *sums;
+};
+
+static void smpjob_memset(void *arg, ulong start, ulong end)
+{
+	struct smpjob_bench *b = arg;
+
+	memset(b->dst + start * b->len, 0xa5, (end - start) * b->len);
+}
+
+static void smpjob_memcpy(void *arg, ulong start, ulong end)
+{
+	struct smpjob_bench *b = arg;
+
+	memcpy(b->dst + start * b->len, b->src + start * b->len,
+	       (end - start) * b->len);
+}
+
+static void smpjob_crc32(void *arg, ulong start, ulong end)
+{
+	struct smpjob_bench *b = arg;
+	ulong i;
+
+	for (i = start; i < end; i++)
+		b->sums->crc[i] = crc32(0, b->src + i * b->len, b->len);
+}
+
+static void smpjob_sha256(void *arg, ulong start, ulong end)
+{
+	struct smpjob_bench *b = arg;
+	sha256_context ctx;
+	ulong i;
+
+	for (i = start; i < end; i++) {
+		sha256_starts(&ctx);
+		sha256_update(&ctx, b->src + i * b->len, b->len);
+		sha256_finish(&ctx, b->sums->sha[i]);
+	}
+}
+
+/* Check that smpjob_memset() filled all of @buf */
+static bool smpjob_filled(const u8 *buf, ulong size)
+{
+	ulong i;
+
+	for (i = 0; i < size; i++) {
+		if (buf[i] != 0xa5)
+			return false;
+	}
+
+	return true;
+}
+
+static const struct {
+	const char *name;
+	smp_job_range_func func;
+} smpjob_tests[] = {
+	{ "memset", smpjob_memset },
+	{ "memcpy", smpjob_memcpy },
+	{ "crc32", smpjob_crc32 },
+	{ "sha256", smpjob_sha256 },
+};
+
+static int do_smpjob(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	struct smpjob_sums one, all;
+	struct smpjob_bench b;
+	ulong size = SMPJOB_DEFAULT_SIZE;
+	ulong start, t_one, t_all;
+	int ret = CMD_RET_SUCCESS;
+	bool mismatch = false;
+	uint i, cpus;
+
+	if (argc > 2)
+		return CMD_RET_USAGE;
+	if (argc == 2)
+		size = simple_strtoul(argv[1], NULL, 16);
+	b.len = size / SMPJOB_BUFS;
+	if (!b.len)
+		return CMD_RET_USAGE;
+	size = b.len * SMPJOB_BUFS;
+
+	b.src = malloc(size);
+	b.dst = malloc(size);
+	if (!b.src || !b.dst) {
+		printf("Cannot allocate 2 x %lu bytes\n", size);
+		ret = CMD_RET_FAILURE;
+		goto out;
+	}
+	for (i = 0; i < size / sizeof(u32); i++)
+		((u32 *)b.src)[i] = i * 0x9e3779b1;
+	memset(&one, '\0', sizeof(one));
+	memset(&all, '\0', sizeof(all));
+
+	/* start the CPUs before timing anything */
+	cpus = smp_job_cpus();
+	printf("%u CPUs, %u buffers of %lu bytes\n", cpus, SMPJOB_BUFS, b.len);
+	printf("          one CPU     all CPUs  speedup\n");
+	for (i = 0; i < ARRAY_SIZE(smpjob_tests); i++) {
+		b.sums = &one;
+		start = timer_get_us();
+		smpjob_tests[i].func(&b, 0, SMPJOB_BUFS);
+		t_one = max(timer_get_us() - start, 1UL);
+
+		/* what they leave in dst must be the work of all CPUs */
+		if (smpjob_tests[i].func == smpjob_memset ||
+		    smpjob_tests[i].func == smpjob_memcpy)
+			memset(b.dst, '\0', size);
+		b.sums = &all;
+		start = timer_get_us();
+		smp_job_for(SMPJOB_BUFS, 1, smpjob_tests[i].func, &b);
+		t_all = max(timer_get_us() - start, 1UL);
+		if (smpjob_tests[i].func == smpjob_memset &&
+		    !smpjob_filled(b.dst, size))
+			mismatch = true;
+
+		printf("%-8s %8lu us  %8lu us  %3lu.%02lux\n",
+		       smpjob_tests[i].name, t_one, t_all, t_one / t_all,
+		       t_one * 100 / t_all % 100);
+	}
+
+	if (mismatch || memcmp(b.src, b.dst, size) ||
+	    memcmp(&one, &all, sizeof(one))) {
+		printf("Results on all CPUs mismatch\n");
+		ret = CMD_RET_FAILURE;
+	}
+	smp_job_stop();
+out:
+	free(b.dst);
+	free(b.src);
+
+	return ret;
+}
+
+U_BOOT_CMD(
+	smpjob,	2,	0,	do_smpjob,
+	"time work on one CPU and on all CPUs",
+	"[size]\n"
+	"    - memset, memcpy, CRC32 and SHA256 of 'size' bytes (hex, default\n"
+	"      16MB) in independent buffers, on the boot CPU then on all CPUs"
+);
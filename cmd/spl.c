@@ -98,6 +98,9 @@ static int call_bootm(int argc, char * const argv[], const char *subcommand[])
 static cmd_tbl_t cmd_spl_export_sub[] = {
 	U_BOOT_CMD_MKENT(fdt, 0, 1, (void *)SPL_EXPORT_FDT, "", ""),
 	U_BOOT_CMD_MKENT(atags, 0, 1, (void *)SPL_EXPORT_ATAGS, "", ""),
+#ifdef CONFIG_SPL_ROCKCHIP_FALCON
+	U_BOOT_CMD_MKENT(falcon, 0, 1, (void *)SPL_EXPORT_FALCON, "", ""),
+#endif
 };
 
 static int spl_export(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
@@ -112,6 +115,16 @@ static int spl_export(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 	if ((c) && ((long)c->cmd <= SPL_EXPORT_LAST)) {
 		argc -= 2;
 		argv += 2;
+#ifdef CONFIG_SPL_ROCKCHIP_FALCON
+		/* prepared through booti, the result goes to the MMC device */
+		if ((long)c->cmd == SPL_EXPORT_FALCON) {
+			int ret = spl_export_falcon(argc, argv);
+
+			if (ret == CMD_RET_USAGE)
+				return cmd_usage(cmdtp);
+			return ret;
+		}
+#endif
 		if (call_bootm(argc, argv, subcmd_list[(long)c->cmd]))
 			return -1;
 		switch ((long)c->cmd) {
@@ -175,7 +188,7 @@ static int do_spl(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 }
 
 U_BOOT_CMD(
-	spl, 6 , 1, do_spl, "SPL configuration",
+	spl, 7 , 1, do_spl, "SPL configuration",
 	"export <img=atags|fdt> [kernel_addr] [initrd_addr] [fdt_addr]\n"
 	"\timg\t\t\"atags\" or \"fdt\"\n"
 	"\tkernel_addr\taddress where a kernel image is stored.\n"
@@ -183,4 +196,11 @@ U_BOOT_CMD(
 	"\tinitrd_addr\taddress of initial ramdisk\n"
 	"\t\t\tcan be set to \"-\" if fdt_addr without initrd_addr is used.\n"
 	"\tfdt_addr\tin case of fdt, the address of the device tree.\n"
+#ifdef CONFIG_SPL_ROCKCHIP_FALCON
+	"spl export falcon <kernel_addr> <fdt_addr> <part> <kernel> <fdt>\n"
+	"\tload Image <kernel> and <fdt> from FAT partition <part> and\n"
+	"\tprepare them as booti would, for SPL to boot them directly\n"
+	"spl export falcon off\n"
+	"\tlet SPL boot U-Boot again\n"
+#endif
 	);
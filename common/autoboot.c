@@ -245,6 +245,7 @@ static int __abortboot(int bootdelay)
 # endif
 				break;
 			}
+			board_idle_poll();
 			udelay(10000);
 		} while (!abort && get_timer(ts) < 1000);
 
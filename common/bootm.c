@@ -9,12 +9,14 @@
 #include <common.h>
 #include <bootstage.h>
 #include <bzlib.h>
+#include <chunked_decomp.h>
 #include <errno.h>
 #include <fdt_support.h>
 #include <lmb.h>
 #include <malloc.h>
 #include <mapmem.h>
 #include <asm/io.h>
+#include <asm/unaligned.h>
 #include <linux/lzo.h>
 #include <lzma/LzmaTypes.h>
 #include <lzma/LzmaDec.h>
@@ -372,15 +374,122 @@ int bootm_parse_comp(const unsigned char *hdr)
 	return IH_COMP_NONE;
 }
 
+#ifndef USE_HOSTCC
+static bool bootm_overlaps(ulong start, ulong size, ulong base, ulong len)
+{
+	return start < base + len && base < start + size;
+}
+#endif
+
+/*
+ * Get the decompressed size of the @image_len bytes at @image_buf, 0 if the
+ * format does not tell
+ */
+static ulong bootm_decomp_size(int comp, const void *image_buf,
+			       ulong image_len)
+{
+	switch (comp) {
+#ifdef CONFIG_GZIP
+	case IH_COMP_GZIP:
+		/* ISIZE, the size modulo 4 GiB, ends a gzip member */
+		if (image_len < 18)
+			return 0;
+		return get_unaligned_le32(image_buf + image_len - 4);
+#endif
+#ifdef CONFIG_LZ4
+	case IH_COMP_LZ4:
+		return lz4_get_content_size(image_buf, image_len);
+#endif
+	default:
+		return 0;
+	}
+}
+
+/*
+ * Bytes by which compressed data must end past the end of its decompressed
+ * data for decompression in place never to overwrite input not read yet
+ */
+static ulong bootm_decomp_margin(int comp, ulong image_len, ulong size)
+{
+	switch (comp) {
+	case IH_COMP_GZIP:
+		/* as Linux uses to decompress itself in place */
+		return (size >> 8) + 65536;
+	case IH_COMP_LZ4:
+		/* LZ4_DECOMPRESS_INPLACE_MARGIN(), and LZ4_wildCopy() overrun */
+		return (image_len >> 8) + 32 + 8;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * bootm_decomp_in_place() - check decompressing over the compressed image
+ *
+ * An image at the end of the window it decompresses to can decompress in
+ * place: going forward, the output stays behind the input still to be read
+ * as long as the input ends far enough past the end of the output. Then
+ * loading a kernel takes little more memory than the kernel itself.
+ *
+ * @comp:	Compression type being used (IH_COMP_...)
+ * @load:	Address to decompress to
+ * @image_start: Address of the compressed image
+ * @image_buf:	Compressed image
+ * @image_len:	Size of the compressed image
+ * @sizep:	Returns the decompressed size, when in place
+ * @return 1 if the image decompresses in place, 0 if the decompressed data
+ *	does not reach the image or its size is not known, -ENOSPC if they
+ *	overlap such that the image would be overwritten before it is read
+ */
+static int bootm_decomp_in_place(int comp, ulong load, ulong image_start,
+				 const void *image_buf, ulong image_len,
+				 ulong *sizep)
+{
+	ulong size, margin;
+
+	if (comp == IH_COMP_NONE)
+		return 0;
+#ifdef CONFIG_CHUNKED_DECOMP
+	/* chunks decompress in any order, so never over the image */
+	size = chunked_get_size(comp, image_buf, image_len);
+	if (size)
+		return bootm_overlaps(load, size, image_start, image_len) ?
+			-ENOSPC : 0;
+#endif
+	size = bootm_decomp_size(comp, image_buf, image_len);
+	if (!size || load + size <= image_start ||
+	    load >= image_start + image_len)
+		return 0;
+
+	margin = bootm_decomp_margin(comp, image_len, size);
+	if (load > image_start || image_start + image_len < load + size + margin)
+		return -ENOSPC;
+	*sizep = size;
+
+	return 1;
+}
+
 int bootm_decomp_image(int comp, ulong load, ulong image_start, int type,
 		       void *load_buf, void *image_buf, ulong image_len,
 		       uint unc_len, ulong *load_end)
 {
-	int ret = 0;
+	ulong size;
+	int ret;
 
 	*load_end = load;
 	print_decomp_msg(comp, type, load == image_start);
 
+	ret = bootm_decomp_in_place(comp, load, image_start, image_buf,
+				    image_len, &size);
+	if (ret < 0) {
+		printf("Image at %08lx overlaps where it decompresses to\n",
+		       image_start);
+		return ret;
+	}
+	if (ret && size < unc_len)
+		unc_len = size;
+	ret = 0;
+
 	/*
 	 * Load the image to the right place, decompressing if needed. After
 	 * this, image_len will be set to the number of uncompressed bytes
@@ -397,6 +506,12 @@ int bootm_decomp_image(int comp, ulong load, ulong image_start, int type,
 		break;
 #ifdef CONFIG_GZIP
 	case IH_COMP_GZIP: {
+#ifdef CONFIG_CHUNKED_DECOMP
+		ret = chunked_decomp(comp, load_buf, unc_len, image_buf,
+				     &image_len);
+		if (ret != -ENOENT)
+			break;
+#endif
 		ret = gunzip(load_buf, unc_len, image_buf, &image_len);
 		break;
 	}
@@ -440,6 +555,12 @@ int bootm_decomp_image(int comp, ulong load, ulong image_start, int type,
 	case IH_COMP_LZ4: {
 		size_t size = unc_len;
 
+#ifdef CONFIG_CHUNKED_DECOMP
+		ret = chunked_decomp(comp, load_buf, unc_len, image_buf,
+				     &image_len);
+		if (ret != -ENOENT)
+			break;
+#endif
 		ret = ulz4fn(image_buf, image_len, load_buf, &size);
 		image_len = size;
 		break;
@@ -469,12 +590,31 @@ static int bootm_load_os(bootm_headers_t *images, unsigned long *load_end,
 	ulong blob_end = os.end;
 	ulong image_start = os.image_start;
 	ulong image_len = os.image_len;
-	bool no_overlap;
+	bool no_overlap, in_place;
 	void *load_buf, *image_buf;
+	ulong size;
 	int err;
 
 	load_buf = map_sysmem(load, 0);
 	image_buf = map_sysmem(os.image_start, image_len);
+
+	/*
+	 * In place, the headers before the image are overwritten, which is
+	 * fine as long as the FDT and ramdisk found in the blob are not
+	 */
+	in_place = bootm_decomp_in_place(os.comp, load, image_start, image_buf,
+					 image_len, &size) == 1;
+	if (in_place && (bootm_overlaps(load, size, images->rd_start,
+					images->rd_end - images->rd_start) ||
+			 (images->ft_addr &&
+			  bootm_overlaps(load, size,
+					 map_to_sysmem(images->ft_addr),
+					 images->ft_len)))) {
+		puts("ERROR: kernel would overwrite the ramdisk or FDT\n");
+		bootstage_error(BOOTSTAGE_ID_DECOMP_IMAGE);
+		return -ENOSPC;
+	}
+
 	err = bootm_decomp_image(os.comp, load, os.image_start, os.type,
 				 load_buf, image_buf, image_len,
 				 CONFIG_SYS_BOOTM_LEN, load_end);
@@ -487,7 +627,8 @@ static int bootm_load_os(bootm_headers_t *images, unsigned long *load_end,
 	debug("   kernel loaded at 0x%08lx, end = 0x%08lx\n", load, *load_end);
 	bootstage_mark(BOOTSTAGE_ID_KERNEL_LOADED);
 
-	no_overlap = (os.comp == IH_COMP_NONE && load == image_start);
+	no_overlap = (os.comp == IH_COMP_NONE && load == image_start) ||
+		     in_place;
 
 	if (!no_overlap && (load < blob_end) && (*load_end > blob_start)) {
 		debug("images.os.start = 0x%lX, images.os.end = 0x%lx\n",
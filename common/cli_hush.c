@@ -84,6 +84,7 @@
 #include <cli.h>
 #include <cli_hush.h>
 #include <command.h>        /* find_cmd */
+#include <u-boot/crc.h>
 #ifndef CONFIG_SYS_PROMPT_HUSH_PS2
 #define CONFIG_SYS_PROMPT_HUSH_PS2	"> "
 #endif
@@ -338,6 +339,9 @@ struct in_str {
 #endif
 	int (*get) (struct in_str *);
 	int (*peek) (struct in_str *);
+#ifdef CONFIG_HUSH_CACHE
+	struct hush_code *code;		/* records the lists parsed */
+#endif
 };
 #define b_getch(input) ((input)->get(input))
 #define b_peek(input) ((input)->peek(input))
@@ -1163,6 +1167,9 @@ static void setup_file_in_str(struct in_str *i)
 	i->file = f;
 #endif
 	i->p = NULL;
+#ifdef CONFIG_HUSH_CACHE
+	i->code = NULL;
+#endif
 }
 
 static void setup_string_in_str(struct in_str *i, const char *s)
@@ -1172,6 +1179,9 @@ static void setup_string_in_str(struct in_str *i, const char *s)
 	i->__promptme=1;
 	i->promptmode=1;
 	i->p = s;
+#ifdef CONFIG_HUSH_CACHE
+	i->code = NULL;
+#endif
 }
 
 #ifndef __U_BOOT__
@@ -3180,6 +3190,367 @@ static void update_ifs_map(void)
 	mapset(ifs, 2);            /* also flow through if quoted */
 }
 
+#ifdef CONFIG_HUSH_CACHE
+/*
+ * Scripts run from strings (environment variables, boot.scr) are parsed only
+ * once. While a script runs for the first time, every list handed to
+ * run_list() is also written out as byte code. The next run of the same text
+ * with the same flags rebuilds the lists from the byte code instead of
+ * parsing the text again:
+ *
+ *   script := (HC_LIST more next[4] pipes)*
+ *   pipes  := (HC_PIPE followup r_mode num_progs[2] has_progs prog*)* HC_END
+ *   prog   := HC_NULL type sp[2]
+ *           | HC_ARGV type sp[2] argc[2] (nonnull len[2] text)*
+ *           | HC_GROUP type sp[2] pipes
+ *
+ * @more tells if the parser went on after the list and @next is the offset
+ * in the text where it did. Variables are only expanded when a command runs,
+ * so the lists only depend on the text, the flags and $IFS. Nothing is
+ * recorded while IFS is set, and if it gets set by a cached script the rest
+ * of the text is parsed as usual.
+ */
+enum {
+	HC_LIST = 1,
+	HC_PIPE,
+	HC_END,
+	HC_NULL,
+	HC_ARGV,
+	HC_GROUP,
+};
+
+struct hush_code {
+	uchar *buf;
+	uint len;
+	uint size;
+	const char *text;		/* text being recorded */
+	int err;			/* not cacheable */
+};
+
+struct hush_cache_entry {
+	char *text;			/* NULL if the slot is free */
+	uint text_len;
+	u32 hash;
+	int flag;
+	int busy;			/* runs in progress, keep the entry */
+	ulong used;			/* last use, for LRU */
+	struct hush_code code;
+};
+
+static struct hush_cache_entry hush_cache[CONFIG_HUSH_CACHE_ENTRIES];
+static ulong hush_cache_tick;
+static ulong hush_cache_hits;
+static ulong hush_cache_misses;
+
+static int hush_ifs_default(void)
+{
+	return env_get("IFS") == NULL;
+}
+
+static void hush_code_put(struct hush_code *code, const void *data, uint len)
+{
+	uchar *buf;
+	uint size;
+
+	if (code->err)
+		return;
+	if (code->len + len > code->size) {
+		size = max(code->size * 2, code->len + len + 64);
+		buf = realloc(code->buf, size);
+		if (!buf) {
+			code->err = 1;
+			return;
+		}
+		code->buf = buf;
+		code->size = size;
+	}
+	memcpy(code->buf + code->len, data, len);
+	code->len += len;
+}
+
+/* Numbers are stored little endian in @bytes bytes */
+static void hush_code_num(struct hush_code *code, uint val, int bytes)
+{
+	uchar b[4];
+	int i;
+
+	if (bytes < 4 && val >> (8 * bytes))
+		code->err = 1;
+	for (i = 0; i < bytes; i++)
+		b[i] = val >> (8 * i);
+	hush_code_put(code, b, bytes);
+}
+
+static uint hush_code_get(const uchar **pc, int bytes)
+{
+	uint val = 0;
+	int i;
+
+	for (i = 0; i < bytes; i++)
+		val |= (*pc)[i] << (8 * i);
+	*pc += bytes;
+
+	return val;
+}
+
+static void hush_code_pipes(struct hush_code *code, struct pipe *pi)
+{
+	struct child_prog *child;
+	uint len;
+	int i, a;
+
+	for (; pi; pi = pi->next) {
+		hush_code_num(code, HC_PIPE, 1);
+		hush_code_num(code, pi->followup, 1);
+		hush_code_num(code, pi->r_mode, 1);
+		hush_code_num(code, pi->num_progs, 2);
+		hush_code_num(code, pi->progs != NULL, 1);
+		/* progs[num_progs] is the empty child the parser left behind */
+		for (i = 0; pi->progs && i <= pi->num_progs; i++) {
+			child = &pi->progs[i];
+			if (child->argv)
+				hush_code_num(code, HC_ARGV, 1);
+			else if (child->group)
+				hush_code_num(code, HC_GROUP, 1);
+			else
+				hush_code_num(code, HC_NULL, 1);
+			hush_code_num(code, child->type, 1);
+			hush_code_num(code, child->sp, 2);
+			if (child->argv) {
+				hush_code_num(code, child->argc, 2);
+				for (a = 0; a < child->argc; a++) {
+					len = strlen(child->argv[a]);
+					hush_code_num(code, child->argv_nonnull[a], 1);
+					hush_code_num(code, len, 2);
+					hush_code_put(code, child->argv[a], len);
+				}
+			} else if (child->group) {
+				hush_code_pipes(code, child->group);
+			}
+		}
+	}
+	hush_code_num(code, HC_END, 1);
+}
+
+static void hush_code_list(struct hush_code *code, struct pipe *head,
+			   int more, const char *next)
+{
+	hush_code_num(code, HC_LIST, 1);
+	hush_code_num(code, more, 1);
+	hush_code_num(code, more ? next - code->text : 0, 4);
+	hush_code_pipes(code, head);
+}
+
+/* Build the pipes the parser built, allocated the same way */
+static struct pipe *hush_code_load(const uchar **pc)
+{
+	struct pipe *head = NULL, **link = &head, *pi;
+	struct child_prog *child;
+	int i, a, kind, len;
+
+	while (hush_code_get(pc, 1) == HC_PIPE) {
+		pi = new_pipe();
+		pi->followup = hush_code_get(pc, 1);
+		pi->r_mode = hush_code_get(pc, 1);
+		pi->num_progs = hush_code_get(pc, 2);
+		if (hush_code_get(pc, 1))
+			pi->progs = xmalloc(sizeof(*pi->progs) *
+					    (pi->num_progs + 1));
+		for (i = 0; pi->progs && i <= pi->num_progs; i++) {
+			child = &pi->progs[i];
+			kind = hush_code_get(pc, 1);
+			child->type = hush_code_get(pc, 1);
+			child->sp = hush_code_get(pc, 2);
+			child->argv = NULL;
+			child->argv_nonnull = NULL;
+			child->argc = 0;
+			child->group = NULL;
+			if (kind == HC_ARGV) {
+				child->argc = hush_code_get(pc, 2);
+				child->argv = xmalloc(sizeof(*child->argv) *
+						      (child->argc + 1));
+				child->argv_nonnull = xmalloc(
+					sizeof(*child->argv_nonnull) *
+					(child->argc + 1));
+				for (a = 0; a < child->argc; a++) {
+					child->argv_nonnull[a] =
+						hush_code_get(pc, 1);
+					len = hush_code_get(pc, 2);
+					child->argv[a] = xmalloc(len + 1);
+					memcpy(child->argv[a], *pc, len);
+					child->argv[a][len] = '\0';
+					*pc += len;
+				}
+				child->argv[a] = NULL;
+				child->argv_nonnull[a] = 0;
+			} else if (kind == HC_GROUP) {
+				child->group = hush_code_load(pc);
+			}
+		}
+		*link = pi;
+		link = &pi->next;
+	}
+
+	return head;
+}
+
+static void hush_cache_drop(struct hush_cache_entry *ent)
+{
+	free(ent->text);
+	free(ent->code.buf);
+	memset(ent, '\0', sizeof(*ent));
+}
+
+static struct hush_cache_entry *hush_cache_find(const char *text, uint len,
+						u32 hash, int flag)
+{
+	struct hush_cache_entry *ent;
+
+	for (ent = hush_cache; ent < hush_cache + ARRAY_SIZE(hush_cache);
+	     ent++) {
+		if (ent->text && ent->hash == hash && ent->flag == flag &&
+		    ent->text_len == len && !memcmp(ent->text, text, len))
+			return ent;
+	}
+
+	return NULL;
+}
+
+/* Keep @code for @text, in a free slot or the least recently used one */
+static void hush_cache_add(const char *text, uint len, u32 hash, int flag,
+			   struct hush_code *code)
+{
+	struct hush_cache_entry *ent = NULL, *e;
+	char *copy;
+
+	for (e = hush_cache; e < hush_cache + ARRAY_SIZE(hush_cache); e++) {
+		if (e->busy)
+			continue;
+		if (!e->text) {
+			ent = e;
+			break;
+		}
+		if (!ent || e->used < ent->used)
+			ent = e;
+	}
+	copy = ent ? malloc(len + 1) : NULL;
+	if (!copy) {
+		free(code->buf);
+		return;
+	}
+	memcpy(copy, text, len + 1);
+
+	hush_cache_drop(ent);
+	ent->text = copy;
+	ent->text_len = len;
+	ent->hash = hash;
+	ent->flag = flag;
+	ent->used = ++hush_cache_tick;
+	ent->code = *code;
+	ent->code.text = NULL;
+}
+
+/* Same as parse_stream_outer() on the text of @ent, without the parser */
+static int hush_cache_run(struct hush_cache_entry *ent, struct in_str *inp,
+			  int flag)
+{
+	const uchar *pc = ent->code.buf;
+	const uchar *end = pc + ent->code.len;
+	const char *text = inp->p;
+	int more = 1, code = 1;
+	uint next = 0;
+
+	ent->busy++;
+	ent->used = ++hush_cache_tick;
+	while (more) {
+		/* the first run stopped at "exit", or IFS changes the words */
+		if (pc == end || !hush_ifs_default()) {
+			inp->p = text + next;
+			code = parse_stream_outer(inp, flag);
+			ent->busy--;
+			return code;
+		}
+		pc++;		/* HC_LIST */
+		more = hush_code_get(&pc, 1);
+		next = hush_code_get(&pc, 4);
+		code = run_list(hush_code_load(&pc));
+		if (code == -2) {	/* exit */
+			code = 0;
+			break;
+		}
+		if (code == -1)
+			flag_repeat = 0;
+	}
+	ent->busy--;
+
+	return (code != 0) ? 1 : 0;
+}
+
+/* Run the text set up in @inp, from the cache if it ran before */
+static int parse_string_cached(struct in_str *inp, int flag)
+{
+	struct hush_cache_entry *ent;
+	struct hush_code code;
+	const char *text = inp->p;
+	uint len = strlen(text);
+	u32 hash;
+	int rcode;
+
+	/* expanded commands differ with every value, they would evict all */
+	if (flag & FLAG_REPARSING)
+		return parse_stream_outer(inp, flag);
+
+	hash = crc32(flag, (const uchar *)text, len);
+	ent = hush_cache_find(text, len, hash, flag);
+	if (ent) {
+		hush_cache_hits++;
+		return hush_cache_run(ent, inp, flag);
+	}
+	hush_cache_misses++;
+
+	memset(&code, '\0', sizeof(code));
+	code.text = text;
+	inp->code = &code;
+	rcode = parse_stream_outer(inp, flag);
+	inp->code = NULL;
+	if (!code.err && code.len)
+		hush_cache_add(text, len, hash, flag, &code);
+	else
+		free(code.buf);
+
+	return rcode;
+}
+
+void hush_cache_get_stats(struct hush_cache_stats *stats)
+{
+	struct hush_cache_entry *ent;
+
+	memset(stats, '\0', sizeof(*stats));
+	stats->hits = hush_cache_hits;
+	stats->misses = hush_cache_misses;
+	for (ent = hush_cache; ent < hush_cache + ARRAY_SIZE(hush_cache);
+	     ent++) {
+		if (!ent->text)
+			continue;
+		stats->entries++;
+		stats->bytes += ent->text_len + 1 + ent->code.len;
+	}
+}
+
+void hush_cache_flush(void)
+{
+	struct hush_cache_entry *ent;
+
+	for (ent = hush_cache; ent < hush_cache + ARRAY_SIZE(hush_cache);
+	     ent++) {
+		if (!ent->busy)
+			hush_cache_drop(ent);
+	}
+}
+#else
+#define parse_string_cached parse_stream_outer
+#endif /* CONFIG_HUSH_CACHE */
+
 /* most recursion does not come through here, the exeception is
  * from builtin_source() */
 static int parse_stream_outer(struct in_str *inp, int flag)
@@ -3208,12 +3579,24 @@ static int parse_stream_outer(struct in_str *inp, int flag)
 			flag_repeat = 0;
 #endif
 		}
+#ifdef CONFIG_HUSH_CACHE
+		if (inp->code && (rcode == 1 || ctx.old_flag != 0 ||
+				  !hush_ifs_default()))
+			inp->code->err = 1;
+#endif
 		if (rcode != 1 && ctx.old_flag == 0) {
 			done_word(&temp, &ctx);
 			done_pipe(&ctx,PIPE_SEQ);
 #ifndef __U_BOOT__
 			run_list(ctx.list_head);
 #else
+#ifdef CONFIG_HUSH_CACHE
+			if (inp->code)
+				hush_code_list(inp->code, ctx.list_head,
+					       rcode != -1 &&
+					       !(flag & FLAG_EXIT_FROM_LOOP) &&
+					       b_peek(inp), inp->p);
+#endif
 			code = run_list(ctx.list_head);
 			if (code == -2) {	/* exit */
 				b_free(&temp);
@@ -3272,13 +3655,13 @@ int parse_string_outer(const char *s, int flag)
 		strcpy(p, s);
 		strcat(p, "\n");
 		setup_string_in_str(&input, p);
-		rcode = parse_stream_outer(&input, flag);
+		rcode = parse_string_cached(&input, flag);
 		free(p);
 		return rcode;
 	} else {
 #endif
 	setup_string_in_str(&input, s);
-	return parse_stream_outer(&input, flag);
+	return parse_string_cached(&input, flag);
 #ifdef __U_BOOT__
 	}
 #endif
@@ -12,8 +12,12 @@
 #include <common.h>
 #include <command.h>
 #include <console.h>
+#include <malloc.h>
+#include <malloc_trace.h>
 #include <linux/ctype.h>
 
+DECLARE_GLOBAL_DATA_PTR;
+
 /*
  * Use puts() instead of printf() to avoid printf buffer overflow
  * for long help messages
@@ -82,12 +86,84 @@ int _do_help(cmd_tbl_t *cmd_start, int cmd_items, cmd_tbl_t *cmdtp, int flag,
 	return rcode;
 }
 
+#ifdef CONFIG_CMDLINE
+/*
+ * The linker sorts the command list by symbol (SORT(.u_boot_list*) in the
+ * linker scripts). That is the command name for nearly all commands, but
+ * not for all of them: "?" is question_mark. So the first lookup after
+ * relocation builds an index of the list sorted by name. It is mostly in
+ * order already, so an insertion sort is quick.
+ *
+ * @return the index, NULL if there is none and the list must be searched
+ * entry by entry
+ */
+static cmd_tbl_t **cmd_index(void)
+{
+	static cmd_tbl_t **sorted;
+	cmd_tbl_t *start = ll_entry_start(cmd_tbl_t, cmd);
+	const int count = ll_entry_count(cmd_tbl_t, cmd);
+	cmd_tbl_t *cmdtp;
+	int i, j;
+
+	/* static data cannot be written before relocation */
+	if (sorted || !(gd->flags & GD_FLG_RELOC))
+		return sorted;
+
+	sorted = malloc(count * sizeof(*sorted));
+	if (!sorted)
+		return NULL;
+
+	for (i = 0, cmdtp = start; cmdtp != start + count; i++, cmdtp++) {
+		for (j = i; j && strcmp(sorted[j - 1]->name, cmdtp->name) > 0;
+		     j--)
+			sorted[j] = sorted[j - 1];
+		sorted[j] = cmdtp;
+	}
+
+	return sorted;
+}
+
+/*
+ * All commands starting with the first @len characters of @cmd are next to
+ * each other in the index. Find them with two binary searches.
+ *
+ * @return first matching command in @sorted, *@countp is the number of
+ * matches
+ */
+static cmd_tbl_t **find_cmd_range(const char *cmd, int len, cmd_tbl_t **sorted,
+				  int count, int *countp)
+{
+	cmd_tbl_t **lo = sorted, **hi = sorted + count, **mid, **start;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (strncmp((*mid)->name, cmd, len) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	start = lo;
+	hi = sorted + count;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (strncmp((*mid)->name, cmd, len) <= 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	*countp = lo - start;
+
+	return start;
+}
+#endif
+
 /* find command table entry for a command */
 cmd_tbl_t *find_cmd_tbl(const char *cmd, cmd_tbl_t *table, int table_len)
 {
 #ifdef CONFIG_CMDLINE
 	cmd_tbl_t *cmdtp;
 	cmd_tbl_t *cmdtp_temp = table;	/* Init value */
+	cmd_tbl_t **sorted;
 	const char *p;
 	int len;
 	int n_found = 0;
@@ -100,6 +176,20 @@ cmd_tbl_t *find_cmd_tbl(const char *cmd, cmd_tbl_t *table, int table_len)
 	 */
 	len = ((p = strchr(cmd, '.')) == NULL) ? strlen (cmd) : (p - cmd);
 
+	/*
+	 * A full match sorts before the longer names it is a prefix of.
+	 * Sub-command tables are not sorted, they are searched one by one.
+	 */
+	if (table == ll_entry_start(cmd_tbl_t, cmd) &&
+	    (sorted = cmd_index())) {
+		sorted = find_cmd_range(cmd, len, sorted, table_len, &n_found);
+		if (n_found == 1 ||
+		    (n_found && len == strlen((*sorted)->name)))
+			return *sorted;
+
+		return NULL;
+	}
+
 	for (cmdtp = table; cmdtp != table + table_len; cmdtp++) {
 		if (strncmp(cmd, cmdtp->name, len) == 0) {
 			if (len == strlen(cmdtp->name))
@@ -168,8 +258,10 @@ static int complete_cmdv(int argc, char * const argv[], char last_char, int maxv
 	cmd_tbl_t *cmdtp = ll_entry_start(cmd_tbl_t, cmd);
 	const int count = ll_entry_count(cmd_tbl_t, cmd);
 	const cmd_tbl_t *cmdend = cmdtp + count;
+	cmd_tbl_t **sorted;
 	const char *p;
-	int len, clen;
+	char *name;
+	int i, len, n_match;
 	int n_found = 0;
 	const char *cmd;
 
@@ -214,13 +306,12 @@ static int complete_cmdv(int argc, char * const argv[], char last_char, int maxv
 		len = p - cmd;
 
 	/* return the partial matches */
-	for (; cmdtp != cmdend; cmdtp++) {
-
-		clen = strlen(cmdtp->name);
-		if (clen < len)
-			continue;
-
-		if (memcmp(cmd, cmdtp->name, len) != 0)
+	sorted = cmd_index();
+	if (sorted)
+		sorted = find_cmd_range(cmd, len, sorted, count, &n_match);
+	for (i = 0; sorted ? i < n_match : cmdtp != cmdend; i++, cmdtp++) {
+		name = sorted ? sorted[i]->name : cmdtp->name;
+		if (strncmp(cmd, name, len))
 			continue;
 
 		/* too many! */
@@ -229,7 +320,7 @@ static int complete_cmdv(int argc, char * const argv[], char last_char, int maxv
 			break;
 		}
 
-		cmdv[n_found++] = cmdtp->name;
+		cmdv[n_found++] = name;
 	}
 
 	cmdv[n_found] = NULL;
@@ -439,8 +530,6 @@ int cmd_get_data_size(char* arg, int default_size)
 #endif
 
 #if defined(CONFIG_NEEDS_MANUAL_RELOC)
-DECLARE_GLOBAL_DATA_PTR;
-
 void fixup_cmdtable(cmd_tbl_t *cmdtp, int size)
 {
 	int	i;
@@ -495,9 +584,12 @@ void fixup_cmdtable(cmd_tbl_t *cmdtp, int size)
  */
 static int cmd_call(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
+	const char *owner;
 	int result;
 
+	owner = malloc_trace_owner(cmdtp->name);
 	result = (cmdtp->cmd)(cmdtp, flag, argc, argv);
+	malloc_trace_owner(owner);
 	if (result)
 		debug("Command failed, result=%d\n", result);
 	return result;
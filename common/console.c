@@ -327,6 +327,15 @@ int serial_printf(const char *fmt, ...)
 	return i;
 }
 
+/*
+ * Called while waiting for console input, for the board to carry on slow
+ * work such as powering up a panel. As it only runs from input loops it may
+ * use any driver.
+ */
+__weak void board_idle_poll(void)
+{
+}
+
 int fgetc(int file)
 {
 	if (file < MAX_FILES) {
@@ -336,6 +345,7 @@ int fgetc(int file)
 		 */
 		for (;;) {
 			WATCHDOG_RESET();
+			board_idle_poll();
 			/*
 			 * Upper layer may have already called tstc() so
 			 * check for that first.
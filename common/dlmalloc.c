@@ -5,8 +5,39 @@
 #endif
 
 #include <malloc.h>
+#include <malloc_slab.h>
+#include <malloc_trace.h>
 #include <asm/io.h>
 
+#if CONFIG_IS_ENABLED(MALLOC_TRACE)
+/*
+ * The allocator is built with the dl prefix, the public functions at the
+ * end of this file pass each call on to the tracer.
+ */
+#undef cALLOc
+#undef fREe
+#undef mALLOc
+#undef mEMALIGn
+#undef rEALLOc
+#undef vALLOc
+#undef pvALLOc
+#define cALLOc		dlcalloc
+#define fREe		dlfree
+#define mALLOc		dlmalloc
+#define mEMALIGn	dlmemalign
+#define rEALLOc		dlrealloc
+#define vALLOc		dlvalloc
+#define pvALLOc		dlpvalloc
+
+Void_t *mALLOc(size_t);
+void fREe(Void_t *);
+Void_t *rEALLOc(Void_t *, size_t);
+Void_t *mEMALIGn(size_t, size_t);
+Void_t *vALLOc(size_t);
+Void_t *pvALLOc(size_t);
+Void_t *cALLOc(size_t, size_t);
+#endif
+
 #ifdef DEBUG
 #if __STD_C
 static void malloc_update_mallinfo (void);
@@ -598,8 +629,45 @@ void *sbrk(ptrdiff_t increment)
 	return (void *)old;
 }
 
+#if CONFIG_IS_ENABLED(SYS_MALLOC_SLAB)
+/*
+ * Small requests go to gd->malloc_slab: the slab initf_malloc() set up in
+ * the early malloc() area, then the one mem_malloc_init() set up at the end
+ * of the heap. Requests which must come from a chunk of the heap (because
+ * mem2chunk() is used on them) call malloc_heap() instead of mALLOc().
+ */
+static inline struct malloc_slab *malloc_slab(void)
+{
+	if ((gd->flags & GD_FLG_FULL_MALLOC_INIT) && !mem_malloc_start)
+		return NULL;
+
+	return gd->malloc_slab;
+}
+
+static Void_t *malloc_heap(size_t bytes);
+#else
+#define malloc_heap	mALLOc
+#endif
+
 void mem_malloc_init(ulong start, ulong size)
 {
+#if CONFIG_IS_ENABLED(MALLOC_TRACE)
+	if (size > malloc_trace_size()) {
+		size -= malloc_trace_size();
+		malloc_trace_init(start + size);
+	}
+#endif
+#if CONFIG_IS_ENABLED(SYS_MALLOC_SLAB)
+	if (size > CONFIG_SYS_MALLOC_SLAB_LEN) {
+		size -= CONFIG_SYS_MALLOC_SLAB_LEN;
+		gd->malloc_slab = malloc_slab_init(start + size,
+						   CONFIG_SYS_MALLOC_SLAB_LEN,
+						   12);
+	} else {
+		/* never go on with the slab in the early malloc() area */
+		gd->malloc_slab = NULL;
+	}
+#endif
 	mem_malloc_start = start;
 	mem_malloc_end = start + size;
 	mem_malloc_brk = start;
@@ -1234,9 +1302,9 @@ static void malloc_extend_top(nb) INTERNAL_SIZE_T nb;
 */
 
 #if __STD_C
-Void_t* mALLOc(size_t bytes)
+Void_t* malloc_heap(size_t bytes)
 #else
-Void_t* mALLOc(bytes) size_t bytes;
+Void_t* malloc_heap(bytes) size_t bytes;
 #endif
 {
   mchunkptr victim;                  /* inspected/selected chunk */
@@ -1480,6 +1548,22 @@ Void_t* mALLOc(bytes) size_t bytes;
 
 }
 
+#if CONFIG_IS_ENABLED(SYS_MALLOC_SLAB)
+Void_t* mALLOc(size_t bytes)
+{
+	struct malloc_slab *slab = malloc_slab();
+	Void_t *mem;
+
+	if (slab && bytes <= MALLOC_SLAB_MAX) {
+		mem = malloc_slab_alloc(slab, bytes);
+		if (mem)
+			return mem;
+	}
+
+	return malloc_heap(bytes);
+}
+#endif
+
 
 
 
@@ -1522,6 +1606,12 @@ void fREe(mem) Void_t* mem;
   mchunkptr fwd;       /* misc temp for linking */
   int       islr;      /* track whether merging with last_remainder */
 
+#if CONFIG_IS_ENABLED(SYS_MALLOC_SLAB)
+	if (malloc_slab_owns(malloc_slab(), mem)) {
+		malloc_slab_free(gd->malloc_slab, mem);
+		return;
+	}
+#endif
 #if CONFIG_VAL(SYS_MALLOC_F_LEN)
 	/* free() is a no-op - all the memory will be freed on relocation */
 	if (!(gd->flags & GD_FLG_FULL_MALLOC_INIT))
@@ -1682,6 +1772,19 @@ Void_t* rEALLOc(oldmem, bytes) Void_t* oldmem; size_t bytes;
   /* realloc of null is supposed to be same as malloc */
   if (oldmem == NULL) return mALLOc(bytes);
 
+#if CONFIG_IS_ENABLED(SYS_MALLOC_SLAB)
+	if (malloc_slab_owns(malloc_slab(), oldmem)) {
+		oldsize = malloc_slab_size(gd->malloc_slab, oldmem);
+		if (bytes <= oldsize)
+			return oldmem;
+		newmem = mALLOc(bytes);
+		if (newmem) {
+			MALLOC_COPY(newmem, oldmem, oldsize);
+			fREe(oldmem);
+		}
+		return newmem;
+	}
+#endif
 #if CONFIG_VAL(SYS_MALLOC_F_LEN)
 	if (!(gd->flags & GD_FLG_FULL_MALLOC_INIT)) {
 		/* This is harder to support and should not be needed */
@@ -1705,7 +1808,7 @@ Void_t* rEALLOc(oldmem, bytes) Void_t* oldmem; size_t bytes;
     /* Note the extra SIZE_SZ overhead. */
     if(oldsize - SIZE_SZ >= nb) return oldmem; /* do nothing */
     /* Must alloc, copy, free. */
-    newmem = mALLOc(bytes);
+    newmem = malloc_heap(bytes);
     if (!newmem)
 	return NULL; /* propagate failure */
     MALLOC_COPY(newmem, oldmem, oldsize - 2*SIZE_SZ);
@@ -1808,7 +1911,7 @@ Void_t* rEALLOc(oldmem, bytes) Void_t* oldmem; size_t bytes;
 
     /* Must allocate */
 
-    newmem = mALLOc (bytes);
+    newmem = malloc_heap(bytes);
 
     if (newmem == NULL)  /* propagate failure */
       return NULL;
@@ -1902,7 +2005,7 @@ Void_t* mEMALIGn(alignment, bytes) size_t alignment; size_t bytes;
   /* Call malloc with worst case padding to hit alignment. */
 
   nb = request2size(bytes);
-  m  = (char*)(mALLOc(nb + alignment + MINSIZE));
+  m  = (char*)(malloc_heap(nb + alignment + MINSIZE));
 
   /*
   * The attempt to over-allocate (with a size large enough to guarantee the
@@ -1918,7 +2021,7 @@ Void_t* mEMALIGn(alignment, bytes) size_t alignment; size_t bytes;
      * Use bytes not nb, since mALLOc internally calls request2size too, and
      * each call increases the size to allocate, to account for the header.
      */
-    m  = (char*)(mALLOc(bytes));
+    m  = (char*)(malloc_heap(bytes));
     /* Aligned -> return it */
     if ((((unsigned long)(m)) % alignment) == 0)
       return m;
@@ -1929,7 +2032,7 @@ Void_t* mEMALIGn(alignment, bytes) size_t alignment; size_t bytes;
     fREe(m);
     /* Add in extra bytes to match misalignment of unexpanded allocation */
     extra = alignment - (((unsigned long)(m)) % alignment);
-    m  = (char*)(mALLOc(bytes + extra));
+    m  = (char*)(malloc_heap(bytes + extra));
     /*
      * m might not be the same as before. Validate that the previous value of
      * extra still works for the current value of m.
@@ -2078,6 +2181,12 @@ Void_t* cALLOc(n, elem_size) size_t n; size_t elem_size;
     return NULL;
   else
   {
+#if CONFIG_IS_ENABLED(SYS_MALLOC_SLAB)
+	if (malloc_slab_owns(malloc_slab(), mem)) {
+		MALLOC_ZERO(mem, sz);
+		return mem;
+	}
+#endif
 #if CONFIG_VAL(SYS_MALLOC_F_LEN)
 	if (!(gd->flags & GD_FLG_FULL_MALLOC_INIT)) {
 		MALLOC_ZERO(mem, sz);
@@ -2124,7 +2233,7 @@ void cfree(Void_t *mem)
 void cfree(mem) Void_t *mem;
 #endif
 {
-  fREe(mem);
+  free(mem);
 }
 #endif
 
@@ -2231,6 +2340,10 @@ size_t malloc_usable_size(mem) Void_t* mem;
   mchunkptr p;
   if (mem == NULL)
     return 0;
+#if CONFIG_IS_ENABLED(SYS_MALLOC_SLAB)
+  else if (malloc_slab_owns(malloc_slab(), mem))
+    return malloc_slab_size(gd->malloc_slab, mem);
+#endif
   else
   {
     p = mem2chunk(mem);
@@ -2384,10 +2497,110 @@ int initf_malloc(void)
 	gd->malloc_limit = CONFIG_VAL(SYS_MALLOC_F_LEN);
 	gd->malloc_ptr = 0;
 #endif
+#if CONFIG_IS_ENABLED(SYS_MALLOC_F_SLAB)
+	{
+		void *base = malloc_simple(CONFIG_SYS_MALLOC_F_SLAB_LEN);
+
+		if (base)
+			gd->malloc_slab = malloc_slab_init((ulong)base,
+					CONFIG_SYS_MALLOC_F_SLAB_LEN, 9);
+	}
+#endif
 
 	return 0;
 }
 
+void malloc_frag(struct malloc_frag *frag)
+{
+	mbinptr b;
+	mchunkptr p;
+	ulong size;
+	int i;
+
+	memset(frag, '\0', sizeof(*frag));
+	if (!mem_malloc_start)
+		return;
+
+	/* the top chunk grows into what sbrk() has not handed out yet */
+	frag->largest = chunksize(top) + mem_malloc_end - mem_malloc_brk;
+	frag->free = frag->largest;
+	frag->chunks = 1;
+	for (i = 1; i < NAV; i++) {
+		b = bin_at(i);
+		for (p = last(b); p != b; p = p->bk) {
+			size = chunksize(p);
+			frag->free += size;
+			frag->largest = max(frag->largest, size);
+			frag->chunks++;
+		}
+	}
+}
+
+#if CONFIG_IS_ENABLED(MALLOC_TRACE)
+void *malloc(size_t bytes)
+{
+	void *mem = mALLOc(bytes);
+
+	malloc_trace_alloc(mem, bytes, __builtin_return_address(0));
+
+	return mem;
+}
+
+void free(void *mem)
+{
+	malloc_trace_free(mem);
+	fREe(mem);
+}
+
+void *realloc(void *oldmem, size_t bytes)
+{
+	void *mem = rEALLOc(oldmem, bytes);
+
+	if (mem) {
+		malloc_trace_free(oldmem);
+		malloc_trace_alloc(mem, bytes, __builtin_return_address(0));
+	}
+
+	return mem;
+}
+
+void *memalign(size_t alignment, size_t bytes)
+{
+	void *mem = mEMALIGn(alignment, bytes);
+
+	malloc_trace_alloc(mem, bytes, __builtin_return_address(0));
+
+	return mem;
+}
+
+void *valloc(size_t bytes)
+{
+	void *mem = vALLOc(bytes);
+
+	malloc_trace_alloc(mem, bytes, __builtin_return_address(0));
+
+	return mem;
+}
+
+void *pvalloc(size_t bytes)
+{
+	void *mem = pvALLOc(bytes);
+
+	malloc_trace_alloc(mem, bytes, __builtin_return_address(0));
+
+	return mem;
+}
+
+void *calloc(size_t n, size_t elem_size)
+{
+	void *mem = cALLOc(n, elem_size);
+
+	malloc_trace_alloc(mem, n * elem_size, __builtin_return_address(0));
+
+	return mem;
+}
+#endif
+
 /*
 
 History:
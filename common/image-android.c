@@ -5,6 +5,7 @@
  */
 
 #include <common.h>
+#include <bootm.h>
 #include <image.h>
 #include <android_image.h>
 #include <android_bootloader.h>
@@ -527,6 +528,32 @@ int android_image_memcpy_separate(struct andr_img_hdr *hdr, void *load_address)
 }
 #endif /* CONFIG_ANDROID_BOOT_IMAGE_SEPARATE */
 
+#ifdef CONFIG_CMD_BOOTI_PLACE
+/*
+ * Move *@load_address, the kernel being read after the header page, to
+ * where booti would run it. Return true if the kernel is an arm64 Image,
+ * whose header is among the @peek bytes read from the start of @hdr.
+ */
+static bool android_image_place(struct andr_img_hdr *hdr, ulong peek,
+				ulong *load_address)
+{
+	ulong kaddr = *load_address + hdr->page_size;
+	ulong dst;
+
+	if (hdr->page_size + LINUX_ARM64_IMAGE_HDR_SIZE > peek ||
+	    booti_image_dest((void *)hdr + hdr->page_size, kaddr, &dst, NULL))
+		return false;
+
+	if (dst != kaddr) {
+		printf("Kernel Image read to 0x%lx, where booti runs it\n",
+		       dst);
+		*load_address = dst - hdr->page_size;
+	}
+
+	return true;
+}
+#endif
+
 long android_image_load(struct blk_desc *dev_desc,
 			const disk_partition_t *part_info,
 			unsigned long load_address,
@@ -538,6 +565,7 @@ long android_image_load(struct blk_desc *dev_desc,
 	u32 kload_addr;
 	u32 blkcnt;
 	struct andr_img_hdr *hdr;
+	bool placed = false;
 
 	if (max_size < part_info->blksz)
 		return -1;
@@ -600,6 +628,14 @@ long android_image_load(struct blk_desc *dev_desc,
 			}
 #endif
 		}
+#ifdef CONFIG_CMD_BOOTI_PLACE
+		else if (android_image_place(hdr, blkcnt * 512,
+					     &load_address)) {
+			placed = true;
+			unmap_sysmem(buf);
+			buf = map_sysmem(load_address, 0 /* size */);
+		}
+#endif
 
 		if (blk_cnt * part_info->blksz > max_size) {
 			debug("Android Image too big (%lu bytes, max %lu)\n",
@@ -643,6 +679,10 @@ long android_image_load(struct blk_desc *dev_desc,
 			android_image_set_comp(buf, comp);
 		} else {
 			android_image_set_comp(buf, IH_COMP_NONE);
+			/* run it where it was read, without another move */
+			if (placed)
+				android_image_set_kload(buf, load_address +
+							hdr->page_size);
 		}
 
 	}
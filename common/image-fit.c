@@ -17,6 +17,7 @@
 #include <linux/kconfig.h>
 #include <common.h>
 #include <errno.h>
+#include <hash.h>
 #include <mapmem.h>
 #include <asm/io.h>
 #include <malloc.h>
@@ -143,7 +144,96 @@ int fit_get_subimage_count(const void *fit, int images_noffset)
 	return count;
 }
 
+/*
+ * Get the entries of index property @prop, pairs of a CRC32 and a node
+ * offset sorted by both, or NULL if the FIT has no index or it is out of
+ * date
+ */
+static const fdt32_t *fit_index_get(const void *fit, const char *prop,
+				    int *countp)
+{
+	const fdt32_t *cell;
+	int index, len;
+
+	index = fdt_path_offset(fit, FIT_INDEX_PATH);
+	if (index < 0)
+		return NULL;
+	cell = fdt_getprop(fit, index, FIT_INDEX_SIZE_PROP, &len);
+	if (!cell || len != sizeof(*cell) ||
+	    fdt32_to_cpu(*cell) != fdt_size_dt_struct(fit))
+		return NULL;
+	cell = fdt_getprop(fit, index, prop, &len);
+	if (!cell)
+		return NULL;
+	*countp = len / (2 * sizeof(*cell));
+
+	return cell;
+}
+
+/* Find the first of the @count entries in @index with CRC32 @key */
+static int fit_index_first(const fdt32_t *index, int count, uint32_t key)
+{
+	int lo = 0, hi = count, mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (fdt32_to_cpu(index[2 * mid]) < key)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+/*
+ * Find subnode @name of @parent, /images or /configurations, through index
+ * property @prop if the FIT has an index, else by walking the subnodes. An
+ * index entry is only taken if it points at a child of @parent, the index
+ * itself is not covered by any signature.
+ */
+static int fit_subnode_offset(const void *fit, int parent, const char *prop,
+			      const char *name)
+{
+	const fdt32_t *index;
+	const char *node_name;
+	int count, noffset, i;
+	uint32_t key;
+
+	index = IMAGE_ENABLE_FIT_INDEX ? fit_index_get(fit, prop, &count) :
+		NULL;
+	if (index) {
+		key = crc32(0, (const uint8_t *)name, strlen(name));
+		for (i = fit_index_first(index, count, key);
+		     i < count && fdt32_to_cpu(index[2 * i]) == key; i++) {
+			noffset = fdt32_to_cpu(index[2 * i + 1]);
+			node_name = fdt_get_name(fit, noffset, NULL);
+			if (node_name && !strcmp(node_name, name) &&
+			    fdt_parent_offset(fit, noffset) == parent)
+				return noffset;
+		}
+	}
+
+	return fdt_subnode_offset(fit, parent, name);
+}
+
 #if !defined(CONFIG_SPL_BUILD) || defined(CONFIG_FIT_SPL_PRINT)
+static void fit_index_print(const void *fit, const char *p)
+{
+	int images = 0, confs = 0, compats = 0;
+
+	if (fdt_path_offset(fit, FIT_INDEX_PATH) < 0)
+		return;
+	printf("%sIndex:           ", p);
+	if (!fit_index_get(fit, FIT_INDEX_IMAGES_PROP, &images) ||
+	    !fit_index_get(fit, FIT_INDEX_CONFS_PROP, &confs) ||
+	    !fit_index_get(fit, FIT_INDEX_COMPAT_PROP, &compats))
+		printf("out of date\n");
+	else
+		printf("%d images, %d configurations, %d compatibles\n",
+		       images, confs, compats);
+}
+
 /**
  * fit_print_contents - prints out the contents of the FIT format image
  * @fit: pointer to the FIT format image header
@@ -188,6 +278,7 @@ void fit_print_contents(const void *fit)
 		else
 			genimg_print_time(timestamp);
 	}
+	fit_index_print(fit, p);
 
 	/* Find images parent node offset */
 	images_noffset = fdt_path_offset(fit, FIT_IMAGES_PATH);
@@ -392,7 +483,7 @@ void fit_image_print(const void *fit, int image_noffset, const char *p)
 	fit_image_get_comp(fit, image_noffset, &comp);
 	printf("%s  Compression:  %s\n", p, genimg_get_comp_name(comp));
 
-	ret = fit_image_get_data(fit, image_noffset, &data, &size);
+	ret = fit_image_get_data_and_size(fit, image_noffset, &data, &size);
 
 #ifndef USE_HOSTCC
 	printf("%s  Data Start:   ", p);
@@ -546,7 +637,8 @@ int fit_image_get_node(const void *fit, const char *image_uname)
 		return images_noffset;
 	}
 
-	noffset = fdt_subnode_offset(fit, images_noffset, image_uname);
+	noffset = fit_subnode_offset(fit, images_noffset,
+				     FIT_INDEX_IMAGES_PROP, image_uname);
 	if (noffset < 0) {
 		debug("Can't get node offset for image unit name: '%s' (%s)\n",
 		      image_uname, fdt_strerror(noffset));
@@ -806,6 +898,31 @@ int fit_image_get_data_offset(const void *fit, int noffset, int *data_offset)
 	return 0;
 }
 
+/**
+ * Get 'data-position' property from a given image node.
+ *
+ * @fit: pointer to the FIT image header
+ * @noffset: component image node offset
+ * @data_position: holds the data-position property
+ *
+ * returns:
+ *     0, on success
+ *     -ENOENT if the property could not be found
+ */
+int fit_image_get_data_position(const void *fit, int noffset,
+				int *data_position)
+{
+	const fdt32_t *val;
+
+	val = fdt_getprop(fit, noffset, FIT_DATA_POSITION_PROP, NULL);
+	if (!val)
+		return -ENOENT;
+
+	*data_position = fdt32_to_cpu(*val);
+
+	return 0;
+}
+
 /**
  * Get 'data-size' property from a given image node.
  *
@@ -830,6 +947,40 @@ int fit_image_get_data_size(const void *fit, int noffset, int *data_size)
 	return 0;
 }
 
+/**
+ * fit_image_get_data_and_size - get data and its size, embedded or external
+ * @fit: pointer to the FIT image header
+ * @noffset: component image node offset
+ * @data: double pointer to void, will hold data property's data address
+ * @size: pointer to size_t, will hold data property's data size
+ *
+ * External data, which mkimage -E places after the FIT's own tree, must
+ * have been loaded along with it.
+ *
+ * returns:
+ *     0, on success
+ *     otherwise, on failure
+ */
+int fit_image_get_data_and_size(const void *fit, int noffset,
+				const void **data, size_t *size)
+{
+	int offset, len;
+
+	if (fit_image_get_data_position(fit, noffset, &offset)) {
+		if (fit_image_get_data_offset(fit, noffset, &offset))
+			return fit_image_get_data(fit, noffset, data, size);
+		/* data-offset counts from the end of the tree */
+		offset += (fdt_totalsize(fit) + 3) & ~3;
+	}
+	if (fit_image_get_data_size(fit, noffset, &len))
+		return -ENOENT;
+
+	*data = fit + offset;
+	*size = len;
+
+	return 0;
+}
+
 /**
  * fit_image_hash_get_algo - get hash algorithm name
  * @fit: pointer to the FIT format image header
@@ -995,6 +1146,245 @@ int calculate_hash(const void *data, int data_len, const char *algo,
 	return 0;
 }
 
+#if !defined(USE_HOSTCC) && defined(CONFIG_FIT_VERIFY_ON_LOAD)
+/**
+ * struct fit_load_hash - hash of external data, computed while loading
+ *
+ * @image:	Image node offset
+ * @noffset:	Hash node offset
+ * @algo:	Hash algorithm
+ * @ctx:	Hash context, NULL once finished
+ * @start:	Offset of the data in the FIT
+ * @size:	Size of the data
+ * @done:	Bytes of the data hashed
+ * @us:		Microseconds spent hashing
+ * @ok:		The hash matches the value in the FIT
+ * @value:	The hash, as stored in the FIT
+ */
+struct fit_load_hash {
+	int image;
+	int noffset;
+	struct hash_algo *algo;
+	void *ctx;
+	ulong start;
+	ulong size;
+	ulong done;
+	ulong us;
+	bool ok;
+	uint8_t value[FIT_MAX_HASH_LEN];
+};
+
+/* Hashes of the FIT being loaded, or loaded last */
+static struct {
+	const void *fit;
+	int count;
+	struct fit_load_hash *hash;
+} fit_load;
+
+void fit_load_verify_reset(void)
+{
+	uint8_t value[FIT_MAX_HASH_LEN];
+	struct fit_load_hash *h;
+	int i;
+
+	for (i = 0; i < fit_load.count; i++) {
+		h = &fit_load.hash[i];
+		/* finishing frees the context */
+		if (h->ctx)
+			h->algo->hash_finish(h->algo, h->ctx, value,
+					     sizeof(value));
+	}
+	free(fit_load.hash);
+	memset(&fit_load, '\0', sizeof(fit_load));
+}
+
+int fit_load_verify_start(const void *fit)
+{
+	ulong base = (fdt_totalsize(fit) + 3) & ~3;
+	int images, image, noffset, offset, size;
+	struct fit_load_hash *h;
+	int count = 0;
+	int ignore;
+	char *algo;
+
+	fit_load_verify_reset();
+	images = fdt_path_offset(fit, FIT_IMAGES_PATH);
+	if (images < 0)
+		return -ENOENT;
+	fdt_for_each_subnode(image, fit, images) {
+		fdt_for_each_subnode(noffset, fit, image)
+			count++;
+	}
+	if (!count)
+		return -ENOENT;
+	fit_load.hash = calloc(count, sizeof(*h));
+	if (!fit_load.hash)
+		return -ENOMEM;
+
+	fdt_for_each_subnode(image, fit, images) {
+		/* embedded data is left to fit_image_verify() */
+		if (fit_image_get_data_position(fit, image, &offset)) {
+			if (fit_image_get_data_offset(fit, image, &offset))
+				continue;
+			offset += base;
+		}
+		if (fit_image_get_data_size(fit, image, &size))
+			continue;
+
+		fdt_for_each_subnode(noffset, fit, image) {
+			if (strncmp(fit_get_name(fit, noffset, NULL),
+				    FIT_HASH_NODENAME,
+				    strlen(FIT_HASH_NODENAME)))
+				continue;
+			fit_image_hash_get_ignore(fit, noffset, &ignore);
+			if (IMAGE_ENABLE_IGNORE && ignore)
+				continue;
+
+			h = &fit_load.hash[fit_load.count];
+			if (fit_image_hash_get_algo(fit, noffset, &algo) ||
+			    hash_progressive_lookup_algo(algo, &h->algo) ||
+			    h->algo->hash_init(h->algo, &h->ctx))
+				continue;
+			h->image = image;
+			h->noffset = noffset;
+			h->start = offset;
+			h->size = size;
+			fit_load.count++;
+		}
+	}
+	if (!fit_load.count) {
+		fit_load_verify_reset();
+		return -ENOENT;
+	}
+	fit_load.fit = fit;
+
+	return 0;
+}
+
+void fit_load_verify_update(ulong offset, ulong len)
+{
+	struct fit_load_hash *h;
+	ulong pos, end, start;
+	int i;
+
+	for (i = 0; i < fit_load.count; i++) {
+		h = &fit_load.hash[i];
+		pos = h->start + h->done;
+		end = min(h->start + h->size, offset + len);
+		if (!h->ctx || pos < offset || pos >= end)
+			continue;
+
+		start = timer_get_us();
+		/* updating frees the context on error */
+		if (h->algo->hash_update(h->algo, h->ctx, fit_load.fit + pos,
+					 end - pos,
+					 end == h->start + h->size))
+			h->ctx = NULL;
+		h->done += end - pos;
+		h->us += timer_get_us() - start;
+	}
+}
+
+int fit_load_verify_finish(void)
+{
+	const void *fit = fit_load.fit;
+	struct fit_load_hash *h;
+	int image = -1;
+	uint8_t *value;
+	int ret = 0;
+	int i, len;
+
+	printf("## Checking hash(es) for FIT Image at %08lx while loading ...\n",
+	       (ulong)map_to_sysmem(fit));
+	for (i = 0; i < fit_load.count; i++) {
+		h = &fit_load.hash[i];
+		if (h->image != image) {
+			if (image >= 0)
+				puts("\n");
+			printf("   Hash(es) for Image %s: ",
+			       fit_get_name(fit, h->image, NULL));
+			image = h->image;
+		}
+		printf("%s", h->algo->name);
+
+		if (h->ctx) {
+			h->algo->hash_finish(h->algo, h->ctx, h->value,
+					     sizeof(h->value));
+			h->ctx = NULL;
+			/* as calculate_hash() stores it */
+			if (!strcmp(h->algo->name, "crc32"))
+				*(uint32_t *)h->value =
+					cpu_to_uimage(*(uint32_t *)h->value);
+			h->ok = h->done == h->size &&
+				!fit_image_hash_get_value(fit, h->noffset,
+							  &value, &len) &&
+				len == h->algo->digest_size &&
+				!memcmp(h->value, value, len);
+		}
+		printf("%c (%lu us) ", h->ok ? '+' : '-', h->us);
+		if (!h->ok)
+			ret = -EBADMSG;
+	}
+	puts("\n");
+	if (ret)
+		puts("Bad hash value\n");
+
+	return ret;
+}
+
+/*
+ * Verified boot must hash the data it is about to boot: anything may have
+ * been written to memory since the FIT was loaded.
+ */
+static bool fit_load_sig_required(void)
+{
+#ifdef CONFIG_FIT_SIGNATURE
+	const void *sig_blob = gd_fdt_blob();
+	int sig_node, noffset;
+
+	if (!sig_blob)
+		return false;
+	sig_node = fdt_subnode_offset(sig_blob, 0, FIT_SIG_NODENAME);
+	if (sig_node < 0)
+		return false;
+	fdt_for_each_subnode(noffset, sig_blob, sig_node) {
+		if (fdt_getprop(sig_blob, noffset, "required", NULL))
+			return true;
+	}
+#endif
+
+	return false;
+}
+
+/*
+ * Check if the hash at @noffset was found to be @value while loading
+ * @data. A hash is taken only once, so later checks compute it again.
+ */
+static bool fit_load_verified(const void *fit, int noffset, const void *data,
+			      size_t size, const uint8_t *value, int len)
+{
+	struct fit_load_hash *h;
+	bool ok;
+	int i;
+
+	if (fit != fit_load.fit || fit_load_sig_required())
+		return false;
+	for (i = 0; i < fit_load.count; i++) {
+		h = &fit_load.hash[i];
+		if (h->noffset != noffset)
+			continue;
+		ok = h->ok && data == fit + h->start && size == h->size &&
+		     len == h->algo->digest_size &&
+		     !memcmp(h->value, value, len);
+		h->ok = false;
+
+		return ok;
+	}
+
+	return false;
+}
+#endif
+
 static int fit_image_check_hash(const void *fit, int noffset, const void *data,
 				size_t size, char **err_msgp)
 {
@@ -1027,6 +1417,14 @@ static int fit_image_check_hash(const void *fit, int noffset, const void *data,
 		return -1;
 	}
 
+#if !defined(USE_HOSTCC) && defined(CONFIG_FIT_VERIFY_ON_LOAD)
+	if (fit_load_verified(fit, noffset, data, size, fit_value,
+			      fit_value_len)) {
+		printf("-loaded");
+		return 0;
+	}
+#endif
+
 	if (calculate_hash(data, size, algo, value, &value_len)) {
 		*err_msgp = "Unsupported hash algorithm";
 		return -1;
@@ -1066,7 +1464,7 @@ int fit_image_verify(const void *fit, int image_noffset)
 	int ret;
 
 	/* Get image data and data length */
-	if (fit_image_get_data(fit, image_noffset, &data, &size)) {
+	if (fit_image_get_data_and_size(fit, image_noffset, &data, &size)) {
 		err_msg = "Can't get image data/size";
 		goto error;
 	}
@@ -1311,6 +1709,75 @@ int fit_check_format(const void *fit)
 }
 
 
+/* Get the FDT which configuration @noffset refers to, NULL if none */
+static const void *fit_conf_get_fdt(const void *fit, int images_noffset,
+				    int noffset)
+{
+	const void *kfdt;
+	const char *kfdt_name;
+	int kfdt_noffset;
+	size_t size;
+
+	kfdt_name = fdt_getprop(fit, noffset, "fdt", NULL);
+	if (!kfdt_name) {
+		debug("No fdt property found.\n");
+		return NULL;
+	}
+	kfdt_noffset = fit_subnode_offset(fit, images_noffset,
+					  FIT_INDEX_IMAGES_PROP, kfdt_name);
+	if (kfdt_noffset < 0) {
+		debug("No image node named \"%s\" found.\n", kfdt_name);
+		return NULL;
+	}
+	if (fit_image_get_data_and_size(fit, kfdt_noffset, &kfdt, &size)) {
+		debug("Failed to get fdt \"%s\".\n", kfdt_name);
+		return NULL;
+	}
+
+	return kfdt;
+}
+
+/*
+ * Find the best configuration for U-Boot's @fdt_compat list through the
+ * index, which holds each compatible string of each configuration's FDT in
+ * the order of the configurations. Entries which do not point at a child of
+ * @confs_noffset are skipped. Returns -ENOENT if there is none, or -EINVAL
+ * if the FIT has no index.
+ */
+static int fit_conf_find_compat_index(const void *fit, int confs_noffset,
+				      int images_noffset,
+				      const char *fdt_compat,
+				      int fdt_compat_len)
+{
+	const fdt32_t *index;
+	const void *kfdt;
+	int count, noffset, len, i;
+	uint32_t key;
+
+	if (!IMAGE_ENABLE_FIT_INDEX)
+		return -EINVAL;
+	index = fit_index_get(fit, FIT_INDEX_COMPAT_PROP, &count);
+	if (!index)
+		return -EINVAL;
+
+	for (; fdt_compat_len > 0; fdt_compat_len -= len, fdt_compat += len) {
+		len = strlen(fdt_compat) + 1;
+		key = crc32(0, (const uint8_t *)fdt_compat, len - 1);
+		for (i = fit_index_first(index, count, key);
+		     i < count && fdt32_to_cpu(index[2 * i]) == key; i++) {
+			noffset = fdt32_to_cpu(index[2 * i + 1]);
+			if (fdt_parent_offset(fit, noffset) != confs_noffset)
+				continue;
+			kfdt = fit_conf_get_fdt(fit, images_noffset, noffset);
+			if (kfdt && !fdt_node_check_compatible(kfdt, 0,
+							       fdt_compat))
+				return noffset;
+		}
+	}
+
+	return -ENOENT;
+}
+
 /**
  * fit_conf_find_compat
  * @fit: pointer to the FIT format image header
@@ -1372,6 +1839,11 @@ int fit_conf_find_compat(const void *fit, const void *fdt)
 		return -1;
 	}
 
+	noffset = fit_conf_find_compat_index(fit, confs_noffset, images_noffset,
+					     fdt_compat, fdt_compat_len);
+	if (noffset != -EINVAL)
+		return noffset < 0 ? -1 : noffset;
+
 	/*
 	 * Loop over the configurations in the FIT image.
 	 */
@@ -1379,35 +1851,19 @@ int fit_conf_find_compat(const void *fit, const void *fdt)
 			(noffset >= 0) && (ndepth > 0);
 			noffset = fdt_next_node(fit, noffset, &ndepth)) {
 		const void *kfdt;
-		const char *kfdt_name;
-		int kfdt_noffset;
 		const char *cur_fdt_compat;
 		int len;
-		size_t size;
 		int i;
 
 		if (ndepth > 1)
 			continue;
 
-		kfdt_name = fdt_getprop(fit, noffset, "fdt", &len);
-		if (!kfdt_name) {
-			debug("No fdt property found.\n");
-			continue;
-		}
-		kfdt_noffset = fdt_subnode_offset(fit, images_noffset,
-						  kfdt_name);
-		if (kfdt_noffset < 0) {
-			debug("No image node named \"%s\" found.\n",
-			      kfdt_name);
-			continue;
-		}
 		/*
 		 * Get a pointer to this configuration's fdt.
 		 */
-		if (fit_image_get_data(fit, kfdt_noffset, &kfdt, &size)) {
-			debug("Failed to get fdt \"%s\".\n", kfdt_name);
+		kfdt = fit_conf_get_fdt(fit, images_noffset, noffset);
+		if (!kfdt)
 			continue;
-		}
 
 		len = fdt_compat_len;
 		cur_fdt_compat = fdt_compat;
@@ -1496,7 +1952,8 @@ int fit_conf_get_node(const void *fit, const char *conf_uname)
 		conf_uname = conf_uname_copy;
 	}
 
-	noffset = fdt_subnode_offset(fit, confs_noffset, conf_uname);
+	noffset = fit_subnode_offset(fit, confs_noffset, FIT_INDEX_CONFS_PROP,
+				     conf_uname);
 	if (noffset < 0) {
 		debug("Can't get node offset for configuration unit name: '%s' (%s)\n",
 		      conf_uname, fdt_strerror(noffset));
@@ -1821,7 +2278,7 @@ int fit_image_load(bootm_headers_t *images, ulong addr,
 	bootstage_mark(bootstage_id + BOOTSTAGE_SUB_CHECK_ALL_OK);
 
 	/* get image data address and length */
-	if (fit_image_get_data(fit, noffset, &buf, &size)) {
+	if (fit_image_get_data_and_size(fit, noffset, &buf, &size)) {
 		printf("Could not find %s subimage data!\n", prop_name);
 		bootstage_error(bootstage_id + BOOTSTAGE_SUB_GET_DATA);
 		return -ENOENT;
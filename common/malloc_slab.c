@@ -0,0 +1,180 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <malloc_slab.h>
+
+static const u16 slab_sizes[MALLOC_SLAB_CLASSES] = {
+	16, 32, 48, 64, 96, 128, 192, 256, 384, 512
+};
+
+/* Size class for a request of up to (index * 16) bytes */
+static const u8 slab_class_of[MALLOC_SLAB_MAX / 16 + 1] = {
+	0, 0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7,
+	8, 8, 8, 8, 8, 8, 8, 8, 9, 9, 9, 9, 9, 9, 9, 9,
+};
+
+struct malloc_slab *malloc_slab_init(ulong base, ulong size, uint page_shift)
+{
+	struct malloc_slab *slab = (struct malloc_slab *)base;
+	ulong page_size = 1UL << page_shift;
+	ulong start;
+	uint num, i;
+
+	if (page_size < MALLOC_SLAB_MAX || size < sizeof(*slab))
+		return NULL;
+
+	num = (size - sizeof(*slab)) /
+		(page_size + sizeof(struct malloc_slab_page));
+	num = min(num, (uint)MALLOC_SLAB_NONE);
+	start = ALIGN(base + sizeof(*slab) + num * sizeof(slab->page[0]),
+		      page_size);
+	while (num && start + (num << page_shift) > base + size)
+		num--;
+	if (!num)
+		return NULL;
+
+	memset(slab, '\0', sizeof(*slab));
+	slab->start = start;
+	slab->page_shift = page_shift;
+	slab->num_pages = num;
+	slab->free_pages = MALLOC_SLAB_NONE;
+	for (i = 0; i < MALLOC_SLAB_CLASSES; i++) {
+		slab->cls[i].size = slab_sizes[i];
+		slab->cls[i].per_page = page_size / slab_sizes[i];
+		slab->cls[i].partial = MALLOC_SLAB_NONE;
+	}
+
+	return slab;
+}
+
+static void slab_unlink(struct malloc_slab *slab, u16 *head, uint idx)
+{
+	struct malloc_slab_page *pg = &slab->page[idx];
+
+	if (pg->prev != MALLOC_SLAB_NONE)
+		slab->page[pg->prev].next = pg->next;
+	else
+		*head = pg->next;
+	if (pg->next != MALLOC_SLAB_NONE)
+		slab->page[pg->next].prev = pg->prev;
+}
+
+static void slab_push(struct malloc_slab *slab, u16 *head, uint idx)
+{
+	struct malloc_slab_page *pg = &slab->page[idx];
+
+	pg->prev = MALLOC_SLAB_NONE;
+	pg->next = *head;
+	if (*head != MALLOC_SLAB_NONE)
+		slab->page[*head].prev = idx;
+	*head = idx;
+}
+
+/* Give a page to @cls: one given back before, else one never used */
+static int slab_new_page(struct malloc_slab *slab, uint cls)
+{
+	struct malloc_slab_page *pg;
+	uint idx;
+
+	if (slab->free_pages != MALLOC_SLAB_NONE) {
+		idx = slab->free_pages;
+		slab_unlink(slab, &slab->free_pages, idx);
+	} else if (slab->used_pages < slab->num_pages) {
+		idx = slab->used_pages++;
+	} else {
+		return -ENOMEM;
+	}
+
+	pg = &slab->page[idx];
+	pg->free = NULL;
+	pg->inuse = 0;
+	pg->carved = 0;
+	pg->cls = cls;
+	slab_push(slab, &slab->cls[cls].partial, idx);
+	slab->cls[cls].pages++;
+
+	return 0;
+}
+
+void *malloc_slab_alloc(struct malloc_slab *slab, size_t bytes)
+{
+	struct malloc_slab_class *sc;
+	struct malloc_slab_page *pg;
+	uint cls, idx;
+	void *obj;
+
+	cls = slab_class_of[(bytes + 15) / 16];
+	sc = &slab->cls[cls];
+	if (sc->partial == MALLOC_SLAB_NONE && slab_new_page(slab, cls)) {
+		sc->fails++;
+		return NULL;
+	}
+
+	idx = sc->partial;
+	pg = &slab->page[idx];
+	if (pg->free) {
+		obj = pg->free;
+		pg->free = *(void **)obj;
+	} else {
+		obj = (void *)(slab->start + ((ulong)idx << slab->page_shift) +
+			       pg->carved++ * sc->size);
+	}
+	if (++pg->inuse == sc->per_page)
+		slab_unlink(slab, &sc->partial, idx);
+
+	sc->allocs++;
+	if (++sc->inuse > sc->peak)
+		sc->peak = sc->inuse;
+
+	return obj;
+}
+
+void malloc_slab_free(struct malloc_slab *slab, void *ptr)
+{
+	uint idx = ((ulong)ptr - slab->start) >> slab->page_shift;
+	struct malloc_slab_page *pg = &slab->page[idx];
+	struct malloc_slab_class *sc = &slab->cls[pg->cls];
+
+	if (pg->inuse == sc->per_page)
+		slab_push(slab, &sc->partial, idx);
+	sc->inuse--;
+
+	/* an empty page can go to any class */
+	if (!--pg->inuse) {
+		slab_unlink(slab, &sc->partial, idx);
+		slab_push(slab, &slab->free_pages, idx);
+		sc->pages--;
+		return;
+	}
+
+	*(void **)ptr = pg->free;
+	pg->free = ptr;
+}
+
+size_t malloc_slab_size(struct malloc_slab *slab, const void *ptr)
+{
+	uint idx = ((ulong)ptr - slab->start) >> slab->page_shift;
+
+	return slab->cls[slab->page[idx].cls].size;
+}
+
+void malloc_slab_stats(struct malloc_slab *slab)
+{
+	struct malloc_slab_class *sc;
+	uint i;
+
+	printf("slab: %u of %u pages of %lu bytes used at %08lx\n",
+	       slab->used_pages, slab->num_pages, 1UL << slab->page_shift,
+	       slab->start);
+	printf(" size  pages  in use    peak    allocs   fails\n");
+	for (i = 0; i < MALLOC_SLAB_CLASSES; i++) {
+		sc = &slab->cls[i];
+		printf("%5u %6u %7lu %7lu %9lu %7lu\n", sc->size, sc->pages,
+		       sc->inuse, sc->peak, sc->allocs, sc->fails);
+	}
+}
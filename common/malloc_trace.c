@@ -0,0 +1,367 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <malloc_trace.h>
+#include <linux/log2.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+#define TRACE_HEAP		0
+#define TRACE_SYSMEM		1
+#define TRACE_KINDS		2
+#define TRACE_OWNERS		64
+#define TRACE_TOP		32
+#define TRACE_PROBES		32	/* before a site goes to "other" */
+
+#define TRACE_ENTRY_BITS	ilog2(CONFIG_MALLOC_TRACE_ENTRIES)
+#define TRACE_SITE_BITS		ilog2(CONFIG_MALLOC_TRACE_SITES)
+
+/*
+ * A live allocation. @key is its address with the kind in bit 0, which
+ * heap and sysmem addresses leave clear, 0 for a free slot.
+ */
+struct trace_entry {
+	ulong key;
+	ulong size;
+	u32 birth;
+	u16 site;
+	u8 owner;
+};
+
+/**
+ * struct trace_site - totals of a call site
+ *
+ * @addr:	Return address of the allocation call, 0 if the slot is free
+ * @kind:	TRACE_HEAP or TRACE_SYSMEM
+ * @owner:	Owner of the first allocation from the site
+ * @allocs:	Allocations
+ * @frees:	Allocations freed again
+ * @live:	Bytes allocated and not freed
+ * @peak:	Highest value of @live
+ * @life:	Milliseconds the freed allocations lived, summed
+ */
+struct trace_site {
+	ulong addr;
+	u8 kind;
+	u8 owner;
+	ulong allocs;
+	ulong frees;
+	ulong live;
+	ulong peak;
+	ulong life;
+};
+
+struct trace_owner {
+	const char *name;
+	u8 kind;
+	ulong allocs;
+	ulong live;
+	ulong peak;
+};
+
+/**
+ * struct malloc_trace - state of the tracer
+ *
+ * @entries:	Live allocations in @entry
+ * @untracked:	Allocations not recorded because @entry was full
+ * @now:	get_timer() at the last call
+ * @busy:	get_timer() is running, it may allocate on first use
+ * @cur:	Current owner, index in @owner
+ * @cur_name:	Current owner, as given to malloc_trace_owner()
+ * @owners:	Slots of @owner in use, the first one collects the rest
+ * @live:	Bytes allocated and not freed, per kind
+ * @peak:	Highest value of @live, per kind
+ * @owner:	Owners
+ * @site:	Call sites, hashed by address, the first one collects the rest
+ * @entry:	Live allocations, hashed by key
+ */
+struct malloc_trace {
+	uint entries;
+	ulong untracked;
+	u32 now;
+	bool busy;
+	u8 cur;
+	const char *cur_name;
+	uint owners;
+	ulong live[TRACE_KINDS];
+	ulong peak[TRACE_KINDS];
+	struct trace_owner owner[TRACE_OWNERS];
+	struct trace_site *site;
+	struct trace_entry *entry;
+};
+
+/* Set after relocation, must not be in BSS which is unusable before */
+static struct malloc_trace *trace __section(".data");
+
+static const char *const trace_kind[TRACE_KINDS] = { "heap", "sysmem" };
+
+ulong malloc_trace_size(void)
+{
+	return ALIGN(sizeof(struct malloc_trace) +
+		     (sizeof(struct trace_site) << TRACE_SITE_BITS) +
+		     (sizeof(struct trace_entry) << TRACE_ENTRY_BITS), 16);
+}
+
+void malloc_trace_init(ulong base)
+{
+	struct malloc_trace *t = (struct malloc_trace *)base;
+
+	memset(t, '\0', malloc_trace_size());
+	t->site = (struct trace_site *)(t + 1);
+	t->entry = (struct trace_entry *)(t->site + (1 << TRACE_SITE_BITS));
+	t->owner[0].name = "other";
+	t->owners = 1;
+	trace = t;
+}
+
+static uint trace_hash(ulong key, uint bits)
+{
+	return ((u32)(key >> 2) * 0x9e3779b1) >> (32 - bits);
+}
+
+static u32 trace_now(void)
+{
+	if (!trace->busy) {
+		trace->busy = true;
+		trace->now = get_timer(0);
+		trace->busy = false;
+	}
+
+	return trace->now;
+}
+
+static u8 trace_owner_get(const char *name, int kind)
+{
+	struct trace_owner *o;
+	uint i;
+
+	if (!name)
+		return 0;
+	for (i = 1; i < trace->owners; i++) {
+		o = &trace->owner[i];
+		if (o->kind == kind && (o->name == name ||
+					!strcmp(o->name, name)))
+			return i;
+	}
+	if (trace->owners == TRACE_OWNERS)
+		return 0;
+	o = &trace->owner[trace->owners];
+	o->name = name;
+	o->kind = kind;
+
+	return trace->owners++;
+}
+
+static u16 trace_site_get(ulong addr, int kind, u8 owner)
+{
+	uint mask = (1 << TRACE_SITE_BITS) - 1;
+	uint h = trace_hash(addr, TRACE_SITE_BITS);
+	struct trace_site *s;
+	uint i, n;
+
+	for (n = 0; n < TRACE_PROBES; n++) {
+		i = (h + n) & mask;
+		if (!i)
+			continue;
+		s = &trace->site[i];
+		if (s->addr == addr && s->kind == kind)
+			return i;
+		if (!s->addr) {
+			s->addr = addr;
+			s->kind = kind;
+			s->owner = owner;
+			return i;
+		}
+	}
+
+	return 0;
+}
+
+static void trace_add(ulong key, ulong size, ulong site, u8 owner)
+{
+	uint mask = (1 << TRACE_ENTRY_BITS) - 1;
+	int kind = key & 1;
+	struct trace_entry *e;
+	struct trace_owner *o;
+	struct trace_site *s;
+	uint i;
+
+	/* keep the table at most 3/4 full for short probes */
+	if (trace->entries >= (mask + 1) / 4 * 3) {
+		trace->untracked++;
+		return;
+	}
+	for (i = trace_hash(key, TRACE_ENTRY_BITS); trace->entry[i].key;
+	     i = (i + 1) & mask)
+		;
+	e = &trace->entry[i];
+	e->key = key;
+	e->size = size;
+	e->birth = trace_now();
+	e->owner = owner;
+	e->site = trace_site_get(site, kind, owner);
+	trace->entries++;
+
+	s = &trace->site[e->site];
+	s->allocs++;
+	s->live += size;
+	s->peak = max(s->peak, s->live);
+	o = &trace->owner[owner];
+	o->allocs++;
+	o->live += size;
+	o->peak = max(o->peak, o->live);
+	trace->live[kind] += size;
+	trace->peak[kind] = max(trace->peak[kind], trace->live[kind]);
+}
+
+static void trace_del(ulong key)
+{
+	uint mask = (1 << TRACE_ENTRY_BITS) - 1;
+	struct trace_entry *e;
+	struct trace_site *s;
+	uint i, j, home;
+
+	for (i = trace_hash(key, TRACE_ENTRY_BITS); trace->entry[i].key != key;
+	     i = (i + 1) & mask) {
+		if (!trace->entry[i].key)
+			return;		/* allocated before tracing started */
+	}
+	e = &trace->entry[i];
+	s = &trace->site[e->site];
+	s->frees++;
+	s->live -= e->size;
+	s->life += trace_now() - e->birth;
+	trace->owner[e->owner].live -= e->size;
+	trace->live[key & 1] -= e->size;
+	trace->entries--;
+
+	/* move up the entries which would no longer be found past the hole */
+	for (j = (i + 1) & mask; trace->entry[j].key; j = (j + 1) & mask) {
+		home = trace_hash(trace->entry[j].key, TRACE_ENTRY_BITS);
+		if (((j - home) & mask) >= ((j - i) & mask)) {
+			trace->entry[i] = trace->entry[j];
+			i = j;
+		}
+	}
+	trace->entry[i].key = 0;
+}
+
+void malloc_trace_alloc(const void *ptr, ulong size, const void *site)
+{
+	if (trace && ptr)
+		trace_add((ulong)ptr | TRACE_HEAP, size, (ulong)site,
+			  trace->cur);
+}
+
+void malloc_trace_free(const void *ptr)
+{
+	if (trace && ptr)
+		trace_del((ulong)ptr | TRACE_HEAP);
+}
+
+void malloc_trace_sysmem_alloc(const char *name, ulong base, ulong size,
+			       const void *site)
+{
+	if (trace)
+		trace_add(base | TRACE_SYSMEM, size, (ulong)site,
+			  trace_owner_get(name, TRACE_SYSMEM));
+}
+
+void malloc_trace_sysmem_free(ulong base)
+{
+	if (trace)
+		trace_del(base | TRACE_SYSMEM);
+}
+
+const char *malloc_trace_owner(const char *name)
+{
+	const char *prev;
+
+	if (!trace)
+		return NULL;
+	prev = trace->cur_name;
+	trace->cur_name = name;
+	trace->cur = trace_owner_get(name, TRACE_HEAP);
+
+	return prev;
+}
+
+/* Insert @i into @idx, kept sorted by decreasing @val, of at most @top */
+static int trace_top(uint *idx, ulong *val, int count, int top, uint i,
+		     ulong v)
+{
+	int n;
+
+	if (count == top && v <= val[count - 1])
+		return count;
+	if (count < top)
+		count++;
+	for (n = count - 1; n && val[n - 1] < v; n--) {
+		idx[n] = idx[n - 1];
+		val[n] = val[n - 1];
+	}
+	idx[n] = i;
+	val[n] = v;
+
+	return count;
+}
+
+void malloc_trace_show(int top)
+{
+	uint idx[TRACE_TOP];
+	ulong val[TRACE_TOP];
+	struct trace_owner *o;
+	struct trace_site *s;
+	int count, kind, n;
+	uint i;
+
+	if (!trace) {
+		printf("trace: not running\n");
+		return;
+	}
+	top = clamp(top, 1, TRACE_TOP);
+	printf("trace: %u allocations live, %lu untracked\n", trace->entries,
+	       trace->untracked);
+	for (kind = 0; kind < TRACE_KINDS; kind++)
+		printf("%-7s %10lu bytes live, peak %lu\n",
+		       trace_kind[kind], trace->live[kind], trace->peak[kind]);
+
+	/* owners by high-water mark */
+	for (i = 0, count = 0; i < trace->owners; i++)
+		count = trace_top(idx, val, count, top, i,
+				  trace->owner[i].peak);
+	printf("\n%-16s %-6s %8s %10s %10s\n", "owner", "kind", "allocs",
+	       "live", "peak");
+	for (n = 0; n < count; n++) {
+		o = &trace->owner[idx[n]];
+		printf("%-16s %-6s %8lu %10lu %10lu\n", o->name,
+		       trace_kind[o->kind], o->allocs, o->live, o->peak);
+	}
+
+	/* call sites by memory held */
+	for (i = 0, count = 0; i < 1 << TRACE_SITE_BITS; i++) {
+		s = &trace->site[i];
+		if (s->allocs)
+			count = trace_top(idx, val, count, top, i, s->live);
+	}
+	printf("\n%-10s %-10s %-6s %7s %7s %10s %10s %8s  %s\n", "site",
+	       "reloc", "kind", "allocs", "frees", "live", "peak", "life ms",
+	       "owner");
+	for (n = 0; n < count; n++) {
+		s = &trace->site[idx[n]];
+		if (idx[n])
+			printf("%08lx   %08lx   ", s->addr,
+			       s->addr - gd->reloc_off);
+		else
+			printf("%-10s %-10s ", "other", "");
+		printf("%-6s %7lu %7lu %10lu %10lu %8lu  %s\n",
+		       idx[n] ? trace_kind[s->kind] : "-", s->allocs,
+		       s->frees, s->live, s->peak,
+		       s->frees ? s->life / s->frees : 0,
+		       trace->owner[s->owner].name);
+	}
+}
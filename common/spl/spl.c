@@ -210,6 +210,48 @@ int spl_parse_image_header(struct spl_image_info *spl_image,
 	return 0;
 }
 
+#if CONFIG_IS_ENABLED(DCACHE)
+#if CONFIG_SPL_STACK_R_MALLOC_SIMPLE_LEN < 0x10000
+#error "SPL_DCACHE takes its page tables from SPL_STACK_R_MALLOC_SIMPLE_LEN"
+#endif
+
+/*
+ * Identity map the memory map of the SoC, with page tables from the heap,
+ * and turn the caches on
+ */
+static void spl_dcache_enable(void)
+{
+	gd->arch.tlb_size = PGTABLE_SIZE;
+	gd->arch.tlb_addr = (ulong)memalign(0x1000, gd->arch.tlb_size);
+	if (!gd->arch.tlb_addr) {
+		/* everything, LZ4 above all, runs several times slower */
+		printf("SPL: no %#lx bytes for page tables, D-cache stays off\n",
+		       gd->arch.tlb_size);
+		return;
+	}
+	gd->arch.tlb_fillptr = 0;
+
+	icache_enable();
+	dcache_enable();
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "spl_dcache");
+}
+
+/* Clean the data cache to memory and turn the MMU and caches off */
+static void spl_dcache_disable(void)
+{
+	if (!dcache_status())
+		return;
+
+	icache_disable();
+	invalidate_icache_all();
+	dcache_disable();
+	invalidate_dcache_all();
+}
+#else
+static inline void spl_dcache_enable(void) {}
+static inline void spl_dcache_disable(void) {}
+#endif
+
 __weak void __noreturn jump_to_image_no_args(struct spl_image_info *spl_image)
 {
 	typedef void __noreturn (*image_entry_noargs_t)(void);
@@ -432,6 +474,7 @@ void board_init_r(gd_t *dummy1, ulong dummy2)
 
 	debug(">>spl:board_init_r()\n");
 
+	spl_dcache_enable();
 	spl_initr_dm();
 
 	spl_set_bd();
@@ -478,14 +521,30 @@ void board_init_r(gd_t *dummy1, ulong dummy2)
 	spl_image.boot_device = BOOT_DEVICE_NONE;
 	board_boot_order(spl_boot_list);
 
+	bootstage_start(BOOTSTAGE_ID_ACCUM_SPL_LOAD, "spl_load");
 	if (boot_from_devices(&spl_image, spl_boot_list,
 			      ARRAY_SIZE(spl_boot_list))) {
 		puts("SPL: failed to boot from all boot devices\n");
 		hang();
 	}
+	bootstage_accum(BOOTSTAGE_ID_ACCUM_SPL_LOAD);
 
 	spl_perform_fixups(&spl_image);
 
+	/* stash before the switch below, ATF does not come back from it */
+#ifdef CONFIG_BOOTSTAGE_STASH
+	int ret;
+
+	bootstage_mark_name(BOOTSTAGE_ID_END_SPL, "end_spl");
+	ret = bootstage_stash((void *)CONFIG_BOOTSTAGE_STASH_ADDR,
+			      CONFIG_BOOTSTAGE_STASH_SIZE);
+	if (ret)
+		debug("Failed to stash bootstage: err=%d\n", ret);
+#endif
+
+	/* the next stages expect the caches off and everything in memory */
+	spl_dcache_disable();
+
 #ifdef CONFIG_CPU_V7M
 	spl_image.entry_point |= 0x1;
 #endif
@@ -521,17 +580,6 @@ void board_init_r(gd_t *dummy1, ulong dummy2)
 	      gd->malloc_ptr / 1024);
 #endif
 
-	debug("loaded - jumping to U-Boot...\n");
-#ifdef CONFIG_BOOTSTAGE_STASH
-	int ret;
-
-	bootstage_mark_name(BOOTSTAGE_ID_END_SPL, "end_spl");
-	ret = bootstage_stash((void *)CONFIG_BOOTSTAGE_STASH_ADDR,
-			      CONFIG_BOOTSTAGE_STASH_SIZE);
-	if (ret)
-		debug("Failed to stash bootstage: err=%d\n", ret);
-#endif
-
 	debug("loaded - jumping to U-Boot...\n");
 	spl_board_prepare_for_boot();
 	jump_to_image_no_args(&spl_image);
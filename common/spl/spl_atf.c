@@ -32,7 +32,8 @@ static struct bl31_params *bl2_to_bl31_params;
  * @return bl31 params structure pointer
  */
 static struct bl31_params *bl2_plat_get_bl31_params(uintptr_t bl32_entry,
-						    uintptr_t bl33_entry)
+						    uintptr_t bl33_entry,
+						    uintptr_t bl33_arg)
 {
 	struct entry_point_info *bl32_ep_info;
 	struct entry_point_info *bl33_ep_info;
@@ -75,8 +76,11 @@ bl33_setup:
 	SET_PARAM_HEAD(bl33_ep_info, ATF_PARAM_EP, ATF_VERSION_1,
 		       ATF_EP_NON_SECURE);
 
-	/* BL33 expects to receive the primary CPU MPID (through x0) */
-	bl33_ep_info->args.arg0 = 0xffff & read_mpidr();
+	/*
+	 * U-Boot expects to receive the primary CPU MPID (through x0), Linux
+	 * its device tree
+	 */
+	bl33_ep_info->args.arg0 = bl33_arg;
 	bl33_ep_info->pc = bl33_entry;
 	bl33_ep_info->spsr = SPSR_64(MODE_EL2, MODE_SP_ELX,
 				     DISABLE_ALL_EXECPTIONS);
@@ -96,12 +100,13 @@ static inline void raw_write_daif(unsigned int daif)
 typedef void (*atf_entry_t)(struct bl31_params *params, void *plat_params);
 
 void bl31_entry(uintptr_t bl31_entry, uintptr_t bl32_entry,
-		uintptr_t bl33_entry, uintptr_t fdt_addr)
+		uintptr_t bl33_entry, uintptr_t bl33_arg, uintptr_t fdt_addr)
 {
 	struct bl31_params *bl31_params;
 	atf_entry_t  atf_entry = (atf_entry_t)bl31_entry;
 
-	bl31_params = bl2_plat_get_bl31_params(bl32_entry, bl33_entry);
+	bl31_params = bl2_plat_get_bl31_params(bl32_entry, bl33_entry,
+					       bl33_arg);
 
 	raw_write_daif(SPSR_EXCEPTION_MASK);
 
@@ -164,7 +169,7 @@ uintptr_t spl_fit_images_get_entry(void *blob, int node)
 
 void spl_invoke_atf(struct spl_image_info *spl_image)
 {
-	uintptr_t bl32_entry, bl33_entry;
+	uintptr_t bl32_entry, bl33_entry, bl33_arg;
 	void *blob = spl_image->fdt_addr;
 	uintptr_t platform_param = (uintptr_t)blob;
 	int node;
@@ -184,14 +189,20 @@ void spl_invoke_atf(struct spl_image_info *spl_image)
 	/*
 	 * Find the U-Boot binary (in /fit-images) load addreess or
 	 * entry point (if different) and pass it as the BL3-3 entry
-	 * point.
-	 * This will need to be extended to support Falcon mode.
+	 * point. In Falcon mode the board has set up Linux as BL3-3
+	 * instead, which takes its device tree.
 	 */
-	node = spl_fit_images_find(blob, IH_OS_U_BOOT);
-	if (node >= 0)
-		bl33_entry = spl_fit_images_get_entry(blob, node);
-	else
+	if (spl_image->fdt_addr_bl33) {
 		bl33_entry = spl_image->entry_point_bl33;
+		bl33_arg = (uintptr_t)spl_image->fdt_addr_bl33;
+	} else {
+		node = spl_fit_images_find(blob, IH_OS_U_BOOT);
+		if (node >= 0)
+			bl33_entry = spl_fit_images_get_entry(blob, node);
+		else
+			bl33_entry = spl_image->entry_point_bl33;
+		bl33_arg = 0xffff & read_mpidr();
+	}
 
 	/*
 	 * If ATF_NO_PLATFORM_PARAM is set, we override the platform
@@ -207,5 +218,5 @@ void spl_invoke_atf(struct spl_image_info *spl_image)
 	 * using similar logic.
 	 */
 	bl31_entry(spl_image->entry_point, bl32_entry,
-		   bl33_entry, platform_param);
+		   bl33_entry, bl33_arg, platform_param);
 }
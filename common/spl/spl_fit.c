@@ -11,6 +11,11 @@
 #include <linux/libfdt.h>
 #include <spl.h>
 #include <malloc.h>
+#include <memalign.h>
+#include <mapmem.h>
+#include <lzma/LzmaTypes.h>
+#include <lzma/LzmaDec.h>
+#include <lzma/LzmaTools.h>
 
 #ifndef CONFIG_SYS_BOOTM_LEN
 #define CONFIG_SYS_BOOTM_LEN	(64 << 20)
@@ -142,6 +147,152 @@ static int get_aligned_image_size(struct spl_load_info *info, int data_size,
 	return (data_size + info->bl_len - 1) / info->bl_len;
 }
 
+static struct spl_fit_stats spl_fit_stats;
+
+const struct spl_fit_stats *spl_fit_get_stats(void)
+{
+	return &spl_fit_stats;
+}
+
+static ulong spl_fit_read(struct spl_load_info *info, ulong sector,
+			  ulong count, void *buf)
+{
+	ulong ret = info->read(info, sector, count, buf);
+
+	spl_fit_stats.read += ret * (info->filename ? 1 : info->bl_len);
+
+	return ret;
+}
+
+static void spl_fit_copy(void *dst, const void *src, size_t len)
+{
+	memmove(dst, src, len);
+	spl_fit_stats.copied += len;
+}
+
+/*
+ * Check whether the external data at byte @offset of the FIT can be read
+ * from the device straight to @load_addr. Whole blocks are read there, so
+ * they must land on an address aligned for DMA; a partial block before them
+ * goes through a bounce buffer.
+ */
+static bool spl_fit_can_read_direct(struct spl_load_info *info, ulong offset,
+				    ulong load_addr)
+{
+	ulong bl_len = info->filename ? 1 : info->bl_len;
+	ulong head = offset % bl_len;
+
+#if defined(CONFIG_ARCH_ROCKCHIP)
+	/* SRAM outside SDRAM may not be reachable by the device's DMA */
+	if ((load_addr < CONFIG_SYS_SDRAM_BASE) ||
+	    (load_addr >= CONFIG_SYS_SDRAM_BASE + SDRAM_MAX_SIZE))
+		return false;
+#endif
+	if (head)
+		load_addr += bl_len - head;
+
+	return !(load_addr & (ARCH_DMA_MINALIGN - 1));
+}
+
+/*
+ * Read @len bytes of external data at byte @offset of the FIT to @dst. Only
+ * the partial blocks at either end go through a bounce buffer, see
+ * spl_fit_can_read_direct().
+ */
+static int spl_fit_read_direct(struct spl_load_info *info, ulong sector,
+			       ulong offset, ulong len, void *dst)
+{
+	ulong bl_len = info->filename ? 1 : info->bl_len;
+	ALLOC_CACHE_ALIGN_BUFFER(u8, bounce, bl_len);
+	ulong head = offset % bl_len;
+	ulong count, part;
+
+	sector += offset / bl_len;
+	if (head) {
+		part = min(len, bl_len - head);
+		if (spl_fit_read(info, sector, 1, bounce) != 1)
+			return -EIO;
+		spl_fit_copy(dst, bounce + head, part);
+		sector++;
+		dst += part;
+		len -= part;
+	}
+
+	count = len / bl_len;
+	if (count) {
+		if (spl_fit_read(info, sector, count, dst) != count)
+			return -EIO;
+		sector += count;
+		dst += count * bl_len;
+		len -= count * bl_len;
+	}
+
+	if (len) {
+		if (spl_fit_read(info, sector, 1, bounce) != 1)
+			return -EIO;
+		spl_fit_copy(dst, bounce, len);
+	}
+
+	return 0;
+}
+
+/*
+ * Check whether SPL can decompress an image. gzip is only used for kernels
+ * booted straight from SPL, the other methods apply to any image.
+ */
+static bool spl_fit_can_decomp(uint8_t comp, uint8_t type)
+{
+	switch (comp) {
+	case IH_COMP_GZIP:
+		return IS_ENABLED(CONFIG_SPL_OS_BOOT) &&
+		       IS_ENABLED(CONFIG_SPL_GZIP) && type == IH_TYPE_KERNEL;
+	case IH_COMP_LZ4:
+		return IS_ENABLED(CONFIG_SPL_LZ4);
+	case IH_COMP_LZMA:
+		return IS_ENABLED(CONFIG_SPL_LZMA);
+	default:
+		return false;
+	}
+}
+
+/*
+ * Decompress @*lenp bytes at @src to @dst, which takes at most
+ * CONFIG_SYS_BOOTM_LEN bytes. On success @*lenp is set to the size of the
+ * decompressed data.
+ */
+static int spl_fit_decomp(uint8_t comp, void *dst, void *src, size_t *lenp)
+{
+	ulong start = timer_get_us();
+	size_t size = CONFIG_SYS_BOOTM_LEN;
+	int ret = -ENOSYS;
+
+	if (IS_ENABLED(CONFIG_SPL_GZIP) && comp == IH_COMP_GZIP) {
+		ulong len = *lenp;
+
+		ret = gunzip(dst, size, src, &len);
+		size = len;
+	} else if (IS_ENABLED(CONFIG_SPL_LZ4) && comp == IH_COMP_LZ4) {
+		ret = ulz4fn(src, *lenp, dst, &size);
+	} else if (IS_ENABLED(CONFIG_SPL_LZMA) && comp == IH_COMP_LZMA) {
+		SizeT len = size;
+
+		ret = lzmaBuffToBuffDecompress(dst, &len, src, *lenp);
+		size = len;
+	}
+	if (ret) {
+		printf("Uncompressing %s error %d\n",
+		       genimg_get_comp_name(comp), ret);
+		return -EIO;
+	}
+
+	spl_fit_stats.compressed += *lenp;
+	spl_fit_stats.decompressed += size;
+	spl_fit_stats.decomp_us += timer_get_us() - start;
+	*lenp = size;
+
+	return 0;
+}
+
 /**
  * spl_load_fit_image(): load the image described in a certain FIT node
  * @info:	points to information about the device to load data from
@@ -157,6 +308,11 @@ static int get_aligned_image_size(struct spl_load_info *info, int data_size,
  *		the image gets loaded to the address pointed to by the
  *		load_addr member in this struct.
  *
+ * External data is read straight to the load address where possible, see
+ * spl_fit_can_read_direct(). Otherwise it is read to a buffer and copied.
+ * Compressed data which SPL can decompress is read to CONFIG_SYS_LOAD_ADDR
+ * and decompressed from there to the load address.
+ *
  * Return:	0 on success or a negative error number.
  */
 static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
@@ -166,16 +322,17 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 	int offset;
 	size_t length;
 	int len;
-	ulong size;
 	ulong load_addr, load_ptr;
-	void *src;
+	void *src, *dst;
 	ulong overhead;
 	int nr_sectors;
 	int align_len = ARCH_DMA_MINALIGN - 1;
 	uint8_t image_comp = -1, type = -1;
 	const void *data;
+	bool decomp;
 
-	if (IS_ENABLED(CONFIG_SPL_OS_BOOT) && IS_ENABLED(CONFIG_SPL_GZIP)) {
+	if ((IS_ENABLED(CONFIG_SPL_OS_BOOT) && IS_ENABLED(CONFIG_SPL_GZIP)) ||
+	    IS_ENABLED(CONFIG_SPL_LZ4) || IS_ENABLED(CONFIG_SPL_LZMA)) {
 		if (fit_image_get_comp(fit, node, &image_comp))
 			puts("Cannot get image compression format.\n");
 		else
@@ -186,6 +343,7 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 		else
 			debug("%s ", genimg_get_type_name(type));
 	}
+	decomp = spl_fit_can_decomp(image_comp, type);
 
 	if (fit_image_get_load(fit, node, &load_addr))
 		load_addr = image_info->load_addr;
@@ -195,26 +353,42 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 		offset += base_offset;
 		if (fit_image_get_data_size(fit, node, &len))
 			return -ENOENT;
+		length = len;
 
-		load_ptr = (load_addr + align_len) & ~align_len;
+		if (!decomp &&
+		    spl_fit_can_read_direct(info, offset, load_addr)) {
+			src = map_sysmem(load_addr, length);
+			if (spl_fit_read_direct(info, sector, offset, length,
+						src))
+				return -EIO;
+			debug("External data: direct to %lx, offset=%x, size=%lx\n",
+			      load_addr, offset, (unsigned long)length);
+			goto loaded;
+		}
+
+		if (decomp)
+			load_ptr = (CONFIG_SYS_LOAD_ADDR + align_len) &
+				   ~align_len;
+		else
+			load_ptr = (load_addr + align_len) & ~align_len;
 #if  defined(CONFIG_ARCH_ROCKCHIP)
 		if ((load_ptr < CONFIG_SYS_SDRAM_BASE) ||
 		     (load_ptr >= CONFIG_SYS_SDRAM_BASE + SDRAM_MAX_SIZE))
 			load_ptr = (ulong)memalign(ARCH_DMA_MINALIGN, len);
 #endif
-		length = len;
 
 		overhead = get_aligned_image_overhead(info, offset);
 		nr_sectors = get_aligned_image_size(info, length, offset);
 
-		if (info->read(info,
-			       sector + get_aligned_image_offset(info, offset),
-			       nr_sectors, (void *)load_ptr) != nr_sectors)
+		if (spl_fit_read(info,
+				 sector + get_aligned_image_offset(info, offset),
+				 nr_sectors, map_sysmem(load_ptr, length)) !=
+		    nr_sectors)
 			return -EIO;
 
 		debug("External data: dst=%lx, offset=%x, size=%lx\n",
 		      load_ptr, offset, (unsigned long)length);
-		src = (void *)load_ptr + overhead;
+		src = map_sysmem(load_ptr + overhead, length);
 	} else {
 		/* Embedded data */
 		if (fit_image_get_data(fit, node, &data, &length)) {
@@ -226,24 +400,19 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 		src = (void *)data;
 	}
 
+loaded:
 #ifdef CONFIG_SPL_FIT_IMAGE_POST_PROCESS
 	board_fit_image_post_process(&src, &length);
 #endif
 
-	if (IS_ENABLED(CONFIG_SPL_OS_BOOT)	&&
-	    IS_ENABLED(CONFIG_SPL_GZIP)		&&
-	    image_comp == IH_COMP_GZIP		&&
-	    type == IH_TYPE_KERNEL) {
-		size = length;
-		if (gunzip((void *)load_addr, CONFIG_SYS_BOOTM_LEN,
-			   src, &size)) {
-			puts("Uncompressing error\n");
+	dst = map_sysmem(load_addr, length);
+	if (decomp) {
+		if (spl_fit_decomp(image_comp, dst, src, &length))
 			return -EIO;
-		}
-		length = size;
-	} else {
-		memcpy((void *)load_addr, src, length);
+	} else if (src != dst) {
+		spl_fit_copy(dst, src, length);
 	}
+	spl_fit_stats.loaded += length;
 
 	if (image_info) {
 		image_info->load_addr = load_addr;
@@ -280,7 +449,7 @@ static int spl_fit_append_fdt(struct spl_image_info *spl_image,
 		return ret;
 
 	/* Make the load-address of the FDT available for the SPL framework */
-	spl_image->fdt_addr = (void *)image_info.load_addr;
+	spl_image->fdt_addr = map_sysmem(image_info.load_addr, 0);
 #if !CONFIG_IS_ENABLED(FIT_IMAGE_TINY)
 	/* Try to make space, so we can inject details on the loadables */
 	ret = fdt_shrink_to_minimum(spl_image->fdt_addr, 8192);
@@ -321,6 +490,13 @@ static int spl_fit_image_get_os(const void *fit, int noffset, uint8_t *os)
 #endif
 }
 
+__weak void *board_spl_fit_buffer(ulong size)
+{
+	int align_len = ARCH_DMA_MINALIGN - 1;
+
+	return (void *)((CONFIG_SYS_TEXT_BASE - size - align_len) & ~align_len);
+}
+
 int spl_load_simple_fit(struct spl_image_info *spl_image,
 			struct spl_load_info *info, ulong sector, void *fit)
 {
@@ -330,7 +506,7 @@ int spl_load_simple_fit(struct spl_image_info *spl_image,
 	struct spl_image_info image_info;
 	int node = -1;
 	int images, ret;
-	int base_offset, align_len = ARCH_DMA_MINALIGN - 1;
+	int base_offset;
 	int index = 0;
 
 	/*
@@ -359,10 +535,10 @@ int spl_load_simple_fit(struct spl_image_info *spl_image,
 	 * For FIT with data embedded, data is loaded as part of FIT image.
 	 * For FIT with external data, data is not loaded in this step.
 	 */
-	fit = (void *)((CONFIG_SYS_TEXT_BASE - size - info->bl_len -
-			align_len) & ~align_len);
+	memset(&spl_fit_stats, '\0', sizeof(spl_fit_stats));
+	fit = board_spl_fit_buffer(size + info->bl_len);
 	sectors = get_aligned_image_size(info, size, 0);
-	count = info->read(info, sector, sectors, fit);
+	count = spl_fit_read(info, sector, sectors, fit);
 	debug("fit read sector %lx, sectors=%d, dst=%p, count=%lu\n",
 	      sector, sectors, fit, count);
 	if (count == 0)
@@ -472,5 +648,10 @@ int spl_load_simple_fit(struct spl_image_info *spl_image,
 	if (spl_image->entry_point == FDT_ERROR || spl_image->entry_point == 0)
 		spl_image->entry_point = spl_image->load_addr;
 
+	if (spl_fit_stats.compressed)
+		printf("SPL: FIT decompressed %lu to %lu bytes in %lu us\n",
+		       spl_fit_stats.compressed, spl_fit_stats.decompressed,
+		       spl_fit_stats.decomp_us);
+
 	return 0;
 }
@@ -459,6 +459,42 @@ unsigned long blk_derase(struct blk_desc *block_dev, lbaint_t start,
 	return ops->erase(dev, start, blkcnt);
 }
 
+int blk_dmap(struct blk_desc *block_dev, lbaint_t start, lbaint_t blkcnt,
+	     void *buffer, struct blk_map *map)
+{
+	struct udevice *dev = block_dev->bdev;
+	const struct blk_ops *ops = blk_get_ops(dev);
+	ulong blks_read;
+	int ret;
+
+	map->blkcnt = blkcnt;
+	map->mapped = false;
+	if (ops->map) {
+		ret = ops->map(dev, start, blkcnt, &map->buf);
+		if (!ret)
+			map->mapped = true;
+		if (ret != -ENOSYS)
+			return ret;
+	}
+
+	blks_read = blk_dread(block_dev, start, blkcnt, buffer);
+	if (blks_read != blkcnt)
+		return IS_ERR_VALUE(blks_read) ? (int)blks_read : -EIO;
+	map->buf = buffer;
+
+	return 0;
+}
+
+void blk_dunmap(struct blk_desc *block_dev, struct blk_map *map)
+{
+	struct udevice *dev = block_dev->bdev;
+	const struct blk_ops *ops = blk_get_ops(dev);
+
+	if (map->mapped && ops->unmap)
+		ops->unmap(dev, map->buf, map->blkcnt);
+	map->mapped = false;
+}
+
 int blk_prepare_device(struct udevice *dev)
 {
 	struct blk_desc *desc = dev_get_uclass_platdata(dev);
@@ -88,6 +88,30 @@ static unsigned long host_block_write(struct blk_desc *block_dev,
 }
 
 #ifdef CONFIG_BLK
+/* the backing file is mapped, like a memory-mapped flash */
+static int host_block_map(struct udevice *dev, lbaint_t start,
+			  lbaint_t blkcnt, const void **bufp)
+{
+	struct host_block_dev *host_dev = dev_get_priv(dev);
+	struct blk_desc *block_dev = dev_get_uclass_platdata(dev);
+
+	if (start + blkcnt > block_dev->lba)
+		return -EINVAL;
+
+	*bufp = os_mmap_file(host_dev->fd, start * block_dev->blksz,
+			     blkcnt * block_dev->blksz);
+
+	return *bufp ? 0 : -ENOSYS;
+}
+
+static void host_block_unmap(struct udevice *dev, const void *buf,
+			     lbaint_t blkcnt)
+{
+	struct blk_desc *block_dev = dev_get_uclass_platdata(dev);
+
+	os_munmap_file(buf, blkcnt * block_dev->blksz);
+}
+
 int host_dev_bind(int devnum, char *filename)
 {
 	struct host_block_dev *host_dev;
@@ -221,6 +245,8 @@ int host_get_dev_err(int devnum, struct blk_desc **blk_devp)
 static const struct blk_ops sandbox_host_blk_ops = {
 	.read	= host_block_read,
 	.write	= host_block_write,
+	.map	= host_block_map,
+	.unmap	= host_block_unmap,
 };
 
 U_BOOT_DRIVER(sandbox_host_blk) = {
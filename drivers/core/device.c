@@ -15,6 +15,7 @@
 #include <fdtdec.h>
 #include <fdt_support.h>
 #include <malloc.h>
+#include <malloc_trace.h>
 #include <dm/device.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
@@ -35,6 +36,7 @@ static int device_bind_common(struct udevice *parent, const struct driver *drv,
 			      ulong driver_data, ofnode node,
 			      uint of_platdata_size, struct udevice **devp)
 {
+	const char *owner;
 	struct udevice *dev;
 	struct uclass *uc;
 	int size, ret = 0;
@@ -83,9 +85,13 @@ static int device_bind_common(struct udevice *parent, const struct driver *drv,
 		}
 	}
 #endif
+	/* charge what binding allocates to the uclass */
+	owner = malloc_trace_owner(uc->uc_drv->name);
 	dev = calloc(1, sizeof(struct udevice));
-	if (!dev)
+	if (!dev) {
+		malloc_trace_owner(owner);
 		return -ENOMEM;
+	}
 
 	INIT_LIST_HEAD(&dev->sibling_node);
 	INIT_LIST_HEAD(&dev->child_head);
@@ -201,6 +207,7 @@ static int device_bind_common(struct udevice *parent, const struct driver *drv,
 		*devp = dev;
 
 	dev->flags |= DM_FLAG_BOUND;
+	malloc_trace_owner(owner);
 
 	return 0;
 
@@ -243,6 +250,7 @@ fail_alloc1:
 	devres_release_all(dev);
 
 	free(dev);
+	malloc_trace_owner(owner);
 
 	return ret;
 }
@@ -328,16 +336,13 @@ static void *alloc_priv(int size, uint flags)
 	return priv;
 }
 
-int device_probe(struct udevice *dev)
+static int device_probe_common(struct udevice *dev)
 {
 	const struct driver *drv;
 	int size = 0;
 	int ret;
 	int seq;
 
-	if (!dev)
-		return -EINVAL;
-
 	if (dev->flags & DM_FLAG_ACTIVATED)
 		return 0;
 
@@ -455,6 +460,22 @@ fail:
 	return ret;
 }
 
+int device_probe(struct udevice *dev)
+{
+	const char *owner;
+	int ret;
+
+	if (!dev)
+		return -EINVAL;
+
+	/* charge what probing allocates to the uclass */
+	owner = malloc_trace_owner(dev->uclass->uc_drv->name);
+	ret = device_probe_common(dev);
+	malloc_trace_owner(owner);
+
+	return ret;
+}
+
 void *dev_get_platdata(struct udevice *dev)
 {
 	if (!dev) {
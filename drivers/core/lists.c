@@ -17,6 +17,9 @@
 #include <dm/util.h>
 #include <fdtdec.h>
 #include <linux/compiler.h>
+#include <linux/log2.h>
+
+DECLARE_GLOBAL_DATA_PTR;
 
 struct driver *lists_driver_lookup_name(const char *name)
 {
@@ -123,10 +126,98 @@ static int driver_check_compatible(const struct udevice_id *of_match,
 	return -ENOENT;
 }
 
-int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp)
+#if CONFIG_IS_ENABLED(DM_DRIVER_INDEX)
+/*
+ * The compatible strings of all drivers, hashed so that binding a node does
+ * not compare its strings with those of every driver. The table is built
+ * on first use after relocation, the few nodes bound before walk the list.
+ */
+struct lists_compat {
+	const char *compat;
+	struct driver *drv;
+	const struct udevice_id *id;
+};
+
+static struct lists_compat *lists_compat;
+static uint lists_compat_mask;
+
+static struct lists_compat *lists_compat_slot(const char *compat)
+{
+	struct lists_compat *c;
+	const char *p;
+	uint i = 5381;
+
+	for (p = compat; *p; p++)
+		i = i * 33 + *p;
+	for (;; i++) {
+		c = &lists_compat[i & lists_compat_mask];
+		if (!c->compat || !strcmp(c->compat, compat))
+			return c;
+	}
+}
+
+static int lists_compat_build(void)
 {
 	struct driver *driver = ll_entry_start(struct driver, driver);
 	const int n_ents = ll_entry_count(struct driver, driver);
+	const struct udevice_id *of_match;
+	struct lists_compat *c;
+	struct driver *entry;
+	uint count = 0;
+
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		for (of_match = entry->of_match; of_match && of_match->compatible;
+		     of_match++)
+			count++;
+	}
+	lists_compat_mask = roundup_pow_of_two(count * 2 + 1) - 1;
+	lists_compat = calloc(lists_compat_mask + 1, sizeof(*lists_compat));
+	if (!lists_compat)
+		return -ENOMEM;
+
+	/* the first driver with a string wins, as in a walk of the list */
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		for (of_match = entry->of_match; of_match && of_match->compatible;
+		     of_match++) {
+			c = lists_compat_slot(of_match->compatible);
+			if (!c->compat) {
+				c->compat = of_match->compatible;
+				c->drv = entry;
+				c->id = of_match;
+			}
+		}
+	}
+
+	return 0;
+}
+#endif
+
+struct driver *lists_driver_lookup_compat(const char *compat,
+					  const struct udevice_id **idp)
+{
+	struct driver *driver = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	struct driver *entry;
+
+#if CONFIG_IS_ENABLED(DM_DRIVER_INDEX)
+	if ((gd->flags & GD_FLG_RELOC) &&
+	    (lists_compat || !lists_compat_build())) {
+		struct lists_compat *c = lists_compat_slot(compat);
+
+		*idp = c->id;
+		return c->drv;
+	}
+#endif
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		if (!driver_check_compatible(entry->of_match, idp, compat))
+			return entry;
+	}
+
+	return NULL;
+}
+
+int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp)
+{
 	const struct udevice_id *id;
 	struct driver *entry;
 	struct udevice *dev;
@@ -163,14 +254,11 @@ int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp)
 		pr_debug("   - attempt to match compatible string '%s'\n",
 			 compat);
 
-		for (entry = driver; entry != driver + n_ents; entry++) {
-			ret = driver_check_compatible(entry->of_match, &id,
-						      compat);
-			if (!ret)
-				break;
-		}
-		if (entry == driver + n_ents)
+		entry = lists_driver_lookup_compat(compat, &id);
+		if (!entry) {
+			ret = -ENOENT;
 			continue;
+		}
 
 		pr_debug("   - found match at '%s'\n", entry->name);
 		ret = device_bind_with_driver_data(parent, entry, name,
@@ -26,6 +26,7 @@
 #include <linux/ctype.h>
 #include <linux/err.h>
 #include <linux/ioport.h>
+#include <linux/log2.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -363,10 +364,129 @@ struct device_node *of_find_node_opts_by_path(const char *path,
 	return np;
 }
 
+#if CONFIG_IS_ENABLED(OF_LIVE_INDEX)
+/**
+ * struct of_compat - nodes with a compatible string
+ *
+ * @compat:	Compatible string, NULL if the slot is free
+ * @count:	Number of nodes
+ * @nodes:	Nodes in tree order
+ */
+struct of_compat {
+	const char *compat;
+	uint count;
+	struct device_node **nodes;
+};
+
+/**
+ * struct of_index - lookup tables of a live tree
+ *
+ * @root:	Tree the tables were built for, they are only used while it is
+ *		gd->of_root
+ * @phandle_mask: Size of @phandle minus one
+ * @phandle:	Nodes with a phandle, hashed by phandle
+ * @compat_mask: Size of @compat minus one
+ * @compat:	Compatible strings, hashed case-insensitively
+ */
+struct of_index {
+	struct device_node *root;
+	uint phandle_mask;
+	struct device_node **phandle;
+	uint compat_mask;
+	struct of_compat *compat;
+};
+
+static struct of_index *of_index;
+
+static uint of_index_hash_str(const char *str)
+{
+	uint hash = 5381;
+
+	while (*str)
+		hash = hash * 33 + tolower(*str++);
+
+	return hash;
+}
+
+static uint of_index_hash_phandle(phandle handle)
+{
+	return handle * 0x9e3779b1;
+}
+
+static struct of_compat *of_index_compat(struct of_index *idx,
+					 const char *compat)
+{
+	uint i = of_index_hash_str(compat);
+	struct of_compat *c;
+
+	for (;; i++) {
+		c = &idx->compat[i & idx->compat_mask];
+		if (!c->compat || !of_compat_cmp(c->compat, compat, 0))
+			return c;
+	}
+}
+
+static struct of_index *of_index_get(void)
+{
+	if (!gd->of_root || !of_index || of_index->root != gd->of_root)
+		return NULL;
+
+	return of_index;
+}
+
+/* Search with the index, *@found is false if it cannot start at @from */
+static struct device_node *of_index_find_compatible(struct of_index *idx,
+		struct device_node *from, const char *type,
+		const char *compatible, bool *found)
+{
+	struct of_compat *c = of_index_compat(idx, compatible);
+	uint i = 0;
+
+	*found = true;
+	if (!c->compat)
+		return NULL;
+	if (from) {
+		for (; i < c->count && c->nodes[i] != from; i++)
+			;
+		/* @from is not compatible, fall back to a walk of the tree */
+		if (i == c->count) {
+			*found = false;
+			return NULL;
+		}
+		i++;
+	}
+	for (; i < c->count; i++) {
+		if (of_device_is_compatible(c->nodes[i], compatible, type,
+					    NULL) && of_node_get(c->nodes[i]))
+			return c->nodes[i];
+	}
+
+	return NULL;
+}
+#else
+static inline struct of_index *of_index_get(void)
+{
+	return NULL;
+}
+#endif
+
 struct device_node *of_find_compatible_node(struct device_node *from,
 		const char *type, const char *compatible)
 {
 	struct device_node *np;
+#if CONFIG_IS_ENABLED(OF_LIVE_INDEX)
+	struct of_index *idx = of_index_get();
+	bool found;
+
+	if (idx && compatible && *compatible) {
+		np = of_index_find_compatible(idx, from, type, compatible,
+					      &found);
+		if (found) {
+			of_node_put(from);
+			return np;
+		}
+	}
+#endif
 
 	for_each_of_allnodes_from(from, np)
 		if (of_device_is_compatible(np, compatible, type, NULL) &&
@@ -380,6 +500,21 @@ struct device_node *of_find_compatible_node(struct device_node *from,
 struct device_node *of_find_node_by_phandle(phandle handle)
 {
 	struct device_node *np;
+#if CONFIG_IS_ENABLED(OF_LIVE_INDEX)
+	struct of_index *idx = of_index_get();
+	uint i;
+
+	if (idx && handle) {
+		for (i = of_index_hash_phandle(handle);; i++) {
+			np = idx->phandle[i & idx->phandle_mask];
+			if (!np || np->phandle == handle)
+				break;
+		}
+		(void)of_node_get(np);
+
+		return np;
+	}
+#endif
 
 	if (!handle)
 		return NULL;
@@ -804,6 +939,93 @@ int of_alias_scan(void)
 	return 0;
 }
 
+#if CONFIG_IS_ENABLED(OF_LIVE_INDEX)
+int of_index_build(void)
+{
+	struct device_node *np, **nodes;
+	struct property *prop;
+	struct of_index *idx;
+	struct of_compat *c;
+	uint phandles = 0, compats = 0, size, i;
+	const char *cp;
+
+	/* count, to size the tables at most half full */
+	for_each_of_allnodes(np) {
+		if (np->phandle)
+			phandles++;
+		prop = of_find_property(np, "compatible", NULL);
+		for (cp = of_prop_next_string(prop, NULL); cp;
+		     cp = of_prop_next_string(prop, cp))
+			compats++;
+	}
+	idx = malloc(sizeof(*idx));
+	if (!idx)
+		return -ENOMEM;
+	idx->root = gd->of_root;
+	idx->phandle_mask = roundup_pow_of_two(phandles * 2 + 1) - 1;
+	idx->compat_mask = roundup_pow_of_two(compats * 2 + 1) - 1;
+	size = (idx->phandle_mask + 1) * sizeof(*idx->phandle) +
+	       (idx->compat_mask + 1) * sizeof(*idx->compat) +
+	       compats * sizeof(*nodes);
+	idx->phandle = calloc(1, size);
+	if (!idx->phandle) {
+		free(idx);
+		return -ENOMEM;
+	}
+	idx->compat = (struct of_compat *)(idx->phandle +
+					   idx->phandle_mask + 1);
+	nodes = (struct device_node **)(idx->compat + idx->compat_mask + 1);
+
+	/* count the nodes of each string, then give each a part of @nodes */
+	for_each_of_allnodes(np) {
+		if (np->phandle) {
+			for (i = of_index_hash_phandle(np->phandle);
+			     idx->phandle[i & idx->phandle_mask]; i++) {
+				/* the first node wins, as in a walk */
+				if (idx->phandle[i & idx->phandle_mask]->
+				    phandle == np->phandle)
+					break;
+			}
+			if (!idx->phandle[i & idx->phandle_mask])
+				idx->phandle[i & idx->phandle_mask] = np;
+		}
+		prop = of_find_property(np, "compatible", NULL);
+		for (cp = of_prop_next_string(prop, NULL); cp;
+		     cp = of_prop_next_string(prop, cp)) {
+			c = of_index_compat(idx, cp);
+			c->compat = cp;
+			c->count++;
+		}
+	}
+	for (i = 0; i <= idx->compat_mask; i++) {
+		c = &idx->compat[i];
+		c->nodes = nodes;
+		nodes += c->count;
+		c->count = 0;
+	}
+	for_each_of_allnodes(np) {
+		prop = of_find_property(np, "compatible", NULL);
+		for (cp = of_prop_next_string(prop, NULL); cp;
+		     cp = of_prop_next_string(prop, cp)) {
+			c = of_index_compat(idx, cp);
+			/* a string may be repeated in the list */
+			if (!c->count || c->nodes[c->count - 1] != np)
+				c->nodes[c->count++] = np;
+		}
+	}
+
+	if (of_index) {
+		free(of_index->phandle);
+		free(of_index);
+	}
+	of_index = idx;
+	debug("%s: %u phandles, %u compatible strings\n", __func__, phandles,
+	      compats);
+
+	return 0;
+}
+#endif
+
 int of_alias_get_id(const struct device_node *np, const char *stem)
 {
 	struct alias_prop *app;
@@ -0,0 +1,204 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:     GPL-2.0+
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <errno.h>
+#include <video.h>
+#include <power/charge_anim.h>
+
+static int charge_anim_load(struct charge_anim *anim, int idx)
+{
+	struct charge_anim_frame *frame = &anim->frames[idx];
+	int ret;
+
+	if (anim->loaded & BIT(idx))
+		return 0;
+
+	ret = anim->read(anim, anim->buf + frame->offset, frame->offset,
+			 frame->size);
+	if (ret) {
+		printf("%s: read frame %d failed: %d\n", __func__, idx, ret);
+		return ret;
+	}
+	anim->loaded |= BIT(idx);
+
+	return 0;
+}
+
+int charge_anim_parse(struct charge_anim *anim, ulong buf_size)
+{
+	struct charge_anim_header *hdr = anim->buf;
+	const char *name = anim->name;
+	struct charge_anim_frame *frame;
+	struct video_surface surface;
+	ulong table_end;
+	int i, ret;
+
+	if (memcmp(hdr->magic, CHARGE_ANIM_MAGIC, sizeof(hdr->magic)) ||
+	    le16_to_cpu(hdr->version) != CHARGE_ANIM_VERSION) {
+		printf("%s: %s: bad header\n", __func__, name);
+		return -EINVAL;
+	}
+
+	hdr->frame_num = le16_to_cpu(hdr->frame_num);
+	hdr->width = le16_to_cpu(hdr->width);
+	hdr->height = le16_to_cpu(hdr->height);
+	hdr->size = le32_to_cpu(hdr->size);
+	table_end = sizeof(*hdr) + hdr->frame_num * sizeof(*frame);
+	if (!hdr->frame_num || hdr->frame_num > CHARGE_ANIM_MAX_FRAMES ||
+	    table_end > CHARGE_ANIM_ALIGN) {
+		printf("%s: %s: bad frame number %d\n", __func__, name,
+		       hdr->frame_num);
+		return -EINVAL;
+	}
+
+	/* block reads may run up to the end of the last block */
+	if (ALIGN(hdr->size, CHARGE_ANIM_ALIGN) > buf_size) {
+		printf("%s: %s: %u bytes do not fit in %lu\n", __func__, name,
+		       hdr->size, buf_size);
+		return -ENOSPC;
+	}
+
+	anim->hdr = hdr;
+	anim->frames = anim->buf + sizeof(*hdr);
+	for (i = 0; i < hdr->frame_num; i++) {
+		frame = &anim->frames[i];
+		frame->offset = le32_to_cpu(frame->offset);
+		frame->size = le32_to_cpu(frame->size);
+		frame->flags = le16_to_cpu(frame->flags);
+		if (frame->offset < table_end ||
+		    frame->offset % CHARGE_ANIM_ALIGN ||
+		    frame->offset + frame->size > hdr->size ||
+		    (!i && !(frame->flags & CHARGE_ANIM_FRAME_KEY))) {
+			printf("%s: %s: bad frame %d\n", __func__, name, i);
+			return -EINVAL;
+		}
+	}
+
+	ret = uclass_first_device_err(UCLASS_VIDEO, &anim->video);
+	if (ret)
+		return ret;
+
+	video_get_surface(anim->video, &surface);
+	if (surface.xsize != hdr->width || surface.ysize != hdr->height ||
+	    surface.bytes_pp != hdr->bytes_pp) {
+		printf("%s: %s: %dx%dx%d does not match display %dx%dx%d\n",
+		       __func__, name, hdr->width, hdr->height, hdr->bytes_pp,
+		       surface.xsize, surface.ysize, surface.bytes_pp);
+		return -EINVAL;
+	}
+
+	debug("%s: %s: %d frames, %u bytes\n", __func__, name,
+	      hdr->frame_num, hdr->size);
+
+	return 0;
+}
+
+int charge_anim_apply(const struct video_surface *dst, const void *data,
+		      ulong size, int *y0, int *y1)
+{
+	const void *end = data + size;
+	const struct charge_anim_run *run;
+	uint x, y, len, bytes;
+
+	while (data + sizeof(*run) <= end) {
+		run = data;
+		len = le16_to_cpu(run->len);
+		if (!len)
+			return 0;
+
+		x = le16_to_cpu(run->x);
+		y = le16_to_cpu(run->y);
+		bytes = len * dst->bytes_pp;
+		data += sizeof(*run);
+		if (x + len > dst->xsize || y >= dst->ysize ||
+		    data + bytes > end)
+			return -EINVAL;
+
+		memcpy(dst->base + y * dst->line_length + x * dst->bytes_pp,
+		       data, bytes);
+		if (y < *y0)
+			*y0 = y;
+		if (y + 1 > *y1)
+			*y1 = y + 1;
+		data += ALIGN(bytes, 4);
+	}
+
+	/* missing terminator */
+	return -EINVAL;
+}
+
+int charge_anim_show(struct charge_anim *anim, int idx)
+{
+	struct charge_anim_frame *frame;
+	struct video_surface surface;
+	int y0, y1, start, i, ret;
+	ulong fb_start, fb_end;
+
+	if (!anim->hdr || idx < 0 || idx >= anim->hdr->frame_num)
+		return -EINVAL;
+
+	if (idx == anim->cur)
+		return 0;
+
+	/* a delta only applies on top of the previous frame */
+	start = idx;
+	if (idx != anim->cur + 1 || anim->cur < 0) {
+		while (!(anim->frames[start].flags & CHARGE_ANIM_FRAME_KEY))
+			start--;
+	}
+
+	video_get_surface(anim->video, &surface);
+	y0 = surface.ysize;
+	y1 = 0;
+	anim->cur = -1;
+	for (i = start; i <= idx; i++) {
+		ret = charge_anim_load(anim, i);
+		if (ret)
+			return ret;
+
+		frame = &anim->frames[i];
+		ret = charge_anim_apply(&surface, anim->buf + frame->offset,
+					frame->size, &y0, &y1);
+		if (ret) {
+			printf("%s: frame %d is corrupted\n", __func__, i);
+			return ret;
+		}
+	}
+	anim->cur = idx;
+
+	if (y0 < y1) {
+		fb_start = (ulong)surface.base + y0 * surface.line_length;
+		fb_end = (ulong)surface.base + y1 * surface.line_length;
+		flush_dcache_range(fb_start & ~(CONFIG_SYS_CACHELINE_SIZE - 1),
+				   ALIGN(fb_end, CONFIG_SYS_CACHELINE_SIZE));
+	}
+	debug("%s: frame %d from %d, rows %d-%d\n", __func__, idx, start,
+	      y0, y1);
+
+	return 0;
+}
+
+int charge_anim_prefetch(struct charge_anim *anim)
+{
+	int num, i, n, ret;
+
+	if (!anim->hdr)
+		return 0;
+
+	num = anim->hdr->frame_num;
+	for (n = 1; n <= num; n++) {
+		i = (anim->cur + n) % num;
+		if (anim->loaded & BIT(i))
+			continue;
+
+		ret = charge_anim_load(anim, i);
+		return ret ? ret : 1;
+	}
+
+	return 0;
+}
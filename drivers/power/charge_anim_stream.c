@@ -0,0 +1,66 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:     GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <fs.h>
+#ifdef CONFIG_ROCKCHIP_RESOURCE_IMAGE
+#include <asm/arch/resource_img.h>
+#endif
+#include <power/charge_anim.h>
+
+static int charge_anim_read(struct charge_anim *anim, void *buf,
+			    ulong offset, ulong len)
+{
+#if defined(CONFIG_PLATFORM_ODROID_GOADV)
+	loff_t actread;
+	int ret;
+
+	/* same place "fatload mmc 1:1" takes the battery bitmaps from */
+	ret = fs_set_blk_dev("mmc", "1:1", FS_TYPE_FAT);
+	if (ret)
+		return -ENODEV;
+
+	ret = fs_read(anim->name, (ulong)buf, offset, len, &actread);
+	if (ret)
+		return -ENOENT;
+
+	return actread == len ? 0 : -EIO;
+#elif defined(CONFIG_ROCKCHIP_RESOURCE_IMAGE)
+	int ret;
+
+	/* offset is always CHARGE_ANIM_ALIGN aligned, i.e. whole blocks */
+	ret = rockchip_read_resource_file(buf, anim->name, offset / 512, len);
+	if (ret < 0)
+		return ret;
+
+	return ret == len ? 0 : -EIO;
+#else
+	return -ENOSYS;
+#endif
+}
+
+int charge_anim_open(struct charge_anim *anim, const char *name,
+		     void *buf, ulong buf_size)
+{
+	int ret;
+
+	memset(anim, 0, sizeof(*anim));
+	anim->name = name;
+	anim->buf = buf;
+	anim->cur = -1;
+	anim->read = charge_anim_read;
+
+	if (buf_size < CHARGE_ANIM_ALIGN)
+		return -ENOSPC;
+
+	/* header and frame table always fit in the first block */
+	ret = charge_anim_read(anim, buf, 0, CHARGE_ANIM_ALIGN);
+	if (ret)
+		return ret;
+
+	return charge_anim_parse(anim, buf_size);
+}
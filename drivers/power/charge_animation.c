@@ -31,8 +31,12 @@
 #endif
 #if defined(CONFIG_PLATFORM_ODROID_GOADV)
 #include <rockchip_display_cmds.h>
+#include <video_rockchip.h>
 #include <blk.h>
 #endif
+#ifdef CONFIG_CHARGE_ANIMATION_STREAM
+#include <power/charge_anim.h>
+#endif
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -90,6 +94,13 @@ static const char *image_sf[] = {
 	"st_battery_3",
 	"st_battery_fail",
 };
+
+#ifdef CONFIG_CHARGE_ANIMATION_STREAM
+/* all of 'image[]' in one container, frame n is image[n] */
+#define CHARGE_ANIM_FILE			"battery.anim"
+
+static struct charge_anim anim;
+#endif
 #else
 static const struct charge_image image[] = {
 	{ .name = "battery_0.bmp", .soc = 5, .period = 600 },
@@ -309,6 +320,57 @@ static void autowakeup_timer_uninit(void)
 #if defined(CONFIG_PLATFORM_ODROID_GOADV)
 extern unsigned char disp_offs;
 static int bmp_dev;
+
+#ifdef CONFIG_CHARGE_ANIMATION_STREAM
+static void charge_anim_init(int image_num)
+{
+	int ret;
+
+	/* the container takes the place of the bitmap load buffer */
+	ret = charge_anim_open(&anim, CHARGE_ANIM_FILE,
+			       (void *)lcd_get_mem(), LCD_LOGO_SIZE);
+	if (!ret && anim.hdr->frame_num != image_num) {
+		printf("%s: %d frames, expect %d\n", CHARGE_ANIM_FILE,
+		       anim.hdr->frame_num, image_num);
+		ret = -EINVAL;
+	}
+	if (ret) {
+		debug("%s: use bitmaps, ret=%d\n", __func__, ret);
+		anim.hdr = NULL;
+	}
+}
+
+static int charge_anim_draw(int idx)
+{
+	int ret;
+
+	if (!anim.hdr)
+		return -ENOENT;
+
+	ret = charge_anim_show(&anim, idx);
+	if (ret) {
+		/* bitmaps reuse the buffer, don't come back */
+		printf("%s: fall back to bitmaps, ret=%d\n", __func__, ret);
+		anim.hdr = NULL;
+	}
+
+	return ret;
+}
+
+/*
+ * Text drawn over a frame stays in the frame buffer, as the next frame only
+ * updates the pixels it changes: draw the next frame whole
+ */
+static void charge_anim_forget(void)
+{
+	charge_anim_invalidate(&anim);
+}
+#else
+static inline void charge_anim_init(int image_num) {}
+static inline int charge_anim_draw(int idx) { return -ENOSYS; }
+static inline void charge_anim_forget(void) {}
+#endif
+
 static void charge_show_bmp(int idx, struct udevice *fg)
 {
 	unsigned long bmp_mem, bmp_copy;
@@ -318,6 +380,7 @@ static void charge_show_bmp(int idx, struct udevice *fg)
 	char cmd[64];
 	int soc;
 	int hundreds, tens, units;
+	static int level_soc = -1;
 	if (!fg)
 		return;
 
@@ -327,6 +390,18 @@ static void charge_show_bmp(int idx, struct udevice *fg)
      printk(KERN_WARNING "L%d->%s()\n",__LINE__,__FUNCTION__);
 	debug("charge_show_bmp idx %d, name %s, battery %d\n", idx, image[idx].name, battery);
 
+	/*
+	 * The level is printed over every frame, which puts back what a frame
+	 * changed under the digits. Only when it changes would old digits be
+	 * left over, so then the picture is drawn whole.
+	 */
+	if (soc != level_soc) {
+		charge_anim_forget();
+		level_soc = soc;
+	}
+	if (!charge_anim_draw(idx))
+		goto show_level;
+
 	/* draw logo bmp */
 	bmp_mem = lcd_get_mem();
 	bmp_copy = bmp_mem + LCD_LOGO_SIZE;
@@ -364,6 +439,7 @@ static void charge_show_bmp(int idx, struct udevice *fg)
 	if (show_bmp(bmp_mem))
 		printf("[%s] show_bmp fail\n", __func__);
 
+show_level:
 	/* show battery voltage level */
 	sprintf(cmd, "battery : %d.%d V", (battery / 1000), ((battery % 1000) / 100));
 	lcd_setfg_color("grey");
@@ -523,6 +599,7 @@ static int charge_extrem_low_power(struct udevice *dev)
 
 			lcd_printf(0, 15 + disp_offs, 1, "Extreme Low Battery, please wait until changed to 5%");
 			lcd_printf(0, 16 + disp_offs, 1, " LCD will be off soon.");
+			charge_anim_forget();
 		}
 
 		if ((get_timer(disp_start) > 5000) && screen_on) {
@@ -599,8 +676,10 @@ static int charge_animation_show(struct udevice *dev)
 	}
 
 #if defined(CONFIG_PLATFORM_ODROID_GOADV)
-	/* lcd initialization */
+	/* lcd initialization, charging never polls a panel powering up */
 	lcd_init();
+	rockchip_display_wait();
+	charge_anim_init(image_num);
 #endif
 
 	/* Extrem low power charge */
@@ -847,6 +926,11 @@ show_images:
 			system_suspend_enter(dev);
 		}
 
+#ifdef CONFIG_CHARGE_ANIMATION_STREAM
+		/* Read ahead the next frames while this one is shown */
+		if (screen_on && anim.hdr)
+			charge_anim_prefetch(&anim);
+#endif
 		mdelay(5);
 
 		/* Every image shows period */
@@ -144,6 +144,7 @@ int rksfc_nand_read(struct udevice *udev, u32 index, u32 count, void *buf)
 	int ret;
 
 	ret = sftl_read(index, count, (u8 *)buf);
+	sfc_nand_read_end();
 	if (!ret)
 		return count;
 	else
@@ -177,6 +178,7 @@ int rksfc_nand_vendor_read(struct blk_desc *dev_desc,
 	int ret;
 
 	ret = sftl_vendor_read(sec, n_sec, (u8 *)p_data);
+	sfc_nand_read_end();
 	if (!ret)
 		return n_sec;
 	else
@@ -210,6 +212,7 @@ int rknand_flash_read(struct udevice *udev, u32 index, u32 count, void *buf)
 	int ret;
 
 	ret = sftl_read(index, count, (u8 *)buf);
+	sfc_nand_read_end();
 	if (!ret)
 		return count;
 	else
@@ -243,6 +246,7 @@ int rknand_flash_vendor_read(struct blk_desc *dev_desc,
 	int ret;
 
 	ret = sftl_vendor_read(sec, n_sec, (u8 *)p_data);
+	sfc_nand_read_end();
 	if (!ret)
 		return n_sec;
 	else
@@ -68,6 +68,35 @@ ulong rkflash_berase(struct udevice *udev, lbaint_t start,
 	return (ulong)priv->erase(udev->parent, (u32)start, (u32)blkcnt);
 }
 
+int rkflash_bmap(struct udevice *udev, lbaint_t start, lbaint_t blkcnt,
+		 const void **bufp)
+{
+	struct blk_desc *block_dev = dev_get_uclass_platdata(udev);
+	struct rkflash_info *priv = dev_get_priv(udev->parent);
+	int ret;
+
+	if (blkcnt == 0)
+		return -EINVAL;
+
+	if ((start + blkcnt) > block_dev->lba)
+		return -EINVAL;
+
+	/* blk_dmap() then reads the blocks through rkflash_bread() */
+	if (!priv->map)
+		return -ENOSYS;
+
+	ret = priv->map(udev->parent, (u32)start, (u32)blkcnt, bufp);
+	if (ret)
+		return ret;
+
+	/* the window may hold lines from before the last write or erase */
+	invalidate_dcache_range((ulong)*bufp & ~(ARCH_DMA_MINALIGN - 1),
+				ALIGN((ulong)*bufp + blkcnt * 512,
+				      ARCH_DMA_MINALIGN));
+
+	return 0;
+}
+
 static int rkflash_blk_probe(struct udevice *udev)
 {
 	struct rkflash_info *priv = dev_get_priv(udev->parent);
@@ -110,6 +139,7 @@ static const struct blk_ops rkflash_blk_ops = {
 	.read	= rkflash_bread,
 	.write	= rkflash_bwrite,
 	.erase	= rkflash_berase,
+	.map	= rkflash_bmap,
 };
 
 U_BOOT_DRIVER(rkflash_blk) = {
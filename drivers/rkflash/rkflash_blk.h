@@ -43,6 +43,10 @@ struct flash_operation {
 			    u32 start,
 			    u32 blkcnt,
 			    void *buffer);
+	int (*flash_map)(struct udevice *udev,
+			 u32 start,
+			 u32 blkcnt,
+			 const void **bufp);
 };
 
 struct rkflash_dev {
@@ -92,6 +96,18 @@ struct rkflash_info {
 	int (*erase)(struct udevice *udev,
 		     u32 start,
 		     u32 blkcnt);
+	/*
+	 * map() - map blocks of a memory-mapped flash for reading in place
+	 *
+	 * @start:	Start block number to map (0=first)
+	 * @blkcnt:	Number of blocks to map
+	 * @bufp:	Returns the address of block @start
+	 * @return 0 is OK, -ENOSYS if the flash is not memory-mapped.
+	 */
+	int (*map)(struct udevice *udev,
+		   u32 start,
+		   u32 blkcnt,
+		   const void **bufp);
 };
 
 struct rkflash_uclass_priv {
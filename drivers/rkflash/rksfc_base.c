@@ -50,6 +50,14 @@ static struct flash_operation *spi_flash_op[2] = {
 	&sfc_nand_op,
 };
 
+void rksfc_print_stats(void)
+{
+	sfc_print_stats();
+#ifdef CONFIG_RKSFC_NAND
+	sfc_nand_print_stats();
+#endif
+}
+
 int rksfc_scan_namespace(void)
 {
 	struct uclass *uc;
@@ -121,6 +129,7 @@ static int rockchip_rksfc_probe(struct udevice *udev)
 				spi_flash_op[i]->flash_get_capacity(udev);
 			priv->read = spi_flash_op[i]->flash_read;
 			priv->write = spi_flash_op[i]->flash_write;
+			priv->map = spi_flash_op[i]->flash_map;
 #ifdef CONFIG_ROCKCHIP_VENDOR_PARTITION
 			flash_vendor_dev_ops_register(spi_flash_op[i]->vendor_read,
 						      spi_flash_op[i]->vendor_write);
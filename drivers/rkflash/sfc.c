@@ -7,11 +7,13 @@
 #include <common.h>
 #include <linux/delay.h>
 #include <bouncebuf.h>
+#include <div64.h>
 #include <asm/io.h>
 
 #include "sfc.h"
 
 static void __iomem *g_sfc_reg;
+static struct sfc_stats g_sfc_stats;
 
 static void sfc_reset(void)
 {
@@ -45,12 +47,39 @@ void sfc_clean_irq(void)
 	writel(0xFFFFFFFF, g_sfc_reg + SFC_IMR);
 }
 
+void sfc_get_stats(struct sfc_stats *stats)
+{
+	*stats = g_sfc_stats;
+}
+
+static void sfc_print_rate(const char *name, u32 xfers, u64 bytes, u64 us)
+{
+	u64 kbps = 0;
+
+	if (us) {
+		kbps = bytes * 1000;
+		do_div(kbps, us);
+	}
+	printf("%s: %u transfers, %llu bytes in %llu us, %llu KB/s\n",
+	       name, xfers, bytes, us, kbps);
+}
+
+void sfc_print_stats(void)
+{
+	struct sfc_stats *st = &g_sfc_stats;
+
+	sfc_print_rate("dma", st->dma_xfers, st->dma_bytes, st->dma_us);
+	printf("dma: %u transfers bounced\n", st->dma_bounced);
+	sfc_print_rate("pio", st->pio_xfers, st->pio_bytes, st->pio_us);
+}
+
 int sfc_request(u32 sfcmd, u32 sfctrl, u32 addr, void *data)
 {
 	int ret = SFC_OK;
 	union SFCCMD_DATA cmd;
 	int reg;
 	int timeout = 0;
+	ulong start;
 
 	reg = readl(g_sfc_reg + SFC_FSR);
 	if (!(reg & SFC_TXEMPTY) || !(reg & SFC_RXEMPTY) ||
@@ -76,6 +105,7 @@ int sfc_request(u32 sfcmd, u32 sfctrl, u32 addr, void *data)
 		writel(addr, g_sfc_reg + SFC_ADDR);
 	if (!cmd.b.datasize)
 		goto exit_wait;
+	start = timer_get_us();
 	if (SFC_ENABLE_DMA & sfctrl) {
 		struct bounce_buffer bb;
 		unsigned int bb_flags;
@@ -85,9 +115,12 @@ int sfc_request(u32 sfcmd, u32 sfctrl, u32 addr, void *data)
 		else
 			bb_flags = GEN_BB_WRITE;
 
+		/* only an unaligned buffer is copied, aligned ones are mapped */
 		ret = bounce_buffer_start(&bb, data, cmd.b.datasize, bb_flags);
 		if (ret)
 			return ret;
+		if (bb.bounce_buffer != bb.user_buffer)
+			g_sfc_stats.dma_bounced++;
 
 		writel(0xFFFFFFFF, g_sfc_reg + SFC_ICLR);
 		writel(~((u32)FINISH_INT), g_sfc_reg + SFC_IMR);
@@ -102,6 +135,9 @@ int sfc_request(u32 sfcmd, u32 sfctrl, u32 addr, void *data)
 		if (timeout <= 0)
 			ret = SFC_WAIT_TIMEOUT;
 		bounce_buffer_stop(&bb);
+		g_sfc_stats.dma_xfers++;
+		g_sfc_stats.dma_bytes += cmd.b.datasize;
+		g_sfc_stats.dma_us += timer_get_us() - start;
 	} else {
 		u32 i, words, count, bytes;
 		union SFCFSR_DATA    fifostat;
@@ -179,6 +215,9 @@ int sfc_request(u32 sfcmd, u32 sfctrl, u32 addr, void *data)
 				}
 			}
 		}
+		g_sfc_stats.pio_xfers++;
+		g_sfc_stats.pio_bytes += cmd.b.datasize;
+		g_sfc_stats.pio_us += timer_get_us() - start;
 	}
 
 exit_wait:
@@ -10,6 +10,8 @@
 #define SFC_VER_3		0x3 /* ver 3, else ver 1 */
 
 #define SFC_MAX_IOSIZE		(1024 * 8)    /* 8K byte */
+/* datasize is 14 bits wide, keep DMA transfers a whole number of sectors */
+#define SFC_MAX_DMA_IOSIZE	(1024 * 15)   /* 15K byte */
 #define SFC_EN_INT		(0)         /* enable interrupt */
 #define SFC_EN_DMA		(1)         /* enable dma */
 #define SFC_FIFO_DEPTH		(0x10)      /* 16 words */
@@ -168,10 +170,23 @@ union SFCCMD_DATA {
 	} b;
 };
 
+/* transfer counters, see sfc_print_stats() */
+struct sfc_stats {
+	u32 dma_xfers;
+	u32 dma_bounced;	/* DMA transfers through a bounce buffer */
+	u64 dma_bytes;
+	u64 dma_us;
+	u32 pio_xfers;
+	u64 pio_bytes;
+	u64 pio_us;
+};
+
 int sfc_init(void __iomem *reg_addr);
 int sfc_request(u32 sfcmd, u32 sfctrl, u32 addr, void *data);
 u16 sfc_get_version(void);
 void sfc_clean_irq(void);
+void sfc_get_stats(struct sfc_stats *stats);
+void sfc_print_stats(void);
 int rksfc_get_reg_addr(unsigned long *p_sfc_addr);
 
 #endif
@@ -5,6 +5,7 @@
  */
 
 #include <common.h>
+#include <div64.h>
 #include <linux/bug.h>
 #include <linux/delay.h>
 
@@ -26,7 +27,7 @@ static struct nand_info spi_nand_tbl[] = {
 	/* GD5F1GQ4UAYIG */
 	{0xC8F1, 4, 64, 1, 1024, 0x13, 0x10, 0x03, 0x02, 0x6B, 0x32, 0xD8, 0x0C, 18, 8, 0xB0, 0, 4, 8, NULL},
 	/* MT29F1G01ZAC */
-	{0x2C12, 4, 64, 1, 1024, 0x13, 0x10, 0x03, 0x02, 0x6B, 0x32, 0xD8, 0x00, 18, 1, 0xB0, 0, 4, 8, &sfc_nand_ecc_status_sp1},
+	{0x2C12, 4, 64, 1, 1024, 0x13, 0x10, 0x03, 0x02, 0x6B, 0x32, 0xD8, 0x80, 18, 1, 0xB0, 0, 4, 8, &sfc_nand_ecc_status_sp1},
 	/* GD5F2GQ40BY2GR */
 	{0xC8D2, 4, 64, 2, 1024, 0x13, 0x10, 0x03, 0x02, 0x6B, 0x32, 0xD8, 0x0C, 19, 8, 0xB0, 0, 4, 8, &sfc_nand_ecc_status_sp3},
 	/* GD5F1GQ4U */
@@ -85,6 +86,29 @@ static u8 id_byte[8];
 static struct nand_info *p_nand_info;
 static u32 gp_page_buf[SFC_NAND_PAGE_MAX_SIZE / 4];
 static struct SFNAND_DEV sfc_nand_dev;
+static struct sfc_nand_stats sfc_nand_stats;
+
+/* page loading into the data register by a sequential cache read */
+#define SFC_NAND_NO_SEQ		0xFFFFFFFF
+static u32 seq_next_page = SFC_NAND_NO_SEQ;
+
+#if CONFIG_RKSFC_NAND_PAGE_CACHE_NUM > 0
+#define SFC_NAND_CACHE_PAGES	CONFIG_RKSFC_NAND_PAGE_CACHE_NUM
+
+/*
+ * Pages read without ECC trouble are kept here, as the FTL reads its map
+ * and other metadata pages again and again.
+ */
+struct sfc_nand_cache_page {
+	u32 addr;		/* SFC_NAND_NO_SEQ if unused */
+	u32 age;
+	u32 spare[4];
+	u32 data[8 * 512 / 4];
+};
+
+static struct sfc_nand_cache_page page_cache[SFC_NAND_CACHE_PAGES];
+static u32 page_cache_age;
+#endif
 
 static struct nand_info *spi_nand_get_info(u8 *nand_id)
 {
@@ -416,12 +440,130 @@ u32 sfc_nand_ecc_status_sp5(void)
 	return ret;
 }
 
+static int sfc_nand_cache_read_cmd(u8 cmd)
+{
+	union SFCCMD_DATA sfcmd;
+
+	sfcmd.d32 = 0;
+	sfcmd.b.cmd = cmd;
+
+	return sfc_request(sfcmd.d32, 0, 0, NULL);
+}
+
+/* Take the flash out of sequential cache read, before any other command */
+void sfc_nand_read_end(void)
+{
+	u8 status;
+
+	if (seq_next_page == SFC_NAND_NO_SEQ)
+		return;
+
+	seq_next_page = SFC_NAND_NO_SEQ;
+	sfc_nand_cache_read_cmd(CMD_READ_CACHE_END);
+	sfc_nand_wait_busy(&status, 1000 * 1000);
+}
+
+#if CONFIG_RKSFC_NAND_PAGE_CACHE_NUM > 0
+static void sfc_nand_cache_init(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(page_cache); i++)
+		page_cache[i].addr = SFC_NAND_NO_SEQ;
+}
+
+static bool sfc_nand_cache_get(u32 addr, u32 *p_data, u32 *p_spare)
+{
+	u32 data_size = p_nand_info->sec_per_page * 512;
+	u32 spare_size = p_nand_info->sec_per_page == 8 ? 16 : 8;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(page_cache); i++) {
+		if (page_cache[i].addr != addr)
+			continue;
+
+		memcpy(p_data, page_cache[i].data, data_size);
+		memcpy(p_spare, page_cache[i].spare, spare_size);
+		page_cache[i].age = ++page_cache_age;
+
+		return true;
+	}
+
+	return false;
+}
+
+static void sfc_nand_cache_put(u32 addr, u32 *p_data, u32 *p_spare)
+{
+	u32 data_size = p_nand_info->sec_per_page * 512;
+	u32 spare_size = p_nand_info->sec_per_page == 8 ? 16 : 8;
+	struct sfc_nand_cache_page *page = &page_cache[0];
+	int i;
+
+	/* replace the least recently used page */
+	for (i = 1; i < ARRAY_SIZE(page_cache); i++) {
+		if (page_cache[i].age < page->age)
+			page = &page_cache[i];
+	}
+
+	page->addr = addr;
+	page->age = ++page_cache_age;
+	memcpy(page->data, p_data, data_size);
+	memcpy(page->spare, p_spare, spare_size);
+}
+
+/* Drop the pages of [addr, addr + count) */
+static void sfc_nand_cache_drop(u32 addr, u32 count)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(page_cache); i++) {
+		if (page_cache[i].addr - addr < count) {
+			page_cache[i].addr = SFC_NAND_NO_SEQ;
+			page_cache[i].age = 0;
+		}
+	}
+}
+#else
+static inline void sfc_nand_cache_init(void) {}
+static inline bool sfc_nand_cache_get(u32 addr, u32 *p_data, u32 *p_spare)
+{
+	return false;
+}
+
+static inline void sfc_nand_cache_put(u32 addr, u32 *p_data, u32 *p_spare)
+{
+}
+
+static inline void sfc_nand_cache_drop(u32 addr, u32 count) {}
+#endif
+
+void sfc_nand_print_stats(void)
+{
+	struct sfc_nand_stats *st = &sfc_nand_stats;
+	u64 pps = 0;
+
+	if (st->us) {
+		pps = (u64)st->pages * 1000000;
+		do_div(pps, st->us);
+	}
+	printf("nand: %u pages read in %llu us, %llu pages/s\n",
+	       st->pages, st->us, pps);
+	printf("nand: %u by sequential cache read, %u page cache hits\n",
+	       st->seq_pages, st->cache_hits);
+	printf("nand: ecc %u corrected over threshold, %u failed\n",
+	       st->ecc_refresh, st->ecc_error);
+}
+
 static u32 sfc_nand_erase_block(u8 cs, u32 addr)
 {
 	int ret;
 	union SFCCMD_DATA sfcmd;
 	u8 status;
 
+	sfc_nand_read_end();
+	sfc_nand_cache_drop(addr - addr % p_nand_info->page_per_blk,
+			    p_nand_info->page_per_blk);
+
 	sfcmd.d32 = 0;
 	sfcmd.b.cmd = p_nand_info->block_erase_cmd;
 	sfcmd.b.addrbits = SFC_ADDR_24BITS;
@@ -448,6 +590,8 @@ static u32 sfc_nand_prog_page(u8 cs, u32 addr, u32 *p_data, u32 *p_spare)
 	u32 data_size = sec_per_page * 512;
 
 	PRINT_SFC_I("%s %x %x %x\n", __func__, addr, p_data[0], p_spare[0]);
+	sfc_nand_read_end();
+	sfc_nand_cache_drop(addr, 1);
 	memcpy(gp_page_buf, p_data, data_size);
 	ftl_memset(&gp_page_buf[data_size / 4], 0xff, sec_per_page * 16);
 	gp_page_buf[(data_size + spare_offs_1) / 4] = p_spare[0];
@@ -488,7 +632,7 @@ static u32 sfc_nand_prog_page(u8 cs, u32 addr, u32 *p_data, u32 *p_spare)
 	return ret;
 }
 
-static u32 sfc_nand_read_page(u8 cs, u32 addr, u32 *p_data, u32 *p_spare)
+static u32 sfc_nand_read_page_raw(u8 cs, u32 addr, u32 *p_data, u32 *p_spare)
 {
 	int ret;
 	u32 plane;
@@ -499,19 +643,46 @@ static u32 sfc_nand_read_page(u8 cs, u32 addr, u32 *p_data, u32 *p_spare)
 	u32 spare_offs_2 = p_nand_info->spare_offs_2;
 	u32 sec_per_page = p_nand_info->sec_per_page;
 	u32 data_size = sec_per_page * 512;
+	bool seq_hit = seq_next_page == addr;
+	bool seq_next;
+	u8 status;
+
+	/*
+	 * With a sequential cache read the next page of the block is loaded
+	 * into the data register while this one is read out of the cache.
+	 */
+	seq_next = IS_ENABLED(CONFIG_RKSFC_NAND_CACHE_READ) &&
+		   p_nand_info->feature & FEA_CACHE_READ &&
+		   p_nand_info->plane_per_die == 1 &&
+		   (addr + 1) % p_nand_info->page_per_blk;
 
 	PRINT_SFC_I("%s %x %x %x\n", __func__, addr, p_data[0], p_spare[0]);
-	sfcmd.d32 = 0;
-	sfcmd.b.cmd = p_nand_info->page_read_cmd;
-	sfcmd.b.datasize = 0;
-	sfcmd.b.addrbits = SFC_ADDR_24BITS;
-	sfc_request(sfcmd.d32, 0, addr, p_data);
+	if (seq_hit) {
+		/* the page is in the data register, move it to the cache */
+		seq_next_page = seq_next ? addr + 1 : SFC_NAND_NO_SEQ;
+		sfc_nand_cache_read_cmd(seq_next ? CMD_READ_CACHE_SEQ :
+				       CMD_READ_CACHE_END);
+		sfc_nand_stats.seq_pages++;
+	} else {
+		sfc_nand_read_end();
+		sfcmd.d32 = 0;
+		sfcmd.b.cmd = p_nand_info->page_read_cmd;
+		sfcmd.b.datasize = 0;
+		sfcmd.b.addrbits = SFC_ADDR_24BITS;
+		sfc_request(sfcmd.d32, 0, addr, p_data);
+	}
 
 	if (p_nand_info->ecc_status)
 		ecc_result = p_nand_info->ecc_status();
 	else
 		ecc_result = sfc_nand_ecc_status();
 
+	if (!seq_hit && seq_next) {
+		sfc_nand_cache_read_cmd(CMD_READ_CACHE_SEQ);
+		sfc_nand_wait_busy(&status, 1000 * 1000);
+		seq_next_page = addr + 1;
+	}
+
 	if (sfc_nand_dev.read_lines == DATA_LINES_X4 &&
 	    p_nand_info->feature & FEA_SOFT_QOP_BIT &&
 	    sfc_get_version() < SFC_VER_3)
@@ -547,6 +718,31 @@ static u32 sfc_nand_read_page(u8 cs, u32 addr, u32 *p_data, u32 *p_spare)
 	return ecc_result;
 }
 
+static u32 sfc_nand_read_page(u8 cs, u32 addr, u32 *p_data, u32 *p_spare)
+{
+	ulong start;
+	u32 ret;
+
+	if (sfc_nand_cache_get(addr, p_data, p_spare)) {
+		sfc_nand_stats.cache_hits++;
+		return SFC_NAND_ECC_OK;
+	}
+
+	start = timer_get_us();
+	ret = sfc_nand_read_page_raw(cs, addr, p_data, p_spare);
+	sfc_nand_stats.us += timer_get_us() - start;
+	sfc_nand_stats.pages++;
+
+	if (ret == SFC_NAND_ECC_OK)
+		sfc_nand_cache_put(addr, p_data, p_spare);
+	else if (ret == SFC_NAND_ECC_REFRESH)
+		sfc_nand_stats.ecc_refresh++;
+	else
+		sfc_nand_stats.ecc_error++;
+
+	return ret;
+}
+
 static int sfc_nand_read_id_raw(u8 *data)
 {
 	int ret;
@@ -778,6 +974,7 @@ u32 sfc_nand_init(void)
 		PRINT_SFC_I("page_read_cmd = %x\n", sfc_nand_dev.page_read_cmd);
 		PRINT_SFC_I("page_prog_cmd = %x\n", sfc_nand_dev.page_prog_cmd);
 	}
+	sfc_nand_cache_init();
 	ftl_flash_init();
 
 	#if SFC_NAND_STRESS_TEST_EN
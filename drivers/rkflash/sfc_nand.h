@@ -26,6 +26,7 @@
 #define FEA_4BYTE_ADDR          BIT(4)
 #define FEA_4BYTE_ADDR_MODE	BIT(5)
 #define FEA_SOFT_QOP_BIT	BIT(6)
+#define FEA_CACHE_READ		BIT(7)	/* READ CACHE SEQUENTIAL/END */
 
 #define MID_WINBOND             0xEF
 #define MID_GIGADEV             0xC8
@@ -73,6 +74,8 @@
 /* X1 cmd, X4 addr, X4 data, SUPPORT MARCONIX */
 #define CMD_PAGE_PROG_A4        (0x38)
 #define CMD_RESET_NAND          (0xFF)
+#define CMD_READ_CACHE_SEQ      (0x31)
+#define CMD_READ_CACHE_END      (0x3F)
 
 #define CMD_ENTER_4BYTE_MODE    (0xB7)
 #define CMD_EXIT_4BYTE_MODE     (0xE9)
@@ -119,12 +122,24 @@ struct nand_info {
 	u32 (*ecc_status)(void);
 };
 
+/* page read counters, see sfc_nand_print_stats() */
+struct sfc_nand_stats {
+	u32 pages;		/* pages read from the flash */
+	u32 seq_pages;		/* ... of which by a sequential cache read */
+	u32 cache_hits;		/* pages found in the page cache */
+	u32 ecc_refresh;	/* corrected, over the refresh threshold */
+	u32 ecc_error;		/* not correctable */
+	u64 us;			/* time spent reading from the flash */
+};
+
 extern struct nand_phy_info	g_nand_phy_info;
 extern struct nand_ops		g_nand_ops;
 
 u32 sfc_nand_init(void);
 void sfc_nand_deinit(void);
 int sfc_nand_read_id(u8 *buf);
+void sfc_nand_read_end(void);
+void sfc_nand_print_stats(void);
 u32 sfc_nand_ecc_status_sp1(void);
 u32 sfc_nand_ecc_status_sp2(void);
 u32 sfc_nand_ecc_status_sp3(void);
@@ -391,7 +391,8 @@ static int snor_set_dlines(struct SFNOR_DEV *p_dev, enum SFC_DATA_LINES lines)
 static int snor_read_data(struct SFNOR_DEV *p_dev,
 			  u32 addr,
 			  void *p_data,
-			  u32 size)
+			  u32 size,
+			  u32 cont)
 {
 	int ret;
 	union SFCCMD_DATA sfcmd;
@@ -404,8 +405,10 @@ static int snor_read_data(struct SFNOR_DEV *p_dev,
 
 	sfctrl.d32 = 0;
 	sfctrl.b.datalines = p_dev->read_lines;
-	if (!(size & 0x3) && size >= 4)
-		sfctrl.b.enbledma = 0;
+#ifdef CONFIG_RKSFC_NOR_DMA
+	if (snor_read_dma_ok(size))
+		sfctrl.b.enbledma = 1;
+#endif
 
 	if (p_dev->read_cmd == CMD_FAST_READ_X1 ||
 	    p_dev->read_cmd == CMD_FAST_READ_X4 ||
@@ -414,7 +417,12 @@ static int snor_read_data(struct SFNOR_DEV *p_dev,
 		sfcmd.b.dummybits = 8;
 	} else if (p_dev->read_cmd == CMD_FAST_READ_A4) {
 		sfcmd.b.addrbits = SFC_ADDR_32BITS;
-		addr = (addr << 8) | 0xFF;	/* Set M[7:0] = 0xFF */
+		if (cont & SNOR_CONT_STAY)
+			addr = (addr << 8) | SNOR_CONT_MODE_BITS;
+		else
+			addr = (addr << 8) | 0xFF;	/* Set M[7:0] = 0xFF */
+		if (cont & SNOR_CONT_SKIP_CMD)
+			sfcmd.b.readmode = 1;
 		sfcmd.b.dummybits = 4;
 		sfctrl.b.addrlines = SFC_4BITS_LINE;
 	}
@@ -430,21 +438,39 @@ static int snor_read_data(struct SFNOR_DEV *p_dev,
 int snor_read(struct SFNOR_DEV *p_dev, u32 sec, u32 n_sec, void *p_data)
 {
 	int ret = SFC_OK;
-	u32 addr, size, len;
+	u32 addr, size, len, max_len;
+	u32 cont = 0;
 	u8 *p_buf =  (u8 *)p_data;
 
 	if ((sec + n_sec) > p_dev->capacity)
 		return SFC_PARAM_ERR;
 
+#ifdef CONFIG_RKSFC_NOR_DMA
+	max_len = SFC_MAX_DMA_IOSIZE;
+#else
+	max_len = SFC_MAX_IOSIZE;
+#endif
+
 	mutex_lock(&p_dev->lock);
 	addr = sec << 9;
 	size = n_sec << 9;
 	while (size) {
-		len = size < SFC_MAX_IOSIZE ? size : SFC_MAX_IOSIZE;
-		ret = snor_read_data(p_dev, addr, p_buf, len);
+		len = snor_read_xfer(size, max_len, p_dev->cont_read, &cont);
+		ret = snor_read_data(p_dev, addr, p_buf, len, cont);
 		if (ret != SFC_OK) {
 			PRINT_SFC_E("snor_read_data %x ret= %x\n",
 				    addr >> 9, ret);
+			/*
+			 * The chip was in continuous read mode, and the last
+			 * transfer may not have taken it out. Leave the mode
+			 * before any other cmd.
+			 */
+			if (cont & SNOR_CONT_SKIP_CMD) {
+				u32 dummy;
+
+				snor_read_data(p_dev, 0, &dummy, sizeof(dummy),
+					       SNOR_CONT_SKIP_CMD);
+			}
 			goto out;
 		}
 
@@ -547,6 +573,7 @@ static void snor_print_spi_chip_info(struct SFNOR_DEV *p_dev)
 	PRINT_SFC_I("read_lines: %x\n", p_dev->read_lines);
 	PRINT_SFC_I("prog_lines: %x\n", p_dev->prog_lines);
 	PRINT_SFC_I("read_cmd: %x\n", p_dev->read_cmd);
+	PRINT_SFC_I("cont_read: %x\n", p_dev->cont_read);
 	PRINT_SFC_I("prog_cmd: %x\n", p_dev->prog_cmd);
 	PRINT_SFC_I("blk_erase_cmd: %x\n", p_dev->blk_erase_cmd);
 	PRINT_SFC_I("sec_erase_cmd: %x\n", p_dev->sec_erase_cmd);
@@ -636,6 +663,19 @@ int snor_init(struct SFNOR_DEV *p_dev)
 		if (g_spi_flash_info->feature & FEA_4BYTE_ADDR)
 			p_dev->addr_mode = ADDR_MODE_4BYTE;
 
+#ifdef CONFIG_RKSFC_NOR_CONT_READ
+		/* quad output read -> quad I/O read with continuous mode */
+		if (p_dev->read_cmd == CMD_FAST_READ_X4 &&
+		    p_dev->addr_mode == ADDR_MODE_3BYTE &&
+		    (p_dev->manufacturer == MID_GIGADEV ||
+		     p_dev->manufacturer == MID_WINBOND ||
+		     p_dev->manufacturer == MID_MACRONIX ||
+		     p_dev->manufacturer == MID_XMC)) {
+			p_dev->read_cmd = CMD_FAST_READ_A4;
+			p_dev->cont_read = 1;
+		}
+#endif
+
 		if ((g_spi_flash_info->feature & FEA_4BYTE_ADDR_MODE))
 			snor_enter_4byte_mode();
 
@@ -118,6 +118,7 @@ struct SFNOR_DEV {
 	u8	sec_erase_cmd;
 	u8	blk_erase_cmd;
 	u8	QE_bits;
+	u8	cont_read;	/* quad I/O reads may use continuous read mode */
 
 	enum SNOR_READ_MODE  read_mode;
 	enum SNOR_ADDR_MODE  addr_mode;
@@ -149,6 +150,49 @@ struct flash_info {
 	u8 reserved2;
 };
 
+/*
+ * Continuous read mode of the quad I/O read (0xEB): a mode byte of 0xA5 after
+ * the address keeps the chip in the mode, so the next read is sent without
+ * the command byte. Any other mode byte makes it leave the mode again.
+ */
+#define SNOR_CONT_SKIP_CMD	BIT(0)	/* chip is in continuous read mode */
+#define SNOR_CONT_STAY		BIT(1)	/* keep it there after this read */
+#define SNOR_CONT_MODE_BITS	0xA5
+
+/**
+ * snor_read_xfer() - Split off the next transfer of a read
+ *
+ * Only the last transfer takes the chip out of continuous read mode, and
+ * every transfer but the first one is sent without the command byte.
+ *
+ * @size:	Bytes left to read
+ * @max_len:	Largest transfer
+ * @cont_read:	The chip uses continuous read mode
+ * @cont:	SNOR_CONT_xxx flags of the previous transfer, 0 before the
+ *		first one. Updated with the flags of this transfer
+ * @return size of this transfer in bytes
+ */
+static inline u32 snor_read_xfer(u32 size, u32 max_len, u8 cont_read,
+				 u32 *cont)
+{
+	u32 len = size < max_len ? size : max_len;
+
+	if (*cont & SNOR_CONT_STAY)
+		*cont |= SNOR_CONT_SKIP_CMD;
+	if (cont_read && len < size)
+		*cont |= SNOR_CONT_STAY;
+	else
+		*cont &= ~SNOR_CONT_STAY;
+
+	return len;
+}
+
+/* The SFC DMA moves whole words only, anything else goes through the FIFO */
+static inline bool snor_read_dma_ok(u32 size)
+{
+	return size >= 4 && !(size & 0x3);
+}
+
 int snor_init(struct SFNOR_DEV *p_dev);
 u32 snor_get_capacity(struct SFNOR_DEV *p_dev);
 int snor_read(struct SFNOR_DEV *p_dev, u32 sec, u32 n_sec, void *p_data);
@@ -20,78 +20,31 @@
 
 static int console_normal_set_row(struct udevice *dev, uint row, int clr)
 {
-	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
-	void *line;
-	int pixels = VIDEO_FONT_HEIGHT * vid_priv->xsize;
-	int i;
-
-	line = vid_priv->fb + row * VIDEO_FONT_HEIGHT * vid_priv->line_length;
-	switch (vid_priv->bpix) {
-#ifdef CONFIG_VIDEO_BPP8
-	case VIDEO_BPP8: {
-		uint8_t *dst = line;
-
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
-	}
-#endif
-#ifdef CONFIG_VIDEO_BPP16
-	case VIDEO_BPP16: {
-		uint16_t *dst = line;
+	struct udevice *vid = dev->parent;
+	struct video_surface surface;
 
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
-	}
-#endif
-#ifdef CONFIG_VIDEO_BPP32
-	case VIDEO_BPP32: {
+	video_get_surface(vid, &surface);
 #if defined(CONFIG_PLATFORM_ODROID_GOADV)
-		struct lcd_fb_bit *dst = line, *bg = lcd_getbg();
-		struct video_fb_bit *c = (struct video_fb_bit *)&clr;
-		if (!lcd_gettransp()) {
-			for (i = 0; i < pixels; i++, dst++) {
-				if (bg == NULL) {
-					dst->r = c->r;
-					dst->g = c->g;
-					dst->b = c->b;
-				} else {
-					dst->r = bg->r;
-					dst->g = bg->g;
-					dst->b = bg->b;
-				}
-			}
-		}
-		break;
-#else
-		uint32_t *dst = line;
-
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
+	if (lcd_gettransp())
+		return 0;
+	clr = lcd_bg_colour(clr);
 #endif
-	}
-#endif
-	default:
-		return -ENOSYS;
-	}
 
-	return 0;
+	return video_fill_rect(vid, &surface, 0, row * VIDEO_FONT_HEIGHT,
+			       surface.xsize, VIDEO_FONT_HEIGHT, clr);
 }
 
 static int console_normal_move_rows(struct udevice *dev, uint rowdst,
 				     uint rowsrc, uint count)
 {
-	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
-	void *dst;
-	void *src;
+	struct udevice *vid = dev->parent;
+	struct video_surface surface;
 
-	dst = vid_priv->fb + rowdst * VIDEO_FONT_HEIGHT * vid_priv->line_length;
-	src = vid_priv->fb + rowsrc * VIDEO_FONT_HEIGHT * vid_priv->line_length;
-	memmove(dst, src, VIDEO_FONT_HEIGHT * vid_priv->line_length * count);
+	video_get_surface(vid, &surface);
 
-	return 0;
+	return video_copy_rect(vid, &surface, 0, rowdst * VIDEO_FONT_HEIGHT,
+			       &surface, 0, rowsrc * VIDEO_FONT_HEIGHT,
+			       surface.xsize, count * VIDEO_FONT_HEIGHT);
 }
 /*
 static int console_normal_putc_xy(struct udevice *dev, uint x_frac, uint y,
@@ -18,100 +18,35 @@
 
 static int console_set_row_1(struct udevice *dev, uint row, int clr)
 {
-	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
-#if defined(CONFIG_PLATFORM_ODROID_GOADV)
-	int pbytes = 3;
-#else
-	int pbytes = VNBYTES(vid_priv->bpix);
-#endif
-	void *line;
-	int i, j;
-
-	line = vid_priv->fb + vid_priv->line_length -
-		(row + 1) * VIDEO_FONT_HEIGHT * pbytes;
-	for (j = 0; j < vid_priv->ysize; j++) {
-		switch (vid_priv->bpix) {
-#ifdef CONFIG_VIDEO_BPP8
-		case VIDEO_BPP8: {
-			uint8_t *dst = line;
-
-			for (i = 0; i < VIDEO_FONT_HEIGHT; i++)
-				*dst++ = clr;
-			break;
-		}
-#endif
-#ifdef CONFIG_VIDEO_BPP16
-		case VIDEO_BPP16: {
-			uint16_t *dst = line;
+	struct udevice *vid = dev->parent;
+	struct video_surface surface;
 
-			for (i = 0; i < VIDEO_FONT_HEIGHT; i++)
-				*dst++ = clr;
-			break;
-		}
-#endif
-#ifdef CONFIG_VIDEO_BPP32
-		case VIDEO_BPP32: {
+	video_get_surface(vid, &surface);
 #if defined(CONFIG_PLATFORM_ODROID_GOADV)
-			struct lcd_fb_bit *dst = line, *bg = lcd_getbg();
-			struct video_fb_bit *c = (struct video_fb_bit *)&clr;
-
-			if (!lcd_gettransp()) {
-				for (i = 0; i < VIDEO_FONT_HEIGHT; i++, dst++) {
-					if (bg == NULL) {
-						dst->r = c->r;
-						dst->g = c->g;
-						dst->b = c->b;
-					} else {
-						dst->r = bg->r;
-						dst->g = bg->g;
-						dst->b = bg->b;
-					}
-				}
-			}
-			break;
-#else
-			uint32_t *dst = line;
-
-			for (i = 0; i < VIDEO_FONT_HEIGHT; i++)
-				*dst++ = clr;
-			break;
-#endif
-		}
+	if (lcd_gettransp())
+		return 0;
+	clr = lcd_bg_colour(clr);
 #endif
-		default:
-			return -ENOSYS;
-		}
-		line += vid_priv->line_length;
-	}
 
-	return 0;
+	return video_fill_rect(vid, &surface,
+			       surface.xsize - (row + 1) * VIDEO_FONT_HEIGHT, 0,
+			       VIDEO_FONT_HEIGHT, surface.ysize, clr);
 }
 
 static int console_move_rows_1(struct udevice *dev, uint rowdst, uint rowsrc,
 			       uint count)
 {
-	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
-	void *dst;
-	void *src;
-#if defined(CONFIG_PLATFORM_ODROID_GOADV)
-	int pbytes = 3;
-#else
-	int pbytes = VNBYTES(vid_priv->bpix);
-#endif
-	int j;
-
-	dst = vid_priv->fb + vid_priv->line_length -
-		(rowdst + count) * VIDEO_FONT_HEIGHT * pbytes;
-	src = vid_priv->fb + vid_priv->line_length -
-		(rowsrc + count) * VIDEO_FONT_HEIGHT * pbytes;
+	struct udevice *vid = dev->parent;
+	struct video_surface surface;
 
-	for (j = 0; j < vid_priv->ysize; j++) {
-		memmove(dst, src, VIDEO_FONT_HEIGHT * pbytes * count);
-		src += vid_priv->line_length;
-		dst += vid_priv->line_length;
-	}
+	video_get_surface(vid, &surface);
 
-	return 0;
+	return video_copy_rect(vid, &surface,
+			       surface.xsize - (rowdst + count) *
+			       VIDEO_FONT_HEIGHT, 0, &surface,
+			       surface.xsize - (rowsrc + count) *
+			       VIDEO_FONT_HEIGHT, 0,
+			       count * VIDEO_FONT_HEIGHT, surface.ysize);
 }
 
 static int console_putc_xy_1(struct udevice *dev, uint x_frac, uint y, char ch)
@@ -220,84 +155,35 @@ static int console_putc_xy_1(struct udevice *dev, uint x_frac, uint y, char ch)
 
 static int console_set_row_2(struct udevice *dev, uint row, int clr)
 {
-	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
-	void *line;
-	int pixels = VIDEO_FONT_HEIGHT * vid_priv->xsize;
-	int i;
-
-	line = vid_priv->fb + vid_priv->ysize * vid_priv->line_length -
-		(row + 1) * VIDEO_FONT_HEIGHT * vid_priv->line_length;
-	switch (vid_priv->bpix) {
-#ifdef CONFIG_VIDEO_BPP8
-	case VIDEO_BPP8: {
-		uint8_t *dst = line;
-
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
-	}
-#endif
-#ifdef CONFIG_VIDEO_BPP16
-	case VIDEO_BPP16: {
-		uint16_t *dst = line;
+	struct udevice *vid = dev->parent;
+	struct video_surface surface;
 
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
-	}
-#endif
-#ifdef CONFIG_VIDEO_BPP32
-	case VIDEO_BPP32: {
+	video_get_surface(vid, &surface);
 #if defined(CONFIG_PLATFORM_ODROID_GOADV)
-		struct lcd_fb_bit *dst = line, *bg = lcd_getbg();
-		struct video_fb_bit *c = (struct video_fb_bit *)&clr;
-
-		if (!lcd_gettransp()) {
-			for (i = 0; i < pixels; i++, dst++) {
-				if (bg == NULL) {
-					dst->r = c->r;
-					dst->g = c->g;
-					dst->b = c->b;
-				} else {
-					dst->r = bg->r;
-					dst->g = bg->g;
-					dst->b = bg->b;
-				}
-			}
-		}
-		break;
-#else
-		uint32_t *dst = line;
-
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
-#endif
-	}
+	if (lcd_gettransp())
+		return 0;
+	clr = lcd_bg_colour(clr);
 #endif
-	default:
-		return -ENOSYS;
-	}
 
-	return 0;
+	return video_fill_rect(vid, &surface, 0,
+			       surface.ysize - (row + 1) * VIDEO_FONT_HEIGHT,
+			       surface.xsize, VIDEO_FONT_HEIGHT, clr);
 }
 
 static int console_move_rows_2(struct udevice *dev, uint rowdst, uint rowsrc,
 			       uint count)
 {
-	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
-	void *dst;
-	void *src;
-	void *end;
-
-	end = vid_priv->fb + vid_priv->ysize * vid_priv->line_length;
-	dst = end - (rowdst + count) * VIDEO_FONT_HEIGHT *
-		vid_priv->line_length;
-	src = end - (rowsrc + count) * VIDEO_FONT_HEIGHT *
-		vid_priv->line_length;
-	memmove(dst, src, VIDEO_FONT_HEIGHT * vid_priv->line_length * count);
+	struct udevice *vid = dev->parent;
+	struct video_surface surface;
 
-	return 0;
+	video_get_surface(vid, &surface);
+
+	return video_copy_rect(vid, &surface, 0,
+			       surface.ysize - (rowdst + count) *
+			       VIDEO_FONT_HEIGHT, &surface, 0,
+			       surface.ysize - (rowsrc + count) *
+			       VIDEO_FONT_HEIGHT,
+			       surface.xsize, count * VIDEO_FONT_HEIGHT);
 }
 
 static int console_putc_xy_2(struct udevice *dev, uint x_frac, uint y, char ch)
@@ -413,97 +299,31 @@ static int console_putc_xy_2(struct udevice *dev, uint x_frac, uint y, char ch)
 
 static int console_set_row_3(struct udevice *dev, uint row, int clr)
 {
-	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
-#if defined(CONFIG_PLATFORM_ODROID_GOADV)
-	int pbytes = 3;
-#else
-	int pbytes = VNBYTES(vid_priv->bpix);
-#endif
-	void *line;
-	int i, j;
-
-	line = vid_priv->fb + row * VIDEO_FONT_HEIGHT * pbytes;
-	for (j = 0; j < vid_priv->ysize; j++) {
-		switch (vid_priv->bpix) {
-#ifdef CONFIG_VIDEO_BPP8
-		case VIDEO_BPP8: {
-			uint8_t *dst = line;
-
-			for (i = 0; i < VIDEO_FONT_HEIGHT; i++)
-				*dst++ = clr;
-			break;
-		}
-#endif
-#ifdef CONFIG_VIDEO_BPP16
-		case VIDEO_BPP16: {
-			uint16_t *dst = line;
+	struct udevice *vid = dev->parent;
+	struct video_surface surface;
 
-			for (i = 0; i < VIDEO_FONT_HEIGHT; i++)
-				*dst++ = clr;
-			break;
-		}
-#endif
-#ifdef CONFIG_VIDEO_BPP32
-		case VIDEO_BPP32: {
+	video_get_surface(vid, &surface);
 #if defined(CONFIG_PLATFORM_ODROID_GOADV)
-			struct lcd_fb_bit *dst = line, *bg = lcd_getbg();
-			struct video_fb_bit *c = (struct video_fb_bit *)&clr;
-
-			if (!lcd_gettransp()) {
-				for (i = 0; i < VIDEO_FONT_HEIGHT; i++, dst++) {
-					if (bg == NULL) {
-						dst->r = c->r;
-						dst->g = c->g;
-						dst->b = c->b;
-					} else {
-						dst->r = bg->r;
-						dst->g = bg->g;
-						dst->b = bg->b;
-					}
-				}
-			}
-			break;
-#else
-			uint32_t *dst = line;
-
-			for (i = 0; i < VIDEO_FONT_HEIGHT; i++)
-				*dst++ = clr;
-			break;
-#endif
-		}
+	if (lcd_gettransp())
+		return 0;
+	clr = lcd_bg_colour(clr);
 #endif
-		default:
-			return -ENOSYS;
-		}
-		line += vid_priv->line_length;
-	}
 
-	return 0;
+	return video_fill_rect(vid, &surface, row * VIDEO_FONT_HEIGHT, 0,
+			       VIDEO_FONT_HEIGHT, surface.ysize, clr);
 }
 
 static int console_move_rows_3(struct udevice *dev, uint rowdst, uint rowsrc,
 			       uint count)
 {
-	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
-	void *dst;
-	void *src;
-#if defined(CONFIG_PLATFORM_ODROID_GOADV)
-	int pbytes = 3;
-#else
-	int pbytes = VNBYTES(vid_priv->bpix);
-#endif
-	int j;
-
-	dst = vid_priv->fb + rowdst * VIDEO_FONT_HEIGHT * pbytes;
-	src = vid_priv->fb + rowsrc * VIDEO_FONT_HEIGHT * pbytes;
+	struct udevice *vid = dev->parent;
+	struct video_surface surface;
 
-	for (j = 0; j < vid_priv->ysize; j++) {
-		memmove(dst, src, VIDEO_FONT_HEIGHT * pbytes * count);
-		src += vid_priv->line_length;
-		dst += vid_priv->line_length;
-	}
+	video_get_surface(vid, &surface);
 
-	return 0;
+	return video_copy_rect(vid, &surface, rowdst * VIDEO_FONT_HEIGHT, 0,
+			       &surface, rowsrc * VIDEO_FONT_HEIGHT, 0,
+			       count * VIDEO_FONT_HEIGHT, surface.ysize);
 }
 
 static int console_putc_xy_3(struct udevice *dev, uint x_frac, uint y, char ch)
@@ -124,60 +124,26 @@ struct console_tt_priv {
 
 static int console_truetype_set_row(struct udevice *dev, uint row, int clr)
 {
-	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
 	struct console_tt_priv *priv = dev_get_priv(dev);
-	void *line;
-	int pixels = priv->font_size * vid_priv->line_length;
-	int i;
-
-	line = vid_priv->fb + row * priv->font_size * vid_priv->line_length;
-	switch (vid_priv->bpix) {
-#ifdef CONFIG_VIDEO_BPP8
-	case VIDEO_BPP8: {
-		uint8_t *dst = line;
-
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
-	}
-#endif
-#ifdef CONFIG_VIDEO_BPP16
-	case VIDEO_BPP16: {
-		uint16_t *dst = line;
-
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
-	}
-#endif
-#ifdef CONFIG_VIDEO_BPP32
-	case VIDEO_BPP32: {
-		uint32_t *dst = line;
+	struct video_surface surface;
 
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
-	}
-#endif
-	default:
-		return -ENOSYS;
-	}
+	video_get_surface(dev->parent, &surface);
 
-	return 0;
+	return video_fill_rect(dev->parent, &surface, 0, row * priv->font_size,
+			       surface.xsize, priv->font_size, clr);
 }
 
 static int console_truetype_move_rows(struct udevice *dev, uint rowdst,
 				     uint rowsrc, uint count)
 {
-	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
 	struct console_tt_priv *priv = dev_get_priv(dev);
-	void *dst;
-	void *src;
+	struct video_surface surface;
 	int i, diff;
 
-	dst = vid_priv->fb + rowdst * priv->font_size * vid_priv->line_length;
-	src = vid_priv->fb + rowsrc * priv->font_size * vid_priv->line_length;
-	memmove(dst, src, priv->font_size * vid_priv->line_length * count);
+	video_get_surface(dev->parent, &surface);
+	video_copy_rect(dev->parent, &surface, 0, rowdst * priv->font_size,
+			&surface, 0, rowsrc * priv->font_size,
+			surface.xsize, count * priv->font_size);
 
 	/* Scroll up our position history */
 	diff = (rowsrc - rowdst) * priv->font_size;
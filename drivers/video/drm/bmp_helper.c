@@ -9,6 +9,7 @@
 #include <malloc.h>
 #include <asm/unaligned.h>
 #include <bmp_layout.h>
+#include <video.h>
 
 #define BMP_RLE8_ESCAPE		0
 #define BMP_RLE8_EOL		0
@@ -150,6 +151,7 @@ int bmpdecoder(void *bmp_addr, void *pdst, int dst_bpp)
 	bool flip = false;
 	uint16_t *cmap;
 	uint8_t *cmap_base;
+	struct video_surface src_surface, dst_surface;
 
 	//bmp->header.signature[0] = 'B';
 	//bmp->header.signature[1] = 'M';
@@ -227,16 +229,23 @@ int bmpdecoder(void *bmp_addr, void *pdst, int dst_bpp)
 		}
 		
 		stride = ALIGN(width * 3, 4);
-		if (flip)
-			src += stride * (height - 1);
-
-		for (i = 0; i < height; i++) {
-			memcpy(dst, src, 3 * width);
-			dst += stride;
-			src += stride;
-			if (flip)
-				src -= stride * 2;
+		src_surface.base = src;
+		src_surface.line_length = stride;
+		if (flip) {
+			/* bottom-up bitmap: walk the rows backwards */
+			src_surface.base = src + stride * (height - 1);
+			src_surface.line_length = -stride;
 		}
+		src_surface.xsize = width;
+		src_surface.ysize = height;
+		src_surface.bytes_pp = 3;
+
+		dst_surface = src_surface;
+		dst_surface.base = dst;
+		dst_surface.line_length = stride;
+
+		video_sw_copy_rect(&dst_surface, 0, 0, &src_surface, 0, 0,
+				   width, height);
 		break;
 	case 16:
 	case 32:
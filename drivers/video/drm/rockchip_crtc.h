@@ -17,6 +17,7 @@ struct rockchip_crtc_funcs {
 	int (*init)(struct display_state *state);
 	void (*deinit)(struct display_state *state);
 	int (*set_plane)(struct display_state *state);
+	int (*page_flip)(struct display_state *state, u32 dma_addr);
 	int (*prepare)(struct display_state *state);
 	int (*enable)(struct display_state *state);
 	int (*disable)(struct display_state *state);
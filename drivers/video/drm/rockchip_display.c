@@ -485,9 +485,16 @@ static int display_get_timing(struct display_state *state)
 	struct panel_state *panel_state = &state->panel_state;
 	const struct rockchip_panel *panel = panel_state->panel;
 
+	if (dev_of_valid(panel->dev) &&
+	    !display_cache_get_mode(state, mode)) {
+		printf("Using display timing from cache\n");
+		goto done;
+	}
+
 	if (dev_of_valid(panel->dev) &&
 	    !display_get_timing_from_dts(panel_state, mode)) {
 		printf("Using display timing dts\n");
+		display_cache_put_mode(state, mode);
 		goto done;
 	}
 
@@ -660,7 +667,37 @@ static int display_set_plane(struct display_state *state)
 	return 0;
 }
 
-static int display_enable(struct display_state *state)
+static int display_page_flip(struct display_state *state, u32 dma_addr)
+{
+	struct crtc_state *crtc_state = &state->crtc_state;
+	const struct rockchip_crtc *crtc = crtc_state->crtc;
+	const struct rockchip_crtc_funcs *crtc_funcs = crtc->funcs;
+
+	if (!state->is_init || !state->is_enable)
+		return -EINVAL;
+
+	/* both set crtc_state->dma_addr to where the VOP scans out from */
+	if (crtc_funcs->page_flip)
+		return crtc_funcs->page_flip(state, dma_addr);
+
+	crtc_state->dma_addr = dma_addr;
+
+	return display_set_plane(state);
+}
+
+enum display_seq {
+	DISPLAY_SEQ_IDLE,
+	DISPLAY_SEQ_PANEL_PREPARE,
+	DISPLAY_SEQ_PANEL_ENABLE,
+};
+
+/*
+ * Second half of display_enable(): everything from the panel power on
+ * sequence onwards. Returns -EAGAIN as long as the panel is still waiting
+ * for one of its power sequence delays. @blocking tells whether the caller
+ * is stalled on the display, for the boot time breakdown.
+ */
+static int display_enable_poll(struct display_state *state, bool blocking)
 {
 	struct connector_state *conn_state = &state->conn_state;
 	const struct rockchip_connector *conn = conn_state->connector;
@@ -669,15 +706,87 @@ static int display_enable(struct display_state *state)
 	const struct rockchip_crtc *crtc = crtc_state->crtc;
 	const struct rockchip_crtc_funcs *crtc_funcs = crtc->funcs;
 	struct panel_state *panel_state = &state->panel_state;
+	ulong start = timer_get_us();
+	ulong total;
+	int ret = 0;
+
+	switch (state->enable_seq) {
+	case DISPLAY_SEQ_PANEL_PREPARE:
+		ret = rockchip_panel_prepare_poll(panel_state->panel);
+		if (ret == -EAGAIN)
+			break;
+
+		if (crtc_funcs->enable)
+			crtc_funcs->enable(state);
+
+		if (conn_funcs->enable)
+			conn_funcs->enable(state);
+
+		if (conn_state->bridge)
+			rockchip_bridge_enable(conn_state->bridge);
+
+		state->enable_seq = DISPLAY_SEQ_PANEL_ENABLE;
+		/* fall through */
+	case DISPLAY_SEQ_PANEL_ENABLE:
+		ret = rockchip_panel_enable_poll(panel_state->panel);
+		if (ret == -EAGAIN)
+			break;
+
+		state->enable_seq = DISPLAY_SEQ_IDLE;
+		state->is_enable = true;
+		ret = 0;
+		break;
+	default:
+		return 0;
+	}
+
+	if (blocking)
+		state->enable_blocked += timer_get_us() - start;
+	else
+		state->enable_busy += timer_get_us() - start;
+
+	if (state->enable_seq == DISPLAY_SEQ_IDLE) {
+		total = timer_get_us() - state->enable_start;
+		bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "display_on");
+#ifdef CONFIG_DRM_ROCKCHIP_PANEL_ASYNC
+		printf("display: on in %lu ms (%lu ms busy, %lu ms blocked, %lu ms overlapped)\n",
+#else
+		debug("display: on in %lu ms (%lu ms busy, %lu ms blocked, %lu ms overlapped)\n",
+#endif
+		      total / 1000, state->enable_busy / 1000,
+		      state->enable_blocked / 1000,
+		      (total - state->enable_busy - state->enable_blocked) / 1000);
+	}
+
+	return ret;
+}
+
+/*
+ * First half of display_enable(): bring up the crtc and connector and start
+ * the panel power on sequence, which is then carried on by
+ * display_enable_poll().
+ */
+static int display_enable_start(struct display_state *state)
+{
+	struct connector_state *conn_state = &state->conn_state;
+	const struct rockchip_connector *conn = conn_state->connector;
+	const struct rockchip_connector_funcs *conn_funcs = conn->funcs;
+	struct crtc_state *crtc_state = &state->crtc_state;
+	const struct rockchip_crtc *crtc = crtc_state->crtc;
+	const struct rockchip_crtc_funcs *crtc_funcs = crtc->funcs;
+	ulong start;
 
 	display_init(state);
 
 	if (!state->is_init)
 		return -EINVAL;
 
-	if (state->is_enable)
+	if (state->is_enable || state->enable_seq)
 		return 0;
 
+	start = timer_get_us();
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "display_start");
+
 	if (crtc_funcs->prepare)
 		crtc_funcs->prepare(state);
 
@@ -687,22 +796,57 @@ static int display_enable(struct display_state *state)
 	if (conn_state->bridge)
 		rockchip_bridge_pre_enable(conn_state->bridge);
 
-	if (panel_state->panel)
-		rockchip_panel_prepare(panel_state->panel);
+	state->enable_seq = DISPLAY_SEQ_PANEL_PREPARE;
+	state->enable_start = start;
+	state->enable_busy = timer_get_us() - start;
+	state->enable_blocked = 0;
 
-	if (crtc_funcs->enable)
-		crtc_funcs->enable(state);
+	display_enable_poll(state, false);
 
-	if (conn_funcs->enable)
-		conn_funcs->enable(state);
+	return 0;
+}
 
-	if (conn_state->bridge)
-		rockchip_bridge_enable(conn_state->bridge);
+static void display_enable_wait(struct display_state *state)
+{
+	if (!state->enable_seq)
+		return;
 
-	if (panel_state->panel)
-		rockchip_panel_enable(panel_state->panel);
+	while (display_enable_poll(state, true) == -EAGAIN)
+		;
+}
+
+#ifdef CONFIG_DRM_ROCKCHIP_PANEL_ASYNC
+int rockchip_display_poll(void)
+{
+	struct display_state *s;
+	int ret = 0;
+
+	list_for_each_entry(s, &rockchip_display_list, head) {
+		if (display_enable_poll(s, false) == -EAGAIN)
+			ret = -EAGAIN;
+	}
+
+	return ret;
+}
+
+void rockchip_display_wait(void)
+{
+	struct display_state *s;
+
+	list_for_each_entry(s, &rockchip_display_list, head)
+		display_enable_wait(s);
+}
+#endif
+
+static int display_enable(struct display_state *state)
+{
+	int ret;
+
+	ret = display_enable_start(state);
+	if (ret)
+		return ret;
 
-	state->is_enable = true;
+	display_enable_wait(state);
 
 	return 0;
 }
@@ -720,6 +864,9 @@ static int display_disable(struct display_state *state)
 	if (!state->is_init)
 		return 0;
 
+	/* don't cut a panel power on sequence short */
+	display_enable_wait(state);
+
 	if (!state->is_enable)
 		return 0;
 
@@ -1458,6 +1605,7 @@ void rockchip_display_fixup(void *blob)
 	unsigned long bmp_mem;
 
 	if (fdt_node_offset_by_compatible(blob, 0, "rockchip,drm-logo") >= 0) {
+		lcd_set_dbuf(false);
 		list_for_each_entry(s, &rockchip_display_list, head) {
 				bmp_mem = get_drm_memory() + DRM_ROCKCHIP_FB_SIZE;
 				if (show_bmp(bmp_mem))
@@ -1575,6 +1723,10 @@ int rockchip_display_bind(struct udevice *dev)
 	struct video_uc_platdata *plat = dev_get_uclass_platdata(dev);
 
 	plat->size = DRM_ROCKCHIP_FB_SIZE + MEMORY_POOL_SIZE;
+#ifdef CONFIG_DRM_ROCKCHIP_DOUBLE_BUFFER
+	/* second scanout buffer lives behind the memory pool */
+	plat->size += DRM_ROCKCHIP_FB_SIZE;
+#endif
 
 	return 0;
 }
@@ -1620,6 +1772,13 @@ unsigned long get_drm_memory(void)
 	return (memory_start - DRM_ROCKCHIP_FB_SIZE);
 }
 
+#ifdef CONFIG_DRM_ROCKCHIP_DOUBLE_BUFFER
+unsigned long get_drm_back_memory(void)
+{
+	return memory_start + MEMORY_POOL_SIZE;
+}
+#endif
+
 struct display_state *get_display_state(void)
 {
 	struct display_state *s;
@@ -1643,6 +1802,19 @@ void set_display_state(struct display_state *state, bool enable)
 		display_disable(state);
 }
 
+/* like set_display_state(state, true), but don't wait for the panel */
+int start_display_state(struct display_state *state)
+{
+	display_set_plane(state);
+
+	return display_enable_start(state);
+}
+
+int flip_display_state(struct display_state *state, u32 dma_addr)
+{
+	return display_page_flip(state, dma_addr);
+}
+
 #endif
 
 U_BOOT_CMD(
@@ -161,6 +161,12 @@ struct display_state {
 	int enable;
 	int is_init;
 	int is_enable;
+
+	/* non-blocking enable in progress, see display_enable_poll() */
+	int enable_seq;
+	ulong enable_start;	/* us */
+	ulong enable_busy;	/* us spent running the sequence */
+	ulong enable_blocked;	/* us spent waiting for it */
 };
 
 static inline struct rockchip_panel *state_get_panel(struct display_state *s)
@@ -175,10 +181,33 @@ int display_send_mcu_cmd(struct display_state *state, u32 type, u32 val);
 bool drm_mode_is_420(const struct drm_display_info *display,
 		     struct drm_display_mode *mode);
 
+#ifdef CONFIG_DRM_ROCKCHIP_DISPLAY_CACHE
+int display_cache_get_mode(struct display_state *state,
+			   struct drm_display_mode *mode);
+void display_cache_put_mode(struct display_state *state,
+			    const struct drm_display_mode *mode);
+#else
+static inline int display_cache_get_mode(struct display_state *state,
+					 struct drm_display_mode *mode)
+{
+	return -ENOSYS;
+}
+
+static inline void display_cache_put_mode(struct display_state *state,
+					  const struct drm_display_mode *mode)
+{
+}
+#endif
+
 #if defined(CONFIG_PLATFORM_ODROID_GOADV)
 	unsigned long get_drm_memory(void);
 	struct display_state *get_display_state(void);
 	void set_display_state(struct display_state *state, bool enable);
+	int start_display_state(struct display_state *state);
+	int flip_display_state(struct display_state *state, u32 dma_addr);
+#if defined(CONFIG_DRM_ROCKCHIP_DOUBLE_BUFFER)
+	unsigned long get_drm_back_memory(void);
+#endif
 #endif
 
 #endif
@@ -0,0 +1,200 @@
+/*
+ * (C) Copyright 2008-2017 Fuzhou Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <errno.h>
+#include <drm_modes.h>
+#include <linux/libfdt.h>
+#include <u-boot/crc.h>
+#include <asm/arch/vendor.h>
+
+#include "rockchip_display.h"
+#include "rockchip_panel.h"
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/*
+ * The display timing resolved from the DT is kept in vendor storage, keyed
+ * by the sizes of the DTB it came from and, for each route, by the contents
+ * of its panel node, display-timings included. On the next boots it is used
+ * as is. A different DTB (new kernel dtb, other board revision) or an edited
+ * panel node does not match the key and the timing is resolved from the DT
+ * and stored again.
+ *
+ * Only the panel node is checksummed, the whole DTB would cost more than
+ * the property reads the cache saves.
+ */
+#define DISPLAY_CACHE_MAGIC		0x43505344	/* "DSPC" */
+#define DISPLAY_CACHE_ROUTES		4
+
+struct display_cache_mode {
+	u32 route;		/* crc32 of the route name and its panel node */
+	u32 clock;
+	u32 hdisplay;
+	u32 hsync_start;
+	u32 hsync_end;
+	u32 htotal;
+	u32 vdisplay;
+	u32 vsync_start;
+	u32 vsync_end;
+	u32 vtotal;
+	u32 flags;
+};
+
+struct display_cache {
+	u32 magic;
+	u32 dtb_key;
+	u32 num;
+	u32 crc;		/* crc32 of mode[] */
+	struct display_cache_mode mode[DISPLAY_CACHE_ROUTES];
+};
+
+static struct display_cache cache;
+static bool cache_loaded;
+
+/* crc32 of the structure block of @node and all its subnodes */
+static u32 display_cache_node_crc(u32 crc, const void *blob, int node)
+{
+	const void *p;
+	int depth = 0;
+	int end = node;
+
+	do {
+		end = fdt_next_node(blob, end, &depth);
+	} while (end >= 0 && depth > 0);
+	if (end < 0)
+		end = fdt_size_dt_struct(blob);
+
+	p = fdt_offset_ptr(blob, node, end - node);
+	if (!p)
+		return crc;
+
+	return crc32(crc, p, end - node);
+}
+
+static u32 display_cache_route(struct display_state *state)
+{
+	const char *name = ofnode_get_name(state->node);
+	struct rockchip_panel *panel = state_get_panel(state);
+	u32 crc;
+
+	crc = crc32(0, (const unsigned char *)name, strlen(name));
+	if (panel && panel->dev && dev_of_offset(panel->dev) >= 0)
+		crc = display_cache_node_crc(crc, gd->fdt_blob,
+					     dev_of_offset(panel->dev));
+
+	return crc;
+}
+
+static u32 display_cache_dtb_key(void)
+{
+	const void *blob = gd->fdt_blob;
+	u32 key[3];
+
+	key[0] = fdt_totalsize(blob);
+	key[1] = fdt_size_dt_struct(blob);
+	key[2] = fdt_size_dt_strings(blob);
+
+	return crc32(0, (const unsigned char *)key, sizeof(key));
+}
+
+static void display_cache_load(void)
+{
+	u32 dtb_key = display_cache_dtb_key();
+	int ret;
+
+	cache_loaded = true;
+
+	ret = vendor_storage_read(VENDOR_DISPLAY_CACHE_ID, &cache,
+				  sizeof(cache));
+	if (ret == sizeof(cache) && cache.magic == DISPLAY_CACHE_MAGIC &&
+	    cache.num <= DISPLAY_CACHE_ROUTES &&
+	    cache.crc == crc32(0, (const unsigned char *)cache.mode,
+			       sizeof(cache.mode))) {
+		if (cache.dtb_key == dtb_key)
+			return;
+		printf("display cache: dtb changed, invalidated\n");
+	}
+
+	memset(&cache, 0, sizeof(cache));
+	cache.magic = DISPLAY_CACHE_MAGIC;
+	cache.dtb_key = dtb_key;
+}
+
+int display_cache_get_mode(struct display_state *state,
+			   struct drm_display_mode *mode)
+{
+	struct display_cache_mode *m;
+	u32 route;
+	int i;
+
+	if (!cache_loaded)
+		display_cache_load();
+
+	route = display_cache_route(state);
+	for (i = 0; i < cache.num; i++) {
+		m = &cache.mode[i];
+		if (m->route != route)
+			continue;
+
+		mode->clock = m->clock;
+		mode->hdisplay = m->hdisplay;
+		mode->hsync_start = m->hsync_start;
+		mode->hsync_end = m->hsync_end;
+		mode->htotal = m->htotal;
+		mode->vdisplay = m->vdisplay;
+		mode->vsync_start = m->vsync_start;
+		mode->vsync_end = m->vsync_end;
+		mode->vtotal = m->vtotal;
+		mode->flags = m->flags;
+
+		return 0;
+	}
+
+	return -ENOENT;
+}
+
+void display_cache_put_mode(struct display_state *state,
+			    const struct drm_display_mode *mode)
+{
+	struct display_cache_mode *m;
+	u32 route;
+	int i, ret;
+
+	if (!cache_loaded)
+		display_cache_load();
+
+	route = display_cache_route(state);
+	for (i = 0; i < cache.num; i++) {
+		if (cache.mode[i].route == route)
+			break;
+	}
+	if (i == DISPLAY_CACHE_ROUTES)
+		return;
+
+	m = &cache.mode[i];
+	m->route = route;
+	m->clock = mode->clock;
+	m->hdisplay = mode->hdisplay;
+	m->hsync_start = mode->hsync_start;
+	m->hsync_end = mode->hsync_end;
+	m->htotal = mode->htotal;
+	m->vdisplay = mode->vdisplay;
+	m->vsync_start = mode->vsync_start;
+	m->vsync_end = mode->vsync_end;
+	m->vtotal = mode->vtotal;
+	m->flags = mode->flags;
+	if (i == cache.num)
+		cache.num++;
+
+	cache.crc = crc32(0, (const unsigned char *)cache.mode,
+			  sizeof(cache.mode));
+	ret = vendor_storage_write(VENDOR_DISPLAY_CACHE_ID, &cache,
+				   sizeof(cache));
+	if (ret != sizeof(cache))
+		printf("display cache: write failed: %d\n", ret);
+}
@@ -36,6 +36,57 @@ void lcd_sync(void)
 		CONFIG_SYS_CACHELINE_SIZE));
 }
 
+/*----------------------------------------------------------------------------*/
+static int lcd_get_height(void);
+
+/*----------------------------------------------------------------------------*/
+static unsigned long lcd_pitch(void)
+{
+	return ALIGN(lcd->w * lcd->bpp, 32) >> 3;
+}
+
+/*----------------------------------------------------------------------------*/
+/* y, h : rows in lcd (rotated) coordinates */
+static void lcd_set_dirty(int y, int h)
+{
+	int y1;
+
+	switch (lcd->rot) {
+	case LCD_ROTATE_0:
+		break;
+	case LCD_ROTATE_180:
+		y = lcd->h - y - h;
+		break;
+	default:
+		/* a console line is a framebuffer column, every row is hit */
+		y = 0;	h = lcd->h;
+		break;
+	}
+	y1 = y + h;
+	y  = y < 0 ? 0 : y;
+	y1 = y1 > lcd->h ? lcd->h : y1;
+	if (y >= y1)
+		return;
+
+	if (lcd->dirty_y0 >= lcd->dirty_y1) {
+		lcd->dirty_y0 = y;
+		lcd->dirty_y1 = y1;
+	} else {
+		lcd->dirty_y0 = y  < lcd->dirty_y0 ? y  : lcd->dirty_y0;
+		lcd->dirty_y1 = y1 > lcd->dirty_y1 ? y1 : lcd->dirty_y1;
+	}
+}
+
+/*----------------------------------------------------------------------------*/
+static void lcd_set_draw_mem(unsigned long fb_mem)
+{
+	struct video_priv *priv = dev_get_uclass_priv(lcd->udev_video);
+
+	/* console and lcd functions draw into the same buffer */
+	lcd->drm_fb_mem = fb_mem;
+	priv->fb = (void *)fb_mem;
+}
+
 /*----------------------------------------------------------------------------*/
 int lcd_getrot(void)
 {
@@ -101,6 +152,8 @@ int lcd_init(void)
 
 	lcd->drm_fb_mem  = get_drm_memory();
 	lcd->drm_fb_size = (lcd->w * lcd->h * lcd->bpp) >> 3;
+	lcd->fb_mem[0] = lcd->drm_fb_mem;
+	lcd->front = 0;
 
 	lcd->s->crtc_state.format  = ROCKCHIP_FMT_RGB888;
 #if defined(CONFIG_PLATFORM_ODROID_GOADV)
@@ -126,7 +179,12 @@ int lcd_init(void)
 	lcd_sync();
 
 	/* lcd enable */
+#ifdef CONFIG_DRM_ROCKCHIP_PANEL_ASYNC
+	/* the panel finishes powering up while we go on */
+	start_display_state(lcd->s);
+#else
 	set_display_state(lcd->s, true);
+#endif
 	return 0;
 error:
 	printf("LCD initialize fail!\n");
@@ -159,6 +217,7 @@ int show_bmp(unsigned long bmp_mem)
 			__func__, header);
 		return -1;
 	}
+	lcd_set_dirty(0, lcd_get_height());
 	lcd_sync ();
 	return 0;
 }
@@ -242,12 +301,24 @@ int lcd_setline(unsigned long line)
 /*----------------------------------------------------------------------------*/
 int lcd_putstr(const char *str)
 {
+	struct vidconsole_priv *priv;
+	int y;
+
 	if (lcd == NULL)
 		return -ENODEV;
 
+	priv = dev_get_uclass_priv(lcd->udev_vidcon);
+	y = priv->ycur;
+
 	while (*str != 0x00)
 		vidconsole_put_char(lcd->udev_vidcon, *str++);
 
+	/* scrolling moves every row */
+	if (priv->ycur < y)
+		lcd_set_dirty(0, lcd_get_height());
+	else
+		lcd_set_dirty(y, priv->ycur - y + VIDEO_FONT_HEIGHT);
+
 	lcd_sync ();
 	return 0;
 }
@@ -255,18 +326,20 @@ int lcd_putstr(const char *str)
 /*----------------------------------------------------------------------------*/
 int lcd_clear(void)
 {
-	int cnt;
-	struct lcd_fb_bit *fb, *bg;
+	struct video_surface surface;
 
 	if (lcd == NULL)
 		return -ENODEV;
 
-	fb = (struct lcd_fb_bit *)lcd->drm_fb_mem;
-	bg = (struct lcd_fb_bit *)&lcd->bg_color;
-
-	for (cnt = 0; cnt < lcd->w * lcd->h; cnt++)
-		*fb++ = *bg;
+	surface.base = (void *)lcd->drm_fb_mem;
+	surface.line_length = lcd->w * sizeof(struct lcd_fb_bit);
+	surface.xsize = lcd->w;
+	surface.ysize = lcd->h;
+	surface.bytes_pp = sizeof(struct lcd_fb_bit);
+	video_fill_rect(lcd->udev_video, &surface, 0, 0, lcd->w, lcd->h,
+		lcd_bg_colour(0));
 
+	lcd_set_dirty(0, lcd_get_height());
 	lcd_setline(0);
 	lcd_sync ();
 	return 0;
@@ -286,6 +359,7 @@ int lcd_clrline(unsigned long line)
 	for(cnt = 0; cnt < char_cnt; cnt ++)
 		vidconsole_put_char(lcd->udev_vidcon, 0x20);
 
+	lcd_set_dirty(line * VIDEO_FONT_HEIGHT, VIDEO_FONT_HEIGHT);
 	lcd_setline(line);
 	lcd_sync ();
 	return 0;
@@ -448,6 +522,95 @@ unsigned long lcd_get_mem(void)
 	return get_drm_memory() + DRM_ROCKCHIP_FB_SIZE;
 }
 
+/*----------------------------------------------------------------------------*/
+/*
+	Double buffer mode :
+	lcd functions draw into the back buffer and nothing is shown until
+	lcd_flip(), which scans out the back buffer from the next vblank and
+	copies the damaged rows into the new back buffer to keep both in sync.
+*/
+/*----------------------------------------------------------------------------*/
+int lcd_set_dbuf(bool enable)
+{
+	if (lcd == NULL)
+		return -ENODEV;
+
+#if defined(CONFIG_DRM_ROCKCHIP_DOUBLE_BUFFER)
+	if (enable == lcd->dbuf)
+		return 0;
+
+	if (enable) {
+		lcd->fb_mem[1] = get_drm_back_memory();
+		memcpy((void *)lcd->fb_mem[1], (void *)lcd->fb_mem[0],
+			lcd->drm_fb_size);
+		lcd->dirty_y0 = lcd->dirty_y1 = 0;
+		lcd->front = 0;
+		lcd->dbuf = true;
+		lcd_set_draw_mem(lcd->fb_mem[1]);
+		lcd_sync();
+		return 0;
+	}
+
+	/* kernel logo handover expects the scanout at the primary buffer */
+	if (lcd->front) {
+		lcd_set_draw_mem(lcd->fb_mem[0]);
+		memcpy((void *)lcd->fb_mem[0], (void *)lcd->fb_mem[1],
+			lcd->drm_fb_size);
+		lcd_sync();
+		flip_display_state(lcd->s, (u32)lcd->fb_mem[0]);
+		lcd->front = 0;
+	}
+	lcd->dbuf = false;
+	lcd_set_draw_mem(lcd->fb_mem[0]);
+	return 0;
+#else
+	return enable ? -ENOSYS : 0;
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+int lcd_flip(void)
+{
+	unsigned long pitch, offset, size;
+	unsigned char back;
+	int ret;
+
+	if (lcd == NULL)
+		return -ENODEV;
+
+	if (!lcd->dbuf) {
+		lcd_sync();
+		return 0;
+	}
+
+	if (lcd->dirty_y0 >= lcd->dirty_y1)
+		return 0;
+
+	lcd_sync();
+
+	back = !lcd->front;
+	ret = flip_display_state(lcd->s, (u32)lcd->fb_mem[back]);
+	if (ret)
+		return ret;
+	lcd->front = back;
+
+	/* bring the new back buffer up to date, damaged rows only */
+	pitch  = lcd_pitch();
+	offset = lcd->dirty_y0 * pitch;
+	size   = (lcd->dirty_y1 - lcd->dirty_y0) * pitch;
+	memcpy((void *)(lcd->fb_mem[!back] + offset),
+		(void *)(lcd->fb_mem[back] + offset), size);
+	flush_dcache_range(
+		round_down(lcd->fb_mem[!back] + offset,
+			CONFIG_SYS_CACHELINE_SIZE),
+		ALIGN(lcd->fb_mem[!back] + offset + size,
+			CONFIG_SYS_CACHELINE_SIZE));
+
+	lcd_set_draw_mem(lcd->fb_mem[!back]);
+	lcd->dirty_y0 = lcd->dirty_y1 = 0;
+	return 0;
+}
+
 /*----------------------------------------------------------------------------*/
 int lcd_show_logo(void)
 {
@@ -530,6 +693,8 @@ static int do_lcd_cmds(cmd_tbl_t *cmdtp, int flag, int argc,
 			return lcd_init();
 		if (!strcmp("clear", argv[1]))
 			return lcd_clear();
+		if (!strcmp("flip", argv[1]))
+			return lcd_flip();
 		break;
 	case 3:
 		if (!strcmp("init", argv[1])) {
@@ -557,6 +722,11 @@ static int do_lcd_cmds(cmd_tbl_t *cmdtp, int flag, int argc,
 			transp = simple_strtoul(argv[2], NULL, 10);
 			return lcd_settransp(transp);
 		}
+		if (!strcmp("dbuf", argv[1])) {
+			unsigned long dbuf;
+			dbuf = simple_strtoul(argv[2], NULL, 10);
+			return lcd_set_dbuf(dbuf != 0);
+		}
 		if (!strcmp("setfg", argv[1]))
 			return lcd_setfg_color(argv[2]);
 		if (!strcmp("setbg", argv[1]))
@@ -603,6 +773,8 @@ static char lcd_help_text[] = {
 	"setcur <x> <y> - move cursor position to x, y\n"
 	"setline <line> - move cursor position to 0, y(font size)\n"
 	"settransp < 1 | 0 > - set background transparent\n"
+	"dbuf < 1 | 0 > - draw into a back buffer, shown by flip\n"
+	"flip - show the back buffer at the next vblank\n"
 	"setfg <r> <g> <b> - set foreground color\n"
 	"setbg <r> <g> <b> - set background color\n"
 	"setfg <color> - set foreground color (color string)\n"
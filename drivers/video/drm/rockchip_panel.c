@@ -62,6 +62,12 @@ struct rockchip_panel_plat {
 struct rockchip_panel_priv {
 	bool prepared;
 	bool enabled;
+	bool enabling;
+	/* power on sequence, see panel_simple_prepare_poll() */
+	int seq;
+	int seq_cmd;
+	ulong seq_start;
+	ulong seq_delay_us;
 	struct udevice *lcd1v8_supply;
 	struct udevice *backlight;
 	struct gpio_desc enable_gpio;
@@ -187,6 +193,20 @@ static int rockchip_panel_send_mcu_cmds(struct display_state *state,
 	return 0;
 }
 
+static int rockchip_panel_send_spi_cmd(struct rockchip_panel_priv *priv,
+				       struct rockchip_cmd_desc *desc)
+{
+	int value = 0;
+
+	if (desc->header.payload_length == 2)
+		value = (desc->payload[0] << 8) | desc->payload[1];
+	else
+		value = desc->payload[0];
+	rockchip_panel_write_spi_cmds(priv, desc->header.data_type, value);
+
+	return 0;
+}
+
 static int rockchip_panel_send_spi_cmds(struct display_state *state,
 					struct rockchip_panel_cmds *cmds)
 {
@@ -199,14 +219,8 @@ static int rockchip_panel_send_spi_cmds(struct display_state *state,
 
 	for (i = 0; i < cmds->cmd_cnt; i++) {
 		struct rockchip_cmd_desc *desc = &cmds->cmds[i];
-		int value = 0;
 
-		if (desc->header.payload_length == 2)
-			value = (desc->payload[0] << 8) | desc->payload[1];
-		else
-			value = desc->payload[0];
-		rockchip_panel_write_spi_cmds(priv,
-					      desc->header.data_type, value);
+		rockchip_panel_send_spi_cmd(priv, desc);
 
 		if (desc->header.delay_ms)
 			mdelay(desc->header.delay_ms);
@@ -215,6 +229,30 @@ static int rockchip_panel_send_spi_cmds(struct display_state *state,
 	return 0;
 }
 
+static int rockchip_panel_send_dsi_cmd(struct mipi_dsi_device *dsi,
+				       struct rockchip_cmd_desc *desc)
+{
+	const struct rockchip_cmd_header *header = &desc->header;
+
+	switch (header->data_type) {
+	case MIPI_DSI_GENERIC_SHORT_WRITE_0_PARAM:
+	case MIPI_DSI_GENERIC_SHORT_WRITE_1_PARAM:
+	case MIPI_DSI_GENERIC_SHORT_WRITE_2_PARAM:
+	case MIPI_DSI_GENERIC_LONG_WRITE:
+		return mipi_dsi_generic_write(dsi, desc->payload,
+					      header->payload_length);
+	case MIPI_DSI_DCS_SHORT_WRITE:
+	case MIPI_DSI_DCS_SHORT_WRITE_PARAM:
+	case MIPI_DSI_DCS_LONG_WRITE:
+		return mipi_dsi_dcs_write_buffer(dsi, desc->payload,
+						 header->payload_length);
+	default:
+		printf("unsupport command data type: %d\n",
+		       header->data_type);
+		return -EINVAL;
+	}
+}
+
 static int rockchip_panel_send_dsi_cmds(struct mipi_dsi_device *dsi,
 					struct rockchip_panel_cmds *cmds)
 {
@@ -227,26 +265,7 @@ static int rockchip_panel_send_dsi_cmds(struct mipi_dsi_device *dsi,
 		struct rockchip_cmd_desc *desc = &cmds->cmds[i];
 		const struct rockchip_cmd_header *header = &desc->header;
 
-		switch (header->data_type) {
-		case MIPI_DSI_GENERIC_SHORT_WRITE_0_PARAM:
-		case MIPI_DSI_GENERIC_SHORT_WRITE_1_PARAM:
-		case MIPI_DSI_GENERIC_SHORT_WRITE_2_PARAM:
-		case MIPI_DSI_GENERIC_LONG_WRITE:
-			ret = mipi_dsi_generic_write(dsi, desc->payload,
-						     header->payload_length);
-			break;
-		case MIPI_DSI_DCS_SHORT_WRITE:
-		case MIPI_DSI_DCS_SHORT_WRITE_PARAM:
-		case MIPI_DSI_DCS_LONG_WRITE:
-			ret = mipi_dsi_dcs_write_buffer(dsi, desc->payload,
-							header->payload_length);
-			break;
-		default:
-			printf("unsupport command data type: %d\n",
-			       header->data_type);
-			return -EINVAL;
-		}
-
+		ret = rockchip_panel_send_dsi_cmd(dsi, desc);
 		if (ret < 0) {
 			printf("failed to write cmd%d: %d\n", i, ret);
 			return ret;
@@ -276,124 +295,180 @@ static int rockchip_panel_send_dsi_cmds(struct mipi_dsi_device *dsi,
 	return 0;
 }
 
-static void panel_simple_prepare(struct rockchip_panel *panel)
+/*
+ * Power on sequence, every step is followed by a delay (ms). The delays are
+ * not waited for here, panel_simple_prepare_poll() runs the next step once
+ * the previous delay has elapsed so that the caller can do something else
+ * meanwhile.
+ */
+enum panel_seq {
+	PANEL_SEQ_POWER,
+	PANEL_SEQ_ENABLE,
+	PANEL_SEQ_RESET,
+	PANEL_SEQ_INIT,
+	PANEL_SEQ_VSPN,
+	PANEL_SEQ_BACKLIGHT,
+	PANEL_SEQ_ON_CMDS,
+	PANEL_SEQ_DONE,
+};
+
+static int panel_simple_prepare_step(struct rockchip_panel *panel,
+				     unsigned int *delay_ms)
 {
 	struct rockchip_panel_plat *plat = dev_get_platdata(panel->dev);
 	struct rockchip_panel_priv *priv = dev_get_priv(panel->dev);
 	struct mipi_dsi_device *dsi = dev_get_parent_platdata(panel->dev);
-	int ret;
+	struct rockchip_cmd_desc *desc;
+	int ret = 0;
 
-	if (priv->prepared)
-		return;
+	*delay_ms = 0;
 
-	
+	switch (priv->seq) {
+	case PANEL_SEQ_POWER:
 #if defined(CONFIG_PLATFORM_ODROID_GOADV)
-//lcd1v8电压开启
-if (priv->lcd1v8_supply) {
-		struct dm_regulator_uclass_platdata *uc_pdata;
-
-		uc_pdata = dev_get_uclass_platdata(priv->lcd1v8_supply);
-		regulator_set_value(priv->lcd1v8_supply, uc_pdata->min_uV);
+		//lcd1v8电压开启
+		if (priv->lcd1v8_supply) {
+			struct dm_regulator_uclass_platdata *uc_pdata;
+
+			uc_pdata = dev_get_uclass_platdata(priv->lcd1v8_supply);
+			regulator_set_value(priv->lcd1v8_supply,
+					    uc_pdata->min_uV);
+			regulator_set_enable(priv->lcd1v8_supply,
+					     !plat->power_invert);
+		}
 
-		regulator_set_enable(priv->lcd1v8_supply, !plat->power_invert);
-	}
+		//lcd2v8电压开启
+		if (priv->lcd2v8_supply) {
+			struct dm_regulator_uclass_platdata *uc_pdata;
+
+			uc_pdata = dev_get_uclass_platdata(priv->lcd2v8_supply);
+			regulator_set_value(priv->lcd2v8_supply,
+					    uc_pdata->min_uV);
+			ret = regulator_set_enable(priv->lcd2v8_supply, 1);
+			if (ret) {
+				printf("%s: failed to enable lcd2v8_supply",
+				       __func__);
+				return ret;
+			}
+		}
+		*delay_ms = 10;
 #endif
+		break;
+	case PANEL_SEQ_ENABLE:
+		if (dm_gpio_is_valid(&priv->enable_gpio))
+			dm_gpio_set_value(&priv->enable_gpio, 1);
+		*delay_ms = plat->delay.prepare;
+		break;
+	case PANEL_SEQ_RESET:
+		dm_gpio_set_value(&priv->vspn_gpio, 1);
+		dm_gpio_set_value(&priv->reset_gpio, 1);
+		*delay_ms = plat->delay.reset;
+		break;
+	case PANEL_SEQ_INIT:
+		if (dm_gpio_is_valid(&priv->reset_gpio))
+			dm_gpio_set_value(&priv->reset_gpio, 0);
+		*delay_ms = plat->delay.init;
+		break;
+	case PANEL_SEQ_VSPN:
+		if (dm_gpio_is_valid(&priv->vspn_gpio))
+			dm_gpio_set_value(&priv->vspn_gpio, 0);//vspn上电
+		*delay_ms = 5;
+		break;
+	case PANEL_SEQ_BACKLIGHT:
+		if (dm_gpio_is_valid(&priv->back_vcc_en_gpio))
+			dm_gpio_set_value(&priv->back_vcc_en_gpio, 1);//back_vcc_en上电
+		if (priv->backlight)
+			backlight_enable(priv->backlight);
 #if defined(CONFIG_PLATFORM_ODROID_GOADV)
-   //lcd2v8电压开启
-	if (priv->lcd2v8_supply) {
-		struct dm_regulator_uclass_platdata *uc_pdata;
+		//背光开启
+		if (priv->backlight2v8_supply) {
+			struct dm_regulator_uclass_platdata *uc_pdata;
+
+			uc_pdata = dev_get_uclass_platdata(priv->backlight2v8_supply);
+			regulator_set_value(priv->backlight2v8_supply,
+					    uc_pdata->min_uV);
+			ret = regulator_set_enable(priv->backlight2v8_supply, 1);
+			if (ret) {
+				printf("%s: failed to enable backlight2v8_supply ",
+				       __func__);
+				return ret;
+			}
+		}
+#endif
+		priv->seq_cmd = 0;
+		break;
+	case PANEL_SEQ_ON_CMDS:
+		if (!plat->on_cmds || !plat->on_cmds->cmd_cnt)
+			break;
 
-		uc_pdata = dev_get_uclass_platdata(priv->lcd2v8_supply);
-		regulator_set_value(priv->lcd2v8_supply, uc_pdata->min_uV);
-printk("2222222222222222\n");
-		ret = regulator_set_enable(priv->lcd2v8_supply, 1);
-		if (ret) {
-			printf("%s: failed to enable lcd2v8_supply",
-				__func__);
-			return;
+		/* mcu commands are sent at once, within bypass mode */
+		if (priv->cmd_type == CMD_TYPE_MCU) {
+			ret = rockchip_panel_send_mcu_cmds(panel->state,
+							   plat->on_cmds);
+			if (ret)
+				printf("failed to send on cmds: %d\n", ret);
+			break;
 		}
-	}
-	mdelay(10);
-	/*
-	//backlight2v8_supply开机
-		if (priv->backlight2v8_supply) {
-		struct dm_regulator_uclass_platdata *uc_pdata;
 
-		uc_pdata = dev_get_uclass_platdata(priv->backlight2v8_supply);
-		regulator_set_value(priv->backlight2v8_supply, uc_pdata->min_uV);
-printk("333333333333\n");
-		ret = regulator_set_enable(priv->backlight2v8_supply, 1);
+		desc = &plat->on_cmds->cmds[priv->seq_cmd];
+		if (priv->cmd_type == CMD_TYPE_SPI)
+			ret = rockchip_panel_send_spi_cmd(priv, desc);
+		else
+			ret = rockchip_panel_send_dsi_cmd(dsi, desc);
 		if (ret) {
-			printf("%s: failed to enable backlight2v8_supply supply",
-				__func__);
-			return;
+			printf("failed to send on cmds: %d\n", ret);
+			break;
 		}
+
+		*delay_ms = desc->header.delay_ms;
+		/* stay here until every command is sent */
+		if (++priv->seq_cmd < plat->on_cmds->cmd_cnt)
+			return 0;
+		break;
+	default:
+		break;
 	}
-	*/
-#endif
-printk("2233333322222222\n");
-	if (dm_gpio_is_valid(&priv->enable_gpio))
-		dm_gpio_set_value(&priv->enable_gpio, 1);
-
-	if (plat->delay.prepare)
-		mdelay(plat->delay.prepare);
-dm_gpio_set_value(&priv->vspn_gpio, 1);
-//mdelay(6);
-//dm_gpio_set_value(&priv->vspn_gpio, 0);
-//mdelay(10);
-//dm_gpio_set_value(&priv->vspn_gpio, 1);
-	//if (dm_gpio_is_valid(&priv->reset_gpio))
-		//{dm_gpio_set_value(&priv->reset_gpio, 0);}
-		//mdelay(5);
-		//dm_gpio_set_value(&priv->reset_gpio, 1);
-       dm_gpio_set_value(&priv->reset_gpio, 1);
-	if (plat->delay.reset)
-		mdelay(plat->delay.reset);
 
-	if (dm_gpio_is_valid(&priv->reset_gpio))
-		{dm_gpio_set_value(&priv->reset_gpio, 0);}
-		/*vsp vsn*/
-		//mdelay(5);
-		//if (dm_gpio_is_valid(&priv->vspn_gpio))
-		// {dm_gpio_set_value(&priv->vspn_gpio, 1);}//上电
-	if (plat->delay.init)
-		mdelay(plat->delay.init);
-			if (dm_gpio_is_valid(&priv->vspn_gpio))
-		 {dm_gpio_set_value(&priv->vspn_gpio, 0);}//vspn上电
-		 mdelay(5);
-        if (dm_gpio_is_valid(&priv->back_vcc_en_gpio))
-		{dm_gpio_set_value(&priv->back_vcc_en_gpio, 1);}//back_vcc_en上电
-		if (priv->backlight)
-		backlight_enable(priv->backlight);
-		//背光开启
-		if (priv->backlight2v8_supply) {
-		struct dm_regulator_uclass_platdata *uc_pdata;
+	priv->seq++;
 
-		uc_pdata = dev_get_uclass_platdata(priv->backlight2v8_supply);
-		regulator_set_value(priv->backlight2v8_supply, uc_pdata->min_uV);
-printk("333333333333\n");
-		ret = regulator_set_enable(priv->backlight2v8_supply, 1);
+	return 0;
+}
+
+static int panel_simple_prepare_poll(struct rockchip_panel *panel)
+{
+	struct rockchip_panel_priv *priv = dev_get_priv(panel->dev);
+	unsigned int delay_ms;
+	int ret;
+
+	if (priv->prepared)
+		return 0;
+
+	while (priv->seq < PANEL_SEQ_DONE) {
+		if (timer_get_us() - priv->seq_start < priv->seq_delay_us)
+			return -EAGAIN;
+
+		ret = panel_simple_prepare_step(panel, &delay_ms);
+		priv->seq_start = timer_get_us();
+		priv->seq_delay_us = delay_ms * 1000;
 		if (ret) {
-			printf("%s: failed to enable backlight2v8_supply ",
-				__func__);
-			return;
+			/* start over on the next attempt */
+			priv->seq = PANEL_SEQ_POWER;
+			priv->seq_delay_us = 0;
+			return ret;
 		}
 	}
-	if (plat->on_cmds) {
-		if (priv->cmd_type == CMD_TYPE_SPI)
-			ret = rockchip_panel_send_spi_cmds(panel->state,
-							   plat->on_cmds);
-		else if (priv->cmd_type == CMD_TYPE_MCU)
-			ret = rockchip_panel_send_mcu_cmds(panel->state,
-							   plat->on_cmds);
-		else
-			ret = rockchip_panel_send_dsi_cmds(dsi, plat->on_cmds);
-		if (ret)
-			printf("failed to send on cmds: %d\n", ret);
-	}
-	
 
+	priv->seq = PANEL_SEQ_POWER;
+	priv->seq_delay_us = 0;
 	priv->prepared = true;
+
+	return 0;
+}
+
+static void panel_simple_prepare(struct rockchip_panel *panel)
+{
+	while (panel_simple_prepare_poll(panel) == -EAGAIN)
+		;
 }
 
 static void panel_simple_unprepare(struct rockchip_panel *panel)
@@ -470,21 +545,34 @@ static void panel_simple_unprepare(struct rockchip_panel *panel)
 	priv->prepared = false;
 }
 
-static void panel_simple_enable(struct rockchip_panel *panel)
+static int panel_simple_enable_poll(struct rockchip_panel *panel)
 {
 	struct rockchip_panel_plat *plat = dev_get_platdata(panel->dev);
 	struct rockchip_panel_priv *priv = dev_get_priv(panel->dev);
 
 	if (priv->enabled)
-		return;
+		return 0;
 
-	if (plat->delay.enable)
-		mdelay(plat->delay.enable);
+	if (!priv->enabling) {
+		priv->enabling = true;
+		priv->seq_start = timer_get_us();
+	}
+	if (timer_get_us() - priv->seq_start < plat->delay.enable * 1000)
+		return -EAGAIN;
 
 	//if (priv->backlight)
 	//	backlight_enable(priv->backlight);
 
+	priv->enabling = false;
 	priv->enabled = true;
+
+	return 0;
+}
+
+static void panel_simple_enable(struct rockchip_panel *panel)
+{
+	while (panel_simple_enable_poll(panel) == -EAGAIN)
+		;
 }
 
 static void panel_simple_disable(struct rockchip_panel *panel)
@@ -515,8 +603,10 @@ static void panel_simple_init(struct rockchip_panel *panel)
 static const struct rockchip_panel_funcs rockchip_panel_funcs = {
 	.init = panel_simple_init,
 	.prepare = panel_simple_prepare,
+	.prepare_poll = panel_simple_prepare_poll,
 	.unprepare = panel_simple_unprepare,
 	.enable = panel_simple_enable,
+	.enable_poll = panel_simple_enable_poll,
 	.disable = panel_simple_disable,
 };
 
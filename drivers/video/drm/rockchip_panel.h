@@ -16,6 +16,12 @@ struct rockchip_panel_funcs {
 	void (*unprepare)(struct rockchip_panel *panel);
 	void (*enable)(struct rockchip_panel *panel);
 	void (*disable)(struct rockchip_panel *panel);
+	/*
+	 * Optional non-blocking prepare/enable: do whatever is due and return
+	 * -EAGAIN while a power sequence delay is still running, 0 once done.
+	 */
+	int (*prepare_poll)(struct rockchip_panel *panel);
+	int (*enable_poll)(struct rockchip_panel *panel);
 };
 
 struct rockchip_panel {
@@ -55,6 +61,32 @@ static inline void rockchip_panel_enable(struct rockchip_panel *panel)
 		panel->funcs->enable(panel);
 }
 
+static inline int rockchip_panel_prepare_poll(struct rockchip_panel *panel)
+{
+	if (!panel)
+		return 0;
+
+	if (panel->funcs && panel->funcs->prepare_poll)
+		return panel->funcs->prepare_poll(panel);
+
+	rockchip_panel_prepare(panel);
+
+	return 0;
+}
+
+static inline int rockchip_panel_enable_poll(struct rockchip_panel *panel)
+{
+	if (!panel)
+		return 0;
+
+	if (panel->funcs && panel->funcs->enable_poll)
+		return panel->funcs->enable_poll(panel);
+
+	rockchip_panel_enable(panel);
+
+	return 0;
+}
+
 static inline void rockchip_panel_unprepare(struct rockchip_panel *panel)
 {
 	if (!panel)
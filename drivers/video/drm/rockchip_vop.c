@@ -639,6 +639,19 @@ static int rockchip_vop_setup_csc_table(struct display_state *state)
 	return 0;
 }
 
+/*
+ * Address to scan out from for a frame at @dma_addr: mirrored vertically,
+ * the VOP reads the last line first and walks backwards
+ */
+static u32 vop_scanout_addr(struct crtc_state *crtc_state, u32 dma_addr,
+			    bool y_mirror)
+{
+	if (y_mirror)
+		dma_addr += (crtc_state->src_h - 1) * crtc_state->xvir * 4;
+
+	return dma_addr;
+}
+
 static int rockchip_vop_set_plane(struct display_state *state)
 {
 	struct crtc_state *crtc_state = &state->crtc_state;
@@ -687,12 +700,10 @@ static int rockchip_vop_set_plane(struct display_state *state)
 		y_mirror = 1;
 	else
 		y_mirror = 0;
-	if (y_mirror) {
-		if (VOP_CTRL_SUPPORT(vop, ymirror))
-			crtc_state->dma_addr += (src_h - 1) * xvir * 4;
-		else
-			y_mirror = 0;
-		}
+	if (y_mirror && !VOP_CTRL_SUPPORT(vop, ymirror))
+		y_mirror = 0;
+	crtc_state->dma_addr = vop_scanout_addr(crtc_state,
+						crtc_state->dma_addr, y_mirror);
 	VOP_CTRL_SET(vop, ymirror, y_mirror);
 	VOP_CTRL_SET(vop, xmirror, x_mirror);
 
@@ -717,6 +728,55 @@ static int rockchip_vop_set_plane(struct display_state *state)
 	return 0;
 }
 
+static int rockchip_vop_page_flip(struct display_state *state, u32 dma_addr)
+{
+	struct crtc_state *crtc_state = &state->crtc_state;
+	struct connector_state *conn_state = &state->conn_state;
+	struct drm_display_mode *mode = &conn_state->mode;
+	struct vop *vop = crtc_state->private;
+	unsigned long frame_us, start;
+	int ret = 0;
+
+	dma_addr = vop_scanout_addr(crtc_state, dma_addr,
+				    VOP_CTRL_SUPPORT(vop, ymirror) &&
+				    VOP_CTRL_GET(vop, ymirror));
+	crtc_state->dma_addr = dma_addr;
+
+	frame_us = 20000;
+	if (mode->clock)
+		frame_us = (unsigned long)mode->crtc_htotal *
+			   mode->crtc_vtotal * 1000 / mode->clock;
+
+	/*
+	 * The new window address is latched at the next frame start
+	 * after cfg_done, so clear the frame start status only after
+	 * committing: a stale status can then only make us wait for
+	 * one more frame, never return before the switch.
+	 */
+	VOP_WIN_SET(vop, yrgb_mst, dma_addr);
+	vop_cfg_done(vop);
+
+	if (!VOP_CTRL_SUPPORT(vop, fs_intr_status)) {
+		udelay(frame_us);
+		return 0;
+	}
+
+	VOP_CTRL_SET(vop, fs_intr_en, 1);
+	VOP_CTRL_SET(vop, fs_intr_clear, 1);
+	start = timer_get_us();
+	while (!VOP_CTRL_GET(vop, fs_intr_status)) {
+		if (timer_get_us() - start > 2 * frame_us) {
+			printf("%s: wait vblank timeout\n", __func__);
+			ret = -ETIMEDOUT;
+			break;
+		}
+	}
+	VOP_CTRL_SET(vop, fs_intr_clear, 1);
+	VOP_CTRL_SET(vop, fs_intr_en, 0);
+
+	return ret;
+}
+
 static int rockchip_vop_prepare(struct display_state *state)
 {
 	return 0;
@@ -818,6 +878,7 @@ static int rockchip_vop_send_mcu_cmd(struct display_state *state,
 const struct rockchip_crtc_funcs rockchip_vop_funcs = {
 	.init = rockchip_vop_init,
 	.set_plane = rockchip_vop_set_plane,
+	.page_flip = rockchip_vop_page_flip,
 	.prepare = rockchip_vop_prepare,
 	.enable = rockchip_vop_enable,
 	.disable = rockchip_vop_disable,
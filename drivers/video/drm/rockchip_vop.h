@@ -360,6 +360,10 @@ struct vop_ctrl {
 	struct vop_reg mcu_type;
 	struct vop_reg mcu_rw_bypass_port;
 
+	/* frame start interrupt, used to sync page flip */
+	struct vop_reg fs_intr_en;
+	struct vop_reg fs_intr_clear;
+	struct vop_reg fs_intr_status;
 
 	struct vop_reg cfg_done;
 };
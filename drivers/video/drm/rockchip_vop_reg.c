@@ -584,6 +584,10 @@ static const struct vop_ctrl px30_ctrl_data = {
 	.mcu_type = VOP_REG(RK3366_LIT_MCU_CTRL, 0x1, 31),
 	.mcu_rw_bypass_port = VOP_REG(RK3366_LIT_MCU_RW_BYPASS_PORT,
 				      0xffffffff, 0),
+
+	.fs_intr_en = VOP_REG_MASK(RK3366_LIT_INTR_EN, 0x1, 0),
+	.fs_intr_clear = VOP_REG_MASK(RK3366_LIT_INTR_CLEAR, 0x1, 0),
+	.fs_intr_status = VOP_REG(RK3366_LIT_INTR_STATUS, 0x1, 0),
 };
 
 static const struct vop_line_flag rk3366_vop_lite_line_flag = {
@@ -670,6 +674,10 @@ static const struct vop_ctrl rk3308_ctrl_data = {
 	.mcu_type = VOP_REG(RK3366_LIT_MCU_CTRL, 0x1, 31),
 	.mcu_rw_bypass_port = VOP_REG(RK3366_LIT_MCU_RW_BYPASS_PORT,
 				      0xffffffff, 0),
+
+	.fs_intr_en = VOP_REG_MASK(RK3366_LIT_INTR_EN, 0x1, 0),
+	.fs_intr_clear = VOP_REG_MASK(RK3366_LIT_INTR_CLEAR, 0x1, 0),
+	.fs_intr_status = VOP_REG(RK3366_LIT_INTR_STATUS, 0x1, 0),
 };
 
 const struct vop_data rk3308_vop = {
@@ -104,18 +104,12 @@ int video_reserve(ulong *addrp)
 static int video_clear(struct udevice *dev)
 {
 	struct video_priv *priv = dev_get_uclass_priv(dev);
+	struct video_surface surface;
 
-	if (priv->bpix == VIDEO_BPP32) {
-		u32 *ppix = priv->fb;
-		u32 *end = priv->fb + priv->fb_size;
+	video_get_surface(dev, &surface);
 
-		while (ppix < end)
-			*ppix++ = priv->colour_bg;
-	} else {
-		memset(priv->fb, priv->colour_bg, priv->fb_size);
-	}
-
-	return 0;
+	return video_fill_rect(dev, &surface, 0, 0, priv->xsize, priv->ysize,
+			       priv->colour_bg);
 }
 
 /* Flush video activity to the caches */
@@ -0,0 +1,459 @@
+/*
+ * 2D operations (fill, copy, blend, rotate) for the video uclass
+ *
+ * The software backend below is used when the video device does not
+ * provide the operation in its struct video_ops, or when the hook returns
+ * -ENOSYS (e.g. a blitter which cannot handle the given pixel format).
+ * It works on whole machine words wherever the buffer alignment allows,
+ * since the generic memmove() used by U-Boot copies backwards byte by byte
+ * and the frame buffers are often 24 bits per pixel.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <errno.h>
+#include <video.h>
+
+#define WORD_SIZE	sizeof(unsigned long)
+#define WORD_MASK	(WORD_SIZE - 1)
+
+static inline void *surface_addr(const struct video_surface *s, int x, int y)
+{
+	return s->base + (long)y * s->line_length + x * s->bytes_pp;
+}
+
+/* memmove() which copies a word at a time when src and dst share alignment */
+static void video_move(void *dest, const void *src, size_t count)
+{
+	unsigned char *d8 = dest;
+	const unsigned char *s8 = src;
+	unsigned long *dl;
+	const unsigned long *sl;
+
+	if (d8 == s8 || !count)
+		return;
+
+	if (d8 < s8 || d8 >= s8 + count) {
+		if (!(((ulong)d8 ^ (ulong)s8) & WORD_MASK)) {
+			while (count && ((ulong)d8 & WORD_MASK)) {
+				*d8++ = *s8++;
+				count--;
+			}
+			dl = (unsigned long *)d8;
+			sl = (const unsigned long *)s8;
+			while (count >= 4 * WORD_SIZE) {
+				dl[0] = sl[0];
+				dl[1] = sl[1];
+				dl[2] = sl[2];
+				dl[3] = sl[3];
+				dl += 4;
+				sl += 4;
+				count -= 4 * WORD_SIZE;
+			}
+			while (count >= WORD_SIZE) {
+				*dl++ = *sl++;
+				count -= WORD_SIZE;
+			}
+			d8 = (unsigned char *)dl;
+			s8 = (const unsigned char *)sl;
+		}
+		while (count--)
+			*d8++ = *s8++;
+		return;
+	}
+
+	/* overlapping with dst above src: copy from the end */
+	d8 += count;
+	s8 += count;
+	if (!(((ulong)d8 ^ (ulong)s8) & WORD_MASK)) {
+		while (count && ((ulong)d8 & WORD_MASK)) {
+			*--d8 = *--s8;
+			count--;
+		}
+		dl = (unsigned long *)d8;
+		sl = (const unsigned long *)s8;
+		while (count >= 4 * WORD_SIZE) {
+			dl -= 4;
+			sl -= 4;
+			dl[3] = sl[3];
+			dl[2] = sl[2];
+			dl[1] = sl[1];
+			dl[0] = sl[0];
+			count -= 4 * WORD_SIZE;
+		}
+		while (count >= WORD_SIZE) {
+			*--dl = *--sl;
+			count -= WORD_SIZE;
+		}
+		d8 = (unsigned char *)dl;
+		s8 = (const unsigned char *)sl;
+	}
+	while (count--)
+		*--d8 = *--s8;
+}
+
+static inline void put_pixel(unsigned char *p, int bytes_pp, u32 colour)
+{
+	switch (bytes_pp) {
+	case 4:
+		p[3] = colour >> 24;
+		/* fall through */
+	case 3:
+		p[2] = colour >> 16;
+		/* fall through */
+	case 2:
+		p[1] = colour >> 8;
+		/* fall through */
+	default:
+		p[0] = colour;
+	}
+}
+
+static inline u32 get_pixel(const unsigned char *p, int bytes_pp)
+{
+	switch (bytes_pp) {
+	case 4:
+		return p[0] | p[1] << 8 | p[2] << 16 | (u32)p[3] << 24;
+	case 3:
+		return p[0] | p[1] << 8 | p[2] << 16;
+	case 2:
+		return p[0] | p[1] << 8;
+	default:
+		return p[0];
+	}
+}
+
+/* Fill @npix pixels starting at @dst */
+static void video_fill_pixels(unsigned char *dst, size_t npix, int bytes_pp,
+			      u32 colour)
+{
+	/* one pattern period: WORD_SIZE pixels, i.e. bytes_pp words */
+	union {
+		unsigned char b[4 * WORD_SIZE];
+		unsigned long w[4];
+	} pat;
+	unsigned long *dl;
+	size_t nwords;
+	int i;
+
+	if (bytes_pp == 1) {
+		memset(dst, colour, npix);
+		return;
+	}
+
+	/* reach a word boundary on a pixel boundary */
+	while (npix && ((ulong)dst & WORD_MASK)) {
+		put_pixel(dst, bytes_pp, colour);
+		dst += bytes_pp;
+		npix--;
+	}
+	if (!npix)
+		return;
+
+	for (i = 0; i < WORD_SIZE; i++)
+		put_pixel(&pat.b[i * bytes_pp], bytes_pp, colour);
+
+	dl = (unsigned long *)dst;
+	nwords = npix / WORD_SIZE;
+	npix -= nwords * WORD_SIZE;
+	switch (bytes_pp) {
+	case 2:
+		while (nwords--) {
+			dl[0] = pat.w[0];
+			dl[1] = pat.w[1];
+			dl += 2;
+		}
+		break;
+	case 3:
+		while (nwords--) {
+			dl[0] = pat.w[0];
+			dl[1] = pat.w[1];
+			dl[2] = pat.w[2];
+			dl += 3;
+		}
+		break;
+	default:
+		while (nwords--) {
+			dl[0] = pat.w[0];
+			dl[1] = pat.w[1];
+			dl[2] = pat.w[2];
+			dl[3] = pat.w[3];
+			dl += 4;
+		}
+		break;
+	}
+
+	dst = (unsigned char *)dl;
+	while (npix--) {
+		put_pixel(dst, bytes_pp, colour);
+		dst += bytes_pp;
+	}
+}
+
+/* Clip a rectangle to a surface, moving @ox/@oy along with @x/@y */
+static bool video_clip(const struct video_surface *s, int *x, int *y,
+		       int *w, int *h, int *ox, int *oy)
+{
+	if (*x < 0) {
+		*w += *x;
+		*ox -= *x;
+		*x = 0;
+	}
+	if (*y < 0) {
+		*h += *y;
+		*oy -= *y;
+		*y = 0;
+	}
+	if (*x + *w > s->xsize)
+		*w = s->xsize - *x;
+	if (*y + *h > s->ysize)
+		*h = s->ysize - *y;
+
+	return *w > 0 && *h > 0;
+}
+
+static inline bool surface_rows_contiguous(const struct video_surface *s,
+					   int x, int w)
+{
+	return !x && s->line_length == w * s->bytes_pp;
+}
+
+int video_sw_fill_rect(const struct video_surface *dst, int x, int y,
+		       int w, int h, u32 colour)
+{
+	unsigned char *line;
+	int ox = 0, oy = 0;
+
+	if (!video_clip(dst, &x, &y, &w, &h, &ox, &oy))
+		return 0;
+
+	line = surface_addr(dst, x, y);
+	if (surface_rows_contiguous(dst, x, w)) {
+		video_fill_pixels(line, (size_t)w * h, dst->bytes_pp, colour);
+		return 0;
+	}
+
+	while (h--) {
+		video_fill_pixels(line, w, dst->bytes_pp, colour);
+		line += dst->line_length;
+	}
+
+	return 0;
+}
+
+int video_sw_copy_rect(const struct video_surface *dst, int dx, int dy,
+		       const struct video_surface *src, int sx, int sy,
+		       int w, int h)
+{
+	unsigned char *d, *s;
+	size_t len;
+
+	if (dst->bytes_pp != src->bytes_pp)
+		return -EINVAL;
+	if (!video_clip(dst, &dx, &dy, &w, &h, &sx, &sy) ||
+	    !video_clip(src, &sx, &sy, &w, &h, &dx, &dy))
+		return 0;
+
+	d = surface_addr(dst, dx, dy);
+	s = surface_addr(src, sx, sy);
+	len = w * dst->bytes_pp;
+
+	if (dst->line_length == src->line_length &&
+	    surface_rows_contiguous(dst, dx, w) &&
+	    surface_rows_contiguous(src, sx, w)) {
+		video_move(d, s, len * h);
+		return 0;
+	}
+
+	/* rows overlapping downwards must be copied bottom up */
+	if (d > s && d < s + (long)(h - 1) * src->line_length + len &&
+	    dst->line_length == src->line_length) {
+		d += (long)(h - 1) * dst->line_length;
+		s += (long)(h - 1) * src->line_length;
+		while (h--) {
+			video_move(d, s, len);
+			d -= dst->line_length;
+			s -= src->line_length;
+		}
+		return 0;
+	}
+
+	while (h--) {
+		video_move(d, s, len);
+		d += dst->line_length;
+		s += src->line_length;
+	}
+
+	return 0;
+}
+
+int video_sw_blend_rect(const struct video_surface *dst, int dx, int dy,
+			const struct video_surface *src, int sx, int sy,
+			int w, int h, uint alpha)
+{
+	unsigned char *d, *s;
+	int i, j, c;
+
+	if (src->bytes_pp != 4 || dst->bytes_pp < 3)
+		return -EINVAL;
+	if (!video_clip(dst, &dx, &dy, &w, &h, &sx, &sy) ||
+	    !video_clip(src, &sx, &sy, &w, &h, &dx, &dy))
+		return 0;
+
+	alpha = alpha > 255 ? 256 : alpha + (alpha >> 7);
+	for (j = 0; j < h; j++) {
+		d = surface_addr(dst, dx, dy + j);
+		s = surface_addr(src, sx, sy + j);
+		for (i = 0; i < w; i++) {
+			/* 0..256 so that fully opaque is an exact copy */
+			uint a = (s[3] + (s[3] >> 7)) * alpha >> 8;
+
+			if (a == 256) {
+				d[0] = s[0];
+				d[1] = s[1];
+				d[2] = s[2];
+			} else if (a) {
+				for (c = 0; c < 3; c++)
+					d[c] = (s[c] * a + d[c] * (256 - a)) >> 8;
+			}
+			d += dst->bytes_pp;
+			s += 4;
+		}
+	}
+
+	return 0;
+}
+
+int video_sw_rotate_copy(const struct video_surface *dst, int dx, int dy,
+			 const struct video_surface *src, int rot)
+{
+	int i, j, w, h, x, y;
+	unsigned char *s;
+
+	if (dst->bytes_pp != src->bytes_pp)
+		return -EINVAL;
+
+	rot &= 3;
+	if (!rot)
+		return video_sw_copy_rect(dst, dx, dy, src, 0, 0,
+					  src->xsize, src->ysize);
+
+	w = (rot & 1) ? src->ysize : src->xsize;
+	h = (rot & 1) ? src->xsize : src->ysize;
+	if (dx < 0 || dy < 0 || dx + w > dst->xsize || dy + h > dst->ysize)
+		return -ERANGE;
+
+	for (j = 0; j < src->ysize; j++) {
+		s = surface_addr(src, 0, j);
+		for (i = 0; i < src->xsize; i++, s += src->bytes_pp) {
+			/* clockwise rotation, same sense as video_priv.rot */
+			switch (rot) {
+			case 1:
+				x = src->ysize - 1 - j;
+				y = i;
+				break;
+			case 2:
+				x = src->xsize - 1 - i;
+				y = src->ysize - 1 - j;
+				break;
+			default:
+				x = j;
+				y = src->xsize - 1 - i;
+				break;
+			}
+			put_pixel(surface_addr(dst, dx + x, dy + y),
+				  dst->bytes_pp, get_pixel(s, src->bytes_pp));
+		}
+	}
+
+	return 0;
+}
+
+static struct video_ops *video_2d_ops(struct udevice *dev)
+{
+	if (!dev || !dev->driver->ops)
+		return NULL;
+
+	return video_get_ops(dev);
+}
+
+int video_fill_rect(struct udevice *dev, const struct video_surface *dst,
+		    int x, int y, int w, int h, u32 colour)
+{
+	struct video_ops *ops = video_2d_ops(dev);
+	int ret;
+
+	if (ops && ops->fill_rect) {
+		ret = ops->fill_rect(dev, dst, x, y, w, h, colour);
+		if (ret != -ENOSYS)
+			return ret;
+	}
+
+	return video_sw_fill_rect(dst, x, y, w, h, colour);
+}
+
+int video_copy_rect(struct udevice *dev, const struct video_surface *dst,
+		    int dx, int dy, const struct video_surface *src,
+		    int sx, int sy, int w, int h)
+{
+	struct video_ops *ops = video_2d_ops(dev);
+	int ret;
+
+	if (ops && ops->copy_rect) {
+		ret = ops->copy_rect(dev, dst, dx, dy, src, sx, sy, w, h);
+		if (ret != -ENOSYS)
+			return ret;
+	}
+
+	return video_sw_copy_rect(dst, dx, dy, src, sx, sy, w, h);
+}
+
+int video_blend_rect(struct udevice *dev, const struct video_surface *dst,
+		     int dx, int dy, const struct video_surface *src,
+		     int sx, int sy, int w, int h, uint alpha)
+{
+	struct video_ops *ops = video_2d_ops(dev);
+	int ret;
+
+	if (ops && ops->blend_rect) {
+		ret = ops->blend_rect(dev, dst, dx, dy, src, sx, sy, w, h,
+				      alpha);
+		if (ret != -ENOSYS)
+			return ret;
+	}
+
+	return video_sw_blend_rect(dst, dx, dy, src, sx, sy, w, h, alpha);
+}
+
+int video_rotate_copy(struct udevice *dev, const struct video_surface *dst,
+		      int dx, int dy, const struct video_surface *src, int rot)
+{
+	struct video_ops *ops = video_2d_ops(dev);
+	int ret;
+
+	if (ops && ops->rotate_copy) {
+		ret = ops->rotate_copy(dev, dst, dx, dy, src, rot);
+		if (ret != -ENOSYS)
+			return ret;
+	}
+
+	return video_sw_rotate_copy(dst, dx, dy, src, rot);
+}
+
+void video_get_surface(struct udevice *dev, struct video_surface *surface)
+{
+	struct video_priv *priv = dev_get_uclass_priv(dev);
+
+	surface->base = priv->fb;
+	surface->line_length = priv->line_length;
+	surface->xsize = priv->xsize;
+	surface->ysize = priv->ysize;
+#if defined(CONFIG_PLATFORM_ODROID_GOADV)
+	/* lcd bpp is 24 */
+	surface->bytes_pp = 3;
+#else
+	surface->bytes_pp = VNBYTES(priv->bpix);
+#endif
+}
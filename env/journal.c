@@ -0,0 +1,503 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <env_journal.h>
+#include <errno.h>
+#include <malloc.h>
+#include <memalign.h>
+#include <u-boot/crc.h>
+
+/* Records of one save, sized only while @buf is NULL */
+struct jrn_stream {
+	char *buf;
+	ulong len;
+	u32 epoch;
+	u32 seq;
+};
+
+static ulong rec_size(ulong name_len, ulong value_len)
+{
+	return ALIGN(sizeof(struct env_journal_rec) + name_len + value_len, 4);
+}
+
+static u32 rec_crc(const struct env_journal_rec *rec)
+{
+	struct env_journal_rec hdr = *rec;
+
+	hdr.crc = 0;
+
+	return crc32(crc32(0, (const uchar *)&hdr, sizeof(hdr)),
+		     (const uchar *)(rec + 1), rec->name_len + rec->value_len);
+}
+
+static void jrn_add(struct jrn_stream *s, int op, const char *name,
+		    ulong name_len, const void *value, ulong value_len)
+{
+	struct env_journal_rec *rec = (void *)(s->buf + s->len);
+
+	s->len += rec_size(name_len, value_len);
+	if (!s->buf)
+		return;
+
+	rec->magic = ENV_JOURNAL_MAGIC;
+	rec->epoch = s->epoch;
+	rec->seq = s->seq;
+	rec->op = op;
+	rec->reserved = 0;
+	rec->name_len = name_len;
+	rec->value_len = value_len;
+	if (name_len)
+		memcpy(rec + 1, name, name_len);
+	if (value_len)
+		memcpy((char *)(rec + 1) + name_len, value, value_len);
+	rec->crc = rec_crc(rec);
+}
+
+static ulong key_len(const char *entry)
+{
+	const char *eq = strchr(entry, '=');
+
+	return eq ? eq - entry : strlen(entry);
+}
+
+/* Compare the name of an image entry with @name, same order as hexport_r() */
+static int key_cmp(const char *entry, const char *name, ulong len)
+{
+	ulong i;
+
+	for (i = 0; i < len; i++) {
+		if (entry[i] == '=' || entry[i] == '\0')
+			return -1;
+		if (entry[i] != name[i])
+			return (uchar)entry[i] - (uchar)name[i];
+	}
+
+	return entry[i] == '=' || entry[i] == '\0' ? 0 : 1;
+}
+
+static char *image_find(struct env_journal *jrn, const char *name,
+			ulong len, bool *found)
+{
+	char *p = jrn->image, *end = jrn->image + jrn->image_len;
+	int cmp;
+
+	*found = false;
+	for (; p < end; p += strlen(p) + 1) {
+		cmp = key_cmp(p, name, len);
+		if (cmp >= 0) {
+			*found = !cmp;
+			break;
+		}
+	}
+
+	return p;
+}
+
+static int image_set(struct env_journal *jrn, const char *name, ulong len,
+		     const char *value, ulong value_len)
+{
+	ulong old_len, new_len = len + 1 + value_len + 1;
+	char *end = jrn->image + jrn->image_len;
+	bool found;
+	char *p;
+
+	p = image_find(jrn, name, len, &found);
+	old_len = found ? strlen(p) + 1 : 0;
+	if (jrn->image_len - old_len + new_len + 1 > jrn->image_size)
+		return -ENOSPC;
+
+	memmove(p + new_len, p + old_len, end - p - old_len);
+	memcpy(p, name, len);
+	p[len] = '=';
+	memcpy(p + len + 1, value, value_len);
+	p[new_len - 1] = '\0';
+	jrn->image_len += new_len - old_len;
+	jrn->image[jrn->image_len] = '\0';
+
+	return 0;
+}
+
+static void image_delete(struct env_journal *jrn, const char *name,
+			 ulong len)
+{
+	char *end = jrn->image + jrn->image_len;
+	ulong old_len;
+	bool found;
+	char *p;
+
+	p = image_find(jrn, name, len, &found);
+	if (!found)
+		return;
+
+	old_len = strlen(p) + 1;
+	memmove(p, p + old_len, end - p - old_len);
+	jrn->image_len -= old_len;
+	jrn->image[jrn->image_len] = '\0';
+}
+
+static const struct env_journal_rec *jrn_rec(const char *buf, ulong size,
+					     ulong offset)
+{
+	const struct env_journal_rec *rec = (const void *)(buf + offset);
+
+	if (offset + sizeof(*rec) > size || rec->magic != ENV_JOURNAL_MAGIC ||
+	    rec->value_len > size ||
+	    offset + rec_size(rec->name_len, rec->value_len) > size ||
+	    rec->crc != rec_crc(rec))
+		return NULL;
+
+	return rec;
+}
+
+static bool jrn_rec_sane(const struct env_journal_rec *rec, int idx)
+{
+	const char *name = (const char *)(rec + 1);
+	const char *value = name + rec->name_len;
+
+	/* only the first save holds START and SNAPSHOT, in this order */
+	if ((rec->op == ENV_JOURNAL_START) != (rec->seq == 1 && idx == 0) ||
+	    (rec->op == ENV_JOURNAL_SNAPSHOT) != (rec->seq == 1 && idx == 1))
+		return false;
+
+	switch (rec->op) {
+	case ENV_JOURNAL_START:
+		return rec->value_len == sizeof(u32);
+	case ENV_JOURNAL_SNAPSHOT:
+	case ENV_JOURNAL_COMMIT:
+		return !rec->name_len;
+	case ENV_JOURNAL_SET:
+		if (memchr(value, '\0', rec->value_len))
+			return false;
+		/* fall through */
+	case ENV_JOURNAL_DELETE:
+		return rec->name_len && !memchr(name, '=', rec->name_len) &&
+		       !memchr(name, '\0', rec->name_len);
+	default:
+		return false;
+	}
+}
+
+/* Return the length of save @seq at @offset, 0 if it is not committed */
+static ulong jrn_check_save(const char *buf, ulong size, ulong offset,
+			    u32 epoch, u32 seq)
+{
+	const struct env_journal_rec *rec;
+	ulong start = offset;
+	int idx;
+
+	for (idx = 0; ; idx++) {
+		rec = jrn_rec(buf, size, offset);
+		if (!rec || rec->epoch != epoch || rec->seq != seq ||
+		    !jrn_rec_sane(rec, idx))
+			return 0;
+
+		offset += rec_size(rec->name_len, rec->value_len);
+		if (rec->op == ENV_JOURNAL_COMMIT)
+			return offset - start;
+	}
+}
+
+static int jrn_apply(struct env_journal *jrn, const char *buf, ulong len)
+{
+	const struct env_journal_rec *rec;
+	const char *name, *value;
+	ulong offset = 0;
+	int ret = 0;
+
+	while (offset < len && !ret) {
+		rec = (const void *)(buf + offset);
+		name = (const char *)(rec + 1);
+		value = name + rec->name_len;
+		offset += rec_size(rec->name_len, rec->value_len);
+
+		switch (rec->op) {
+		case ENV_JOURNAL_SNAPSHOT:
+			if (rec->value_len + 1 > jrn->image_size)
+				return -ENOSPC;
+			memcpy(jrn->image, value, rec->value_len);
+			jrn->image_len = rec->value_len;
+			jrn->image[jrn->image_len] = '\0';
+			break;
+		case ENV_JOURNAL_SET:
+			ret = image_set(jrn, name, rec->name_len, value,
+					rec->value_len);
+			break;
+		case ENV_JOURNAL_DELETE:
+			image_delete(jrn, name, rec->name_len);
+			break;
+		}
+	}
+
+	return ret;
+}
+
+static int jrn_replay(struct env_journal *jrn, const char *buf, int half)
+{
+	ulong half_size = jrn->size / 2;
+	const struct env_journal_rec *rec = (const void *)buf;
+	ulong offset, len;
+	u32 base_crc;
+	u32 seq;
+	int ret;
+
+	memcpy(&base_crc, rec + 1, sizeof(base_crc));
+	if (base_crc != jrn->base_crc)
+		return -ESTALE;
+
+	offset = 0;
+	for (seq = 1; ; seq++) {
+		len = jrn_check_save(buf, half_size, offset, rec->epoch, seq);
+		if (!len)
+			break;
+
+		ret = jrn_apply(jrn, buf + offset, len);
+		if (ret)
+			return ret;
+		offset += ALIGN(len, jrn->blksz);
+	}
+
+	jrn->half = half;
+	jrn->epoch = rec->epoch;
+	jrn->seq = seq - 1;
+	jrn->tail = offset;
+	debug("%s: half %d epoch %u, %u saves, %lu bytes\n", __func__, half,
+	      jrn->epoch, jrn->seq, jrn->tail);
+
+	return 0;
+}
+
+int env_journal_load(struct env_journal *jrn, u32 base_crc)
+{
+	ulong half_size = jrn->size / 2;
+	const struct env_journal_rec *rec;
+	int half, best = -1;
+	u32 best_epoch = 0;
+	char *buf;
+	int ret;
+
+	jrn->half = -1;
+	jrn->epoch = 0;
+	jrn->seq = 0;
+	jrn->tail = 0;
+	jrn->base_crc = base_crc;
+	jrn->image_len = 0;
+	jrn->image[0] = '\0';
+
+	buf = malloc_cache_aligned(jrn->size);
+	if (!buf)
+		return -ENOMEM;
+
+	ret = jrn->read(jrn, 0, jrn->size, buf);
+	if (ret)
+		goto out;
+
+	for (half = 0; half < 2; half++) {
+		rec = jrn_rec(buf + half * half_size, half_size, 0);
+		if (!rec)
+			continue;
+
+		/* new snapshots must not reuse an epoch found on the storage */
+		if ((s32)(rec->epoch - jrn->epoch) > 0)
+			jrn->epoch = rec->epoch;
+		if (!jrn_check_save(buf + half * half_size, half_size, 0,
+				    rec->epoch, 1))
+			continue;
+		if (best < 0 || (s32)(rec->epoch - best_epoch) > 0) {
+			best = half;
+			best_epoch = rec->epoch;
+		}
+	}
+
+	ret = -ENOENT;
+	if (best >= 0)
+		ret = jrn_replay(jrn, buf + best * half_size, best);
+	if (ret) {
+		jrn->half = -1;
+		jrn->image_len = 0;
+		jrn->image[0] = '\0';
+	}
+
+out:
+	free(buf);
+
+	return ret;
+}
+
+static int jrn_write(struct env_journal *jrn, int half, ulong offset,
+		     const char *buf, ulong len)
+{
+	ulong i;
+	int ret;
+
+	/* one block at a time, so that blocks reach the storage in order */
+	offset += half * (jrn->size / 2);
+	for (i = 0; i < len; i += jrn->blksz) {
+		ret = jrn->write(jrn, offset + i, jrn->blksz, buf + i);
+		if (ret)
+			return ret;
+		jrn->written += jrn->blksz;
+	}
+
+	return 0;
+}
+
+static void jrn_diff(struct env_journal *jrn, struct jrn_stream *s,
+		     const char *image, ulong len)
+{
+	const char *old = jrn->image, *old_end = jrn->image + jrn->image_len;
+	const char *new = image, *new_end = image + len;
+	ulong klen;
+	int cmp;
+
+	while (old < old_end || new < new_end) {
+		if (old == old_end)
+			cmp = 1;
+		else if (new == new_end)
+			cmp = -1;
+		else
+			cmp = key_cmp(old, new, key_len(new));
+
+		if (cmp < 0) {
+			jrn_add(s, ENV_JOURNAL_DELETE, old, key_len(old),
+				NULL, 0);
+		} else if (cmp > 0 || strcmp(old, new)) {
+			klen = key_len(new);
+			jrn_add(s, ENV_JOURNAL_SET, new, klen, new + klen + 1,
+				strlen(new + klen + 1));
+		}
+
+		if (cmp <= 0)
+			old += strlen(old) + 1;
+		if (cmp >= 0)
+			new += strlen(new) + 1;
+	}
+}
+
+static int jrn_save(struct env_journal *jrn, struct jrn_stream *s,
+		    const char *image, ulong len, bool compact)
+{
+	if (compact) {
+		jrn_add(s, ENV_JOURNAL_START, NULL, 0, &jrn->base_crc,
+			sizeof(jrn->base_crc));
+		jrn_add(s, ENV_JOURNAL_SNAPSHOT, NULL, 0, image, len);
+	} else {
+		jrn_diff(jrn, s, image, len);
+		if (!s->len)
+			return 0;
+	}
+	jrn_add(s, ENV_JOURNAL_COMMIT, NULL, 0, NULL, 0);
+
+	return s->len;
+}
+
+int env_journal_save(struct env_journal *jrn, const char *image, ulong len)
+{
+	ulong half_size = jrn->size / 2;
+	struct jrn_stream s;
+	bool compact;
+	int half, ret;
+
+	jrn->written = 0;
+	if (len + 1 > jrn->image_size)
+		return -ENOSPC;
+
+	memset(&s, '\0', sizeof(s));
+	compact = jrn->half < 0;
+	if (!compact) {
+		if (!jrn_save(jrn, &s, image, len, false))
+			return 0;
+		compact = jrn->tail + s.len > half_size;
+	}
+	if (compact) {
+		s.len = 0;
+		jrn_save(jrn, &s, image, len, true);
+		if (s.len > half_size)
+			return -ENOSPC;
+	}
+
+	s.buf = malloc_cache_aligned(ALIGN(s.len, jrn->blksz));
+	if (!s.buf)
+		return -ENOMEM;
+	memset(s.buf, '\0', ALIGN(s.len, jrn->blksz));
+
+	if (compact) {
+		half = jrn->half == 0 ? 1 : 0;
+		s.epoch = jrn->epoch + 1;
+		s.seq = 1;
+	} else {
+		half = jrn->half;
+		s.epoch = jrn->epoch;
+		s.seq = jrn->seq + 1;
+	}
+	s.len = 0;
+	jrn_save(jrn, &s, image, len, compact);
+
+	ret = jrn_write(jrn, half, compact ? 0 : jrn->tail, s.buf,
+			ALIGN(s.len, jrn->blksz));
+	free(s.buf);
+	if (ret)
+		return ret;
+
+	jrn->half = half;
+	jrn->epoch = s.epoch;
+	jrn->seq = s.seq;
+	jrn->tail = (compact ? 0 : jrn->tail) + ALIGN(s.len, jrn->blksz);
+	memcpy(jrn->image, image, len);
+	jrn->image_len = len;
+	jrn->image[len] = '\0';
+	debug("%s: %s half %d epoch %u save %u, %lu bytes\n", __func__,
+	      compact ? "compacted to" : "appended to", half, s.epoch, s.seq,
+	      jrn->written);
+
+	return 0;
+}
+
+int env_journal_erase(struct env_journal *jrn, u32 base_crc)
+{
+	ulong half_size = jrn->size / 2;
+	const struct env_journal_rec *rec;
+	struct jrn_stream s;
+	int half, ret;
+
+	memset(&s, '\0', sizeof(s));
+	s.buf = malloc_cache_aligned(jrn->blksz);
+	if (!s.buf)
+		return -ENOMEM;
+
+	/*
+	 * Saves of older epochs stay behind the first block of each half.
+	 * Start both halves with a START of a newer epoch which is never
+	 * committed, so that the next snapshot gets an epoch none of them has.
+	 */
+	for (half = 0; half < 2; half++) {
+		ret = jrn->read(jrn, half * half_size, jrn->blksz, s.buf);
+		if (ret)
+			goto out;
+		rec = jrn_rec(s.buf, jrn->blksz, 0);
+		if (rec && (s32)(rec->epoch - jrn->epoch) > 0)
+			jrn->epoch = rec->epoch;
+	}
+
+	memset(s.buf, '\0', jrn->blksz);
+	s.epoch = jrn->epoch + 1;
+	s.seq = 1;
+	jrn_add(&s, ENV_JOURNAL_START, NULL, 0, &base_crc, sizeof(base_crc));
+
+	jrn->written = 0;
+	for (half = 0; half < 2 && !ret; half++)
+		ret = jrn_write(jrn, half, 0, s.buf, jrn->blksz);
+
+	jrn->half = -1;
+	jrn->epoch = s.epoch;
+	jrn->seq = 0;
+	jrn->tail = 0;
+	jrn->base_crc = base_crc;
+out:
+	free(s.buf);
+
+	return ret;
+}
@@ -9,6 +9,7 @@
 #include <common.h>
 
 #include <command.h>
+#include <env_journal.h>
 #include <environment.h>
 #include <fdtdec.h>
 #include <linux/stddef.h>
@@ -27,12 +28,23 @@
 #error CONFIG_ENV_SIZE_REDUND should be the same as CONFIG_ENV_SIZE
 #endif
 
+#if defined(CONFIG_ENV_MMC_JOURNAL) && !defined(CONFIG_SPL_BUILD)
+#define ENV_MMC_JOURNAL
+#ifdef CONFIG_ENV_OFFSET_REDUND
+#error CONFIG_ENV_MMC_JOURNAL cannot be used with CONFIG_ENV_OFFSET_REDUND
+#endif
+#endif
+
 DECLARE_GLOBAL_DATA_PTR;
 
 #if !defined(CONFIG_ENV_OFFSET)
 #define CONFIG_ENV_OFFSET 0
 #endif
 
+#ifdef ENV_MMC_JOURNAL
+static struct env_journal env_mmc_journal;
+#endif
+
 #if CONFIG_IS_ENABLED(OF_CONTROL)
 static inline int mmc_offset_try_partition(const char *str, s64 *val)
 {
@@ -197,6 +209,44 @@ static inline int write_env(struct mmc *mmc, unsigned long size,
 	return (n == blk_cnt) ? 0 : -1;
 }
 
+#ifdef ENV_MMC_JOURNAL
+/* Returns -ENOSPC if the legacy environment has to be written instead */
+static int env_mmc_journal_save(struct mmc *mmc)
+{
+	struct env_journal *jrn = &env_mmc_journal;
+	char *res;
+	ulong len;
+	int ret;
+
+	if (!jrn->image)
+		return -ENOSPC;
+
+	res = malloc(ENV_SIZE);
+	if (!res)
+		return -ENOMEM;
+
+	if (hexport_r(&env_htab, '\0', 0, &res, ENV_SIZE, 0, NULL) < 0) {
+		pr_err("Cannot export environment: errno = %d\n", errno);
+		ret = -EINVAL;
+		goto out;
+	}
+
+	/* hexport_r() clears the whole buffer, the list ends with "\0\0" */
+	for (len = 0; res[len]; len += strlen(res + len) + 1)
+		;
+
+	jrn->priv = mmc;
+	ret = env_journal_save(jrn, res, len);
+	if (!ret)
+		printf("Journal %lu bytes to MMC(%d)... done\n", jrn->written,
+		       mmc_get_env_dev());
+
+out:
+	free(res);
+	return ret;
+}
+#endif
+
 static int env_mmc_save(void)
 {
 	ALLOC_CACHE_ALIGN_BUFFER(env_t, env_new, 1);
@@ -212,6 +262,16 @@ static int env_mmc_save(void)
 		return 1;
 	}
 
+#ifdef ENV_MMC_JOURNAL
+	ret = env_mmc_journal_save(mmc);
+	if (ret != -ENOSPC) {
+		if (ret)
+			printf("Journal to MMC(%d) failed: %d\n", dev, ret);
+		ret = ret ? 1 : 0;
+		goto fini;
+	}
+#endif
+
 	ret = env_export(env_new);
 	if (ret)
 		goto fini;
@@ -236,6 +296,13 @@ static int env_mmc_save(void)
 	puts("done\n");
 	ret = 0;
 
+#ifdef ENV_MMC_JOURNAL
+	/* the journal applied to the previous legacy environment */
+	if (env_mmc_journal.image &&
+	    env_journal_erase(&env_mmc_journal, env_new->crc))
+		puts("Dropping the environment journal failed\n");
+#endif
+
 #ifdef CONFIG_ENV_OFFSET_REDUND
 	gd->env_valid = gd->env_valid == ENV_REDUND ? ENV_VALID : ENV_REDUND;
 #endif
@@ -260,6 +327,64 @@ static inline int read_env(struct mmc *mmc, unsigned long size,
 	return (n == blk_cnt) ? 0 : -1;
 }
 
+#ifdef ENV_MMC_JOURNAL
+static int env_mmc_journal_read(struct env_journal *jrn, ulong offset,
+				ulong len, void *buf)
+{
+	return read_env(jrn->priv, len, CONFIG_ENV_MMC_JOURNAL_OFFSET + offset,
+			buf) ? -EIO : 0;
+}
+
+#ifdef CONFIG_CMD_SAVEENV
+static int env_mmc_journal_write(struct env_journal *jrn, ulong offset,
+				 ulong len, const void *buf)
+{
+	return write_env(jrn->priv, len,
+			 CONFIG_ENV_MMC_JOURNAL_OFFSET + offset, buf) ? -EIO : 0;
+}
+#endif
+
+/*
+ * Replay the journal on top of the legacy environment in @buf. Returns 0 if
+ * the environment was imported from the journal.
+ */
+static int env_mmc_journal_load(struct mmc *mmc, const char *buf)
+{
+	struct env_journal *jrn = &env_mmc_journal;
+	int ret;
+
+	if (!jrn->image) {
+		jrn->image = malloc(ENV_SIZE);
+		if (!jrn->image)
+			return -ENOMEM;
+	}
+	jrn->image_size = ENV_SIZE;
+	jrn->size = CONFIG_ENV_MMC_JOURNAL_SIZE;
+	jrn->blksz = mmc->write_bl_len;
+	jrn->read = env_mmc_journal_read;
+#ifdef CONFIG_CMD_SAVEENV
+	jrn->write = env_mmc_journal_write;
+#endif
+	jrn->priv = mmc;
+
+	ret = env_journal_load(jrn, ((env_t *)buf)->crc);
+	if (ret) {
+		debug("%s: no journal: %d\n", __func__, ret);
+		return ret;
+	}
+
+	if (!himport_r(&env_htab, jrn->image, jrn->image_len + 1, '\0', 0, 0,
+		       0, NULL)) {
+		pr_err("Cannot import journaled environment: errno = %d\n",
+		       errno);
+		return -EINVAL;
+	}
+	gd->flags |= GD_FLG_ENV_READY;
+
+	return 0;
+}
+#endif /* ENV_MMC_JOURNAL */
+
 #ifdef CONFIG_ENV_OFFSET_REDUND
 static int env_mmc_load(void)
 {
@@ -352,6 +477,12 @@ static int env_mmc_load(void)
 		goto fini;
 	}
 
+#ifdef ENV_MMC_JOURNAL
+	if (!env_mmc_journal_load(mmc, buf)) {
+		ret = 0;
+		goto fini;
+	}
+#endif
 	env_import(buf, 1);
 	ret = 0;
 
@@ -7,6 +7,7 @@
 #include <config.h>
 #include <errno.h>
 #include <common.h>
+#include <bootm.h>
 #include <mapmem.h>
 #include <part.h>
 #include <ext4fs.h>
@@ -16,7 +17,9 @@
 #include <ubifs_uboot.h>
 #include <asm/io.h>
 #include <div64.h>
+#include <linux/libfdt.h>
 #include <linux/math64.h>
+#include <linux/sizes.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -507,6 +510,123 @@ int do_size(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
 	return 0;
 }
 
+#ifdef CONFIG_CMD_BOOTI_PLACE
+/*
+ * Return where booti runs the @len bytes at @addr from, if they are the
+ * header of an arm64 Image, as long as reading it there leaves the header
+ * at @addr alone
+ */
+static ulong fs_load_dest(ulong addr, loff_t len)
+{
+	ulong dst, size;
+
+	if (len != LINUX_ARM64_IMAGE_HDR_SIZE ||
+	    booti_image_dest(map_sysmem(addr, len), addr, &dst, &size))
+		return addr;
+	if (dst < addr + len && dst + size > addr)
+		return addr;
+
+	return dst;
+}
+#endif
+
+#ifdef CONFIG_FIT_VERIFY_ON_LOAD
+#define FS_LOAD_FIT_CHUNK	SZ_1M
+
+/*
+ * Read the FIT in @filename of @size bytes, its own tree first and then the
+ * external data in chunks, checking hashes on the way
+ */
+static int fs_load_fit(const char *ifname, const char *dev_part, int fstype,
+		       const char *filename, ulong addr, loff_t size,
+		       loff_t *actread)
+{
+	void *fit = map_sysmem(addr, size);
+	loff_t pos, len, chunk;
+	bool check;
+	int ret;
+
+	pos = min_t(loff_t, fdt_totalsize(fit), size);
+	ret = fs_read(filename, addr, 0, pos, &len);
+	if (ret < 0)
+		return ret;
+	check = !fit_load_verify_start(fit);
+	chunk = check ? FS_LOAD_FIT_CHUNK : size;
+	len = min(size - pos, chunk);
+
+	while (len) {
+		if (fs_set_blk_dev(ifname, dev_part, fstype))
+			return -ENODEV;
+		ret = fs_read(filename, addr + pos, pos, len, &len);
+		if (ret < 0 || !len) {
+			fit_load_verify_reset();
+			return -EIO;
+		}
+		if (check)
+			fit_load_verify_update(pos, len);
+		pos += len;
+		len = min(size - pos, chunk);
+	}
+	*actread = pos;
+
+	return check ? fit_load_verify_finish() : 0;
+}
+#endif
+
+/*
+ * Read all of @filename for 'load' to *@addrp. A look at its header first
+ * lets the hashes of a FIT be checked while it is read and, with @place
+ * ('load -k'), an arm64 Image go straight to where booti runs it. *@addrp
+ * is then updated to that address.
+ */
+static int fs_load_all(const char *ifname, const char *dev_part, int fstype,
+		       const char *filename, ulong *addrp, bool place,
+		       loff_t *actread)
+{
+	ulong addr = *addrp;
+#if defined(CONFIG_CMD_BOOTI_PLACE) || defined(CONFIG_FIT_VERIFY_ON_LOAD)
+#ifdef CONFIG_CMD_BOOTI_PLACE
+	ulong dst;
+#endif
+	loff_t size, len;
+	int ret;
+
+#ifndef CONFIG_FIT_VERIFY_ON_LOAD
+	if (!place)
+		return fs_read(filename, addr, 0, 0, actread);
+#endif
+
+	/* each operation closes the filesystem */
+	if (fs_size(filename, &size) ||
+	    fs_set_blk_dev(ifname, dev_part, fstype))
+		return -ENOENT;
+	ret = fs_read(filename, addr, 0, min_t(loff_t, size, 64), &len);
+	if (ret < 0 || fs_set_blk_dev(ifname, dev_part, fstype))
+		return -EIO;
+
+#ifdef CONFIG_FIT_VERIFY_ON_LOAD
+	if (len >= sizeof(struct fdt_header) &&
+	    fdt_magic(map_sysmem(addr, len)) == FDT_MAGIC)
+		return fs_load_fit(ifname, dev_part, fstype, filename, addr,
+				   size, actread);
+#endif
+#ifdef CONFIG_CMD_BOOTI_PLACE
+	dst = place ? fs_load_dest(addr, len) : addr;
+	if (dst != addr) {
+		ret = fs_read(filename, dst, 0, 0, actread);
+		if (!ret) {
+			booti_image_placed(addr, dst);
+			printf("Image read to 0x%lx, where booti runs it\n",
+			       dst);
+			*addrp = dst;
+		}
+		return ret;
+	}
+#endif
+#endif
+	return fs_read(filename, addr, 0, 0, actread);
+}
+
 int do_load(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
 		int fstype)
 {
@@ -518,8 +638,16 @@ int do_load(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
 	loff_t len_read;
 	int ret;
 	unsigned long time;
+	bool place = false;
 	char *ep;
 
+#ifdef CONFIG_CMD_BOOTI_PLACE
+	if (argc >= 2 && !strcmp(argv[1], "-k")) {
+		place = true;
+		argc--;
+		argv++;
+	}
+#endif
 	if (argc < 2)
 		return CMD_RET_USAGE;
 	if (argc > 7)
@@ -557,8 +685,15 @@ int do_load(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
 	else
 		pos = 0;
 
+#ifdef CONFIG_FIT_VERIFY_ON_LOAD
+	fit_load_verify_reset();
+#endif
 	time = get_timer(0);
-	ret = fs_read(filename, addr, pos, bytes, &len_read);
+	if (!pos && !bytes)
+		ret = fs_load_all(argv[1], (argc >= 3) ? argv[2] : NULL, fstype,
+				  filename, &addr, place, &len_read);
+	else
+		ret = fs_read(filename, addr, pos, bytes, &len_read);
 	time = get_timer(time);
 	if (ret < 0)
 		return 1;
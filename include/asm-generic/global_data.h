@@ -107,6 +107,9 @@ typedef struct global_data {
 	unsigned long malloc_limit;	/* limit address */
 	unsigned long malloc_ptr;	/* current address */
 #endif
+#if CONFIG_IS_ENABLED(SYS_MALLOC_SLAB)
+	struct malloc_slab *malloc_slab;	/* serves small malloc() */
+#endif
 #ifdef CONFIG_PCI
 	struct pci_controller *hose;	/* PCI hose for early use */
 	phys_addr_t pci_ram_top;	/* top of region accessible to PCI */
@@ -267,6 +267,34 @@ struct blk_ops {
 	 * @return 0 if OK, -ve on error
 	 */
 	int (*select_hwpart)(struct udevice *dev, int hwpart);
+
+	/**
+	 * map() - map a range of blocks for reading in place
+	 *
+	 * This is optional, for devices which can show their contents in the
+	 * CPU address space (e.g. a memory-mapped SPI flash). The mapping is
+	 * read only and stays valid until unmap() is called.
+	 *
+	 * @dev:	Device to map
+	 * @start:	Start block number to map (0=first)
+	 * @blkcnt:	Number of blocks to map
+	 * @bufp:	Returns the address of block @start
+	 * @return 0 if OK, -ENOSYS if the range cannot be mapped, other -ve
+	 * on error
+	 */
+	int (*map)(struct udevice *dev, lbaint_t start, lbaint_t blkcnt,
+		   const void **bufp);
+
+	/**
+	 * unmap() - release a mapping made by map()
+	 *
+	 * This is optional.
+	 *
+	 * @dev:	Device the mapping belongs to
+	 * @buf:	Address returned by map()
+	 * @blkcnt:	Number of blocks mapped
+	 */
+	void (*unmap)(struct udevice *dev, const void *buf, lbaint_t blkcnt);
 };
 
 #define blk_get_ops(dev)	((struct blk_ops *)(dev)->driver->ops)
@@ -284,6 +312,45 @@ unsigned long blk_dwrite(struct blk_desc *block_dev, lbaint_t start,
 unsigned long blk_derase(struct blk_desc *block_dev, lbaint_t start,
 			 lbaint_t blkcnt);
 
+/**
+ * struct blk_map - blocks made available by blk_dmap()
+ *
+ * @buf:	Address of the data
+ * @blkcnt:	Number of blocks
+ * @mapped:	true if @buf is a device mapping, false if the blocks were read
+ *		into the caller's buffer
+ */
+struct blk_map {
+	const void *buf;
+	lbaint_t blkcnt;
+	bool mapped;
+};
+
+/**
+ * blk_dmap() - get blocks into the CPU address space, in place if possible
+ *
+ * If the device can map the range its contents are used in place, otherwise
+ * the blocks are read into @buffer. Either way the data is at @map->buf, call
+ * blk_dunmap() when done with it.
+ *
+ * @block_dev:	Block device to read from
+ * @start:	Start block number (0=first)
+ * @blkcnt:	Number of blocks
+ * @buffer:	Buffer for @blkcnt blocks, used if the range cannot be mapped
+ * @map:	Returns where the data is
+ * @return 0 if OK, -ve on error
+ */
+int blk_dmap(struct blk_desc *block_dev, lbaint_t start, lbaint_t blkcnt,
+	     void *buffer, struct blk_map *map);
+
+/**
+ * blk_dunmap() - release the blocks returned by blk_dmap()
+ *
+ * @block_dev:	Block device
+ * @map:	As filled in by blk_dmap()
+ */
+void blk_dunmap(struct blk_desc *block_dev, struct blk_map *map);
+
 /**
  * blk_find_device() - Find a block device
  *
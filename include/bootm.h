@@ -51,6 +51,44 @@ ulong bootm_disable_interrupts(void);
 /* This is a special function used by booti/bootz */
 int bootm_find_images(int flag, int argc, char * const argv[]);
 
+/* Size of the header at the start of an arm64 Image */
+#define LINUX_ARM64_IMAGE_HDR_SIZE	64
+
+/**
+ * booti_image_dest() - Find where booti runs an arm64 Image from
+ *
+ * @ih:		Header of the Image, LINUX_ARM64_IMAGE_HDR_SIZE bytes
+ * @addr:	Address the Image is loaded at
+ * @dstp:	Returns the address booti moves it to, @addr if it stays
+ * @sizep:	Returns the size of the Image in memory, or NULL
+ * @return 0 if OK, -ENOEXEC if @ih is not an arm64 Image
+ */
+int booti_image_dest(const void *ih, ulong addr, ulong *dstp, ulong *sizep);
+
+/**
+ * booti_image_placed() - Note an Image read straight to where it runs
+ *
+ * A loader asked to load an Image at @addr has read it to @dst, where
+ * booti would move it, and only left its header at @addr. booti at @addr
+ * then runs the Image at @dst, provided the headers still match.
+ *
+ * @addr:	Address the Image was to be loaded at
+ * @dst:	Address the Image was read to, from booti_image_dest()
+ */
+void booti_image_placed(ulong addr, ulong dst);
+
+/**
+ * booti_prep() - Prepare to boot an arm64 Image as booti would, but return
+ *
+ * The Image is moved to where its header asks for, and the device tree is
+ * relocated and fixed up, as found in images.ep and images.ft_addr.
+ *
+ * @argc:	Number of arguments
+ * @argv:	Arguments of booti, without the command name
+ * @return 0 if OK, -ve on error
+ */
+int booti_prep(int argc, char * const argv[]);
+
 int do_bootm_states(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
 		    int states, bootm_headers_t *images, int boot_progress);
 
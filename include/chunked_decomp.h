@@ -0,0 +1,76 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __CHUNKED_DECOMP_H
+#define __CHUNKED_DECOMP_H
+
+/*
+ * A chunked image is cut into chunks of the same size, but for the last
+ * one, each compressed on its own, so that they decompress on all CPUs at
+ * once. The chunks are listed in an index, struct chunked_index, which
+ * standard tools skip, so the image is a valid gzip or LZ4 file:
+ *
+ * gzip: one member per chunk, the first one with the index as extra field,
+ * subfield ID CHUNKED_GZIP_SI1, CHUNKED_GZIP_SI2
+ *
+ * LZ4: a skippable frame, magic CHUNKED_LZ4_MAGIC, with the index, then
+ * one frame per chunk
+ *
+ * All values are little-endian. See doc/README.chunked
+ */
+#define CHUNKED_MAGIC		0x4b4e4843	/* "CHNK" */
+#define CHUNKED_GZIP_SI1	'U'
+#define CHUNKED_GZIP_SI2	'C'
+#define CHUNKED_LZ4_MAGIC	0x184d2a55
+
+/**
+ * struct chunked_index - where the chunks of an image are
+ *
+ * @magic:	CHUNKED_MAGIC
+ * @count:	Number of chunks
+ * @chunk_size:	Decompressed size of each chunk but the last
+ * @size:	Decompressed size of the image
+ * @entry:	Chunks, in order
+ * @entry.offset: Offset of the gzip member or LZ4 frame from the start of
+ *		the image
+ * @entry.len:	Its size
+ */
+struct chunked_index {
+	u32 magic;
+	u32 count;
+	u32 chunk_size;
+	u32 size;
+	struct {
+		u32 offset;
+		u32 len;
+	} entry[];
+};
+
+/**
+ * chunked_get_size() - Check for a chunked image
+ *
+ * @comp:	Compression type (IH_COMP_GZIP or IH_COMP_LZ4)
+ * @src:	Image
+ * @len:	Size of the image
+ * @return size it decompresses to, 0 if it is not a valid chunked image
+ */
+ulong chunked_get_size(int comp, const void *src, ulong len);
+
+/**
+ * chunked_decomp() - Decompress a chunked image on all CPUs
+ *
+ * @comp:	Compression type (IH_COMP_GZIP or IH_COMP_LZ4)
+ * @dst:	Where to decompress to
+ * @dst_len:	Space at @dst
+ * @src:	Image
+ * @lenp:	Size of the image, returns the decompressed size
+ * @return 0 if OK, -ENOENT if it is not a chunked image, -ENOBUFS if it
+ *	does not fit at @dst, -EINVAL if a chunk is corrupt
+ */
+int chunked_decomp(int comp, void *dst, ulong dst_len, const void *src,
+		   ulong *lenp);
+
+#endif
@@ -21,6 +21,28 @@ int set_local_var(const char *s, int flg_export);
 void unset_local_var(const char *name);
 char *get_local_var(const char *s);
 
+#ifdef CONFIG_HUSH_CACHE
+/**
+ * struct hush_cache_stats - state of the cache of parsed scripts
+ *
+ * @hits:	Scripts run without parsing them
+ * @misses:	Scripts parsed
+ * @entries:	Scripts in the cache
+ * @bytes:	Memory used by the cached scripts
+ */
+struct hush_cache_stats {
+	ulong hits;
+	ulong misses;
+	uint entries;
+	ulong bytes;
+};
+
+void hush_cache_get_stats(struct hush_cache_stats *stats);
+
+/* Drop all cached scripts, except the ones running */
+void hush_cache_flush(void);
+#endif
+
 #if defined(CONFIG_HUSH_INIT_VAR)
 extern int hush_init_var (void);
 #endif
@@ -10,6 +10,17 @@
 
 #define SPL_EXPORT_FDT		(0x00000001)
 #define SPL_EXPORT_ATAGS	(0x00000002)
-#define SPL_EXPORT_LAST		SPL_EXPORT_ATAGS
+#define SPL_EXPORT_FALCON	(0x00000003)
+#define SPL_EXPORT_LAST		SPL_EXPORT_FALCON
+
+/**
+ * spl_export_falcon() - Store a kernel and device tree for Falcon mode
+ *
+ * @argc:	Number of arguments
+ * @argv:	<kernel_addr> <fdt_addr> <part> <kernel_file> <fdt_file>, or
+ *		"off" to boot U-Boot again
+ * @return 0 if OK, CMD_RET_USAGE on bad arguments, -ve on error
+ */
+int spl_export_falcon(int argc, char * const argv[]);
 
 #endif /* _NAND_SPL_H_ */
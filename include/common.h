@@ -470,6 +470,7 @@ int board_postclk_init (void); /* after clocks/timebase, before env/serial */
 int board_early_init_r (void);
 void board_poweroff (void);
 void board_env_fixup(void);
+void board_idle_poll(void); /* while waiting for console input */
 
 #if defined(CONFIG_SYS_DRAM_TEST)
 int testdram(void);
@@ -665,6 +666,14 @@ int gzwrite(unsigned char *src, int len,
 
 /* lib/lz4_wrapper.c */
 bool lz4_is_valid_header(const unsigned char *h);
+/**
+ * lz4_get_content_size() - get the decompressed size from an LZ4 frame
+ *
+ * @h:		Start of the frame
+ * @len:	Bytes available at @h
+ * @return decompressed size, or 0 if the frame header does not give it
+ */
+u64 lz4_get_content_size(const void *h, size_t len);
 int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn);
 
 /* lib/qsort.c */
@@ -16,6 +16,12 @@
 #ifdef CONFIG_SD_BOOT
 #define CONFIG_ENV_SIZE		(32 * SZ_1K)
 #define CONFIG_ENV_OFFSET	(1024 * SZ_1K)
+#ifdef CONFIG_ENV_MMC_JOURNAL
+/* the journal sits right below the environment */
+#undef CONFIG_ENV_MMC_JOURNAL_OFFSET
+#define CONFIG_ENV_MMC_JOURNAL_OFFSET \
+		(CONFIG_ENV_OFFSET - CONFIG_ENV_MMC_JOURNAL_SIZE)
+#endif
 #define ENV_DEV_TYPE \
 		"devtype=mmc\0"
 #define ENV_DEV_NUM \
@@ -70,6 +76,7 @@
 #undef CONFIG_EXTRA_ENV_SETTINGS
 #define CONFIG_EXTRA_ENV_SETTINGS	\
 	"fdt_addr_r=0x01f00000\0" \
+	"kernel_addr_r=0x02280000\0" \
 	"loadaddr=0x100000\0" \
 	ENV_DEV_TYPE \
 	ENV_DEV_NUM \
@@ -83,9 +90,9 @@
 		"rw root=/dev/mmcblk0p2 rootwait rw fsck.repair=yes "	\
 		"net.iframes=0 fbcon=rotate:${lcd_rotate}\0"	\
 	"bootcmd=mmc dev 1; cfgload; run setbootargs;"	\
-		"load mmc 1:1 0x02000000 Image; "		\
-		"load mmc 1:1 0x01f00000 ${dtb_name}; "	\
-		"booti 0x02000000 - 0x01f00000\0"
+		"load -k mmc 1:1 ${kernel_addr_r} Image; "	\
+		"load mmc 1:1 ${fdt_addr_r} ${dtb_name}; "	\
+		"booti ${kernel_addr_r} - ${fdt_addr_r}\0"
 
 #undef CONFIG_BOOTDELAY
 #define CONFIG_BOOTDELAY	1
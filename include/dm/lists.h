@@ -13,6 +13,8 @@
 #include <dm/ofnode.h>
 #include <dm/uclass-id.h>
 
+struct udevice_id;
+
 /**
  * lists_driver_lookup_name() - Return u_boot_driver corresponding to name
  *
@@ -33,6 +35,19 @@ struct driver *lists_driver_lookup_name(const char *name);
  */
 struct uclass_driver *lists_uclass_lookup(enum uclass_id id);
 
+/**
+ * lists_driver_lookup_compat() - Return the driver for a compatible string
+ *
+ * This returns the first driver, in linker list order, which has @compat in
+ * its of_match table.
+ *
+ * @compat: Compatible string to look up
+ * @idp: Returns the entry of the driver's of_match table which matched
+ * @return pointer to driver, or NULL if not found
+ */
+struct driver *lists_driver_lookup_compat(const char *compat,
+					  const struct udevice_id **idp);
+
 /**
  * lists_bind_drivers() - search for and bind all drivers to parent
  *
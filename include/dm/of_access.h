@@ -413,6 +413,18 @@ int of_count_phandle_with_args(const struct device_node *np,
  */
 int of_alias_scan(void);
 
+/**
+ * of_index_build() - Index the phandles and compatible strings of the tree
+ *
+ * Builds hash tables of the nodes of gd->of_root by phandle and by each of
+ * their compatible strings, which of_find_node_by_phandle() and
+ * of_find_compatible_node() then use instead of walking the tree. They are
+ * dropped when the index is built for another tree.
+ *
+ * @return 0 if OK, -ENOMEM if not enough memory
+ */
+int of_index_build(void);
+
 /**
  * of_alias_get_id - Get alias id for the given device_node
  *
@@ -0,0 +1,135 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __ENV_JOURNAL_H
+#define __ENV_JOURNAL_H
+
+/*
+ * The journal area is split in two halves of the same size. The current
+ * half starts with a snapshot of the whole environment, followed by the
+ * changes made by every later "saveenv":
+ *
+ *   START SNAPSHOT COMMIT | SET DELETE ... COMMIT | SET ... COMMIT | ...
+ *
+ * Every save starts on a block boundary and is written block by block, so
+ * blocks holding committed saves are never written again. A save only counts
+ * once its COMMIT record has reached the storage. When the next save does not
+ * fit in the current half, a new snapshot is written to the other half with
+ * the next epoch. On load the half with the newest epoch holding a committed
+ * snapshot wins.
+ *
+ * START carries the CRC of the legacy environment block the journal applies
+ * to. If that block is rewritten by something else (an older U-Boot,
+ * fw_setenv, ...) the journal no longer matches and is ignored.
+ */
+#define ENV_JOURNAL_MAGIC	0x4c4e524a	/* "JRNL" */
+
+enum env_journal_op {
+	ENV_JOURNAL_START = 1,	/* value: CRC of the legacy environment */
+	ENV_JOURNAL_SNAPSHOT,	/* value: whole environment image */
+	ENV_JOURNAL_SET,	/* name, value */
+	ENV_JOURNAL_DELETE,	/* name */
+	ENV_JOURNAL_COMMIT,
+};
+
+/* Record header, followed by name and value, padded to 4 bytes */
+struct env_journal_rec {
+	u32 magic;
+	u32 epoch;		/* epoch of the half the record belongs to */
+	u32 seq;		/* save number within the half */
+	u8 op;			/* enum env_journal_op */
+	u8 reserved;
+	u16 name_len;
+	u32 value_len;
+	u32 crc;		/* crc32 of header (crc = 0), name and value */
+};
+
+/**
+ * struct env_journal - an environment journal on some storage
+ *
+ * The environment image is a list of "name=value" strings, each terminated
+ * by '\0' and sorted by name, as produced by hexport_r() with a '\0'
+ * separator.
+ *
+ * @size:	Size of the whole journal area in bytes, two halves
+ * @blksz:	Write block size of the storage
+ * @read:	Read @len bytes at @offset into the journal area to @buf
+ * @write:	Write @len bytes at @offset into the journal area from @buf
+ * @priv:	Private data for @read and @write
+ * @image:	Environment image, valid when @half >= 0
+ * @image_len:	Bytes used in @image, not counting the final '\0'
+ * @image_size:	Size of @image
+ * @half:	Half holding the journal, -1 if there is no valid journal
+ * @epoch:	Epoch of @half, or the newest epoch seen
+ * @seq:	Number of the last save committed in @half
+ * @tail:	Offset in @half where the next save goes
+ * @base_crc:	CRC of the legacy environment the journal applies to
+ * @written:	Bytes written by the last env_journal_save()
+ */
+struct env_journal {
+	ulong size;
+	uint blksz;
+	int (*read)(struct env_journal *jrn, ulong offset, ulong len,
+		    void *buf);
+	int (*write)(struct env_journal *jrn, ulong offset, ulong len,
+		     const void *buf);
+	void *priv;
+
+	char *image;
+	ulong image_len;
+	ulong image_size;
+
+	int half;
+	u32 epoch;
+	u32 seq;
+	ulong tail;
+	u32 base_crc;
+	ulong written;
+};
+
+/**
+ * env_journal_load() - Replay the journal
+ *
+ * The caller sets up @size, @blksz, @read, @write, @priv, @image and
+ * @image_size. Saves which are not complete are ignored.
+ *
+ * @jrn:	Journal
+ * @base_crc:	CRC of the legacy environment read from the storage
+ * @return 0 if @jrn->image holds the environment, -ENOENT if there is no
+ * journal, -ESTALE if the journal belongs to another legacy environment,
+ * other -ve on error. In all cases the journal can be saved to afterwards.
+ */
+int env_journal_load(struct env_journal *jrn, u32 base_crc);
+
+/**
+ * env_journal_save() - Record a new environment
+ *
+ * Only the variables which differ from @jrn->image are written. If they do
+ * not fit in the current half, the whole environment is written to the other
+ * half instead.
+ *
+ * @jrn:	Journal
+ * @image:	New environment image
+ * @len:	Length of @image, not counting the final '\0'
+ * @return 0 if OK, -ENOSPC if the environment does not fit in a half,
+ * other -ve on error
+ */
+int env_journal_save(struct env_journal *jrn, const char *image, ulong len);
+
+/**
+ * env_journal_erase() - Drop the journal
+ *
+ * Call this after writing the legacy environment, so that the next save
+ * starts a new journal on top of it. Both halves are started with an epoch
+ * newer than any on the storage, so older saves are never replayed.
+ *
+ * @jrn:	Journal
+ * @base_crc:	CRC of the legacy environment just written
+ * @return 0 if OK, -ve on error
+ */
+int env_journal_erase(struct env_journal *jrn, u32 base_crc);
+
+#endif
@@ -885,6 +885,18 @@ int bootz_setup(ulong image, ulong *start, ulong *end);
 
 #define FIT_IMAGES_PATH		"/images"
 #define FIT_CONFS_PATH		"/configurations"
+#define FIT_INDEX_PATH		"/index"
+
+/*
+ * index node, added by mkimage -I: each property lists pairs of the CRC32
+ * of a name or compatible string and the offset of the node it belongs
+ * to, sorted by both
+ */
+#define FIT_INDEX_NODENAME	"index"
+#define FIT_INDEX_IMAGES_PROP	"images"
+#define FIT_INDEX_CONFS_PROP	"configurations"
+#define FIT_INDEX_COMPAT_PROP	"compatibles"
+#define FIT_INDEX_SIZE_PROP	"struct-size"
 
 /* hash/signature node */
 #define FIT_HASH_NODENAME	"hash"
@@ -896,6 +908,7 @@ int bootz_setup(ulong image, ulong *start, ulong *end);
 /* image node */
 #define FIT_DATA_PROP		"data"
 #define FIT_DATA_OFFSET_PROP	"data-offset"
+#define FIT_DATA_POSITION_PROP	"data-position"
 #define FIT_DATA_SIZE_PROP	"data-size"
 #define FIT_TIMESTAMP_PROP	"timestamp"
 #define FIT_DESC_PROP		"description"
@@ -976,7 +989,11 @@ int fit_image_get_entry(const void *fit, int noffset, ulong *entry);
 int fit_image_get_data(const void *fit, int noffset,
 				const void **data, size_t *size);
 int fit_image_get_data_offset(const void *fit, int noffset, int *data_offset);
+int fit_image_get_data_position(const void *fit, int noffset,
+				int *data_position);
 int fit_image_get_data_size(const void *fit, int noffset, int *data_size);
+int fit_image_get_data_and_size(const void *fit, int noffset,
+				const void **data, size_t *size);
 
 int fit_image_hash_get_algo(const void *fit, int noffset, char **algo);
 int fit_image_hash_get_value(const void *fit, int noffset, uint8_t **value,
@@ -1011,6 +1028,44 @@ int fit_add_verification_data(const char *keydir, void *keydest, void *fit,
 int fit_image_verify(const void *fit, int noffset);
 int fit_config_verify(const void *fit, int conf_noffset);
 int fit_all_image_verify(const void *fit);
+
+/**
+ * fit_load_verify_start() - Start checking hashes while a FIT is loaded
+ *
+ * The FIT's own tree must be in memory. The hashes of images with external
+ * data are then computed as fit_load_verify_update() reports their data
+ * loaded, and the next fit_image_verify() of these images does not compute
+ * them again, unless a required signature key is present.
+ *
+ * @fit:	FIT being loaded
+ * @return 0 if OK, -ENOENT if there is nothing to check while loading,
+ *	-ENOMEM if out of memory
+ */
+int fit_load_verify_start(const void *fit);
+
+/**
+ * fit_load_verify_update() - Hash data which has been loaded
+ *
+ * Data must be loaded in order, with no gaps.
+ *
+ * @offset:	Offset in the FIT of the data just loaded
+ * @len:	Size of the data just loaded
+ */
+void fit_load_verify_update(ulong offset, ulong len);
+
+/**
+ * fit_load_verify_finish() - Finish and show the hashes of a loaded FIT
+ *
+ * @return 0 if all hashes match, -EBADMSG otherwise
+ */
+int fit_load_verify_finish(void);
+
+/**
+ * fit_load_verify_reset() - Forget the hashes checked while loading
+ *
+ * This is called when anything else is loaded, which may overwrite the FIT.
+ */
+void fit_load_verify_reset(void);
 int fit_image_check_os(const void *fit, int noffset, uint8_t os);
 int fit_image_check_arch(const void *fit, int noffset, uint8_t arch);
 int fit_image_check_type(const void *fit, int noffset, uint8_t type);
@@ -1074,6 +1129,13 @@ void image_set_host_blob(void *host_blob);
 #define IMAGE_ENABLE_BEST_MATCH	0
 #endif
 
+#if defined(CONFIG_FIT_INDEX) && !defined(USE_HOSTCC) && \
+	!defined(CONFIG_SPL_BUILD)
+#define IMAGE_ENABLE_FIT_INDEX	1
+#else
+#define IMAGE_ENABLE_FIT_INDEX	0
+#endif
+
 /* Information passed to the signing routines */
 struct image_sign_info {
 	const char *keydir;		/* Directory conaining keys */
@@ -957,6 +957,26 @@ extern ulong mem_malloc_brk;
 
 void mem_malloc_init(ulong start, ulong size);
 
+/**
+ * struct malloc_frag - free space of the heap
+ *
+ * @free:	Bytes free, including what sbrk() has not handed out yet
+ * @largest:	Largest free chunk, the largest allocation that can succeed
+ * @chunks:	Free chunks
+ */
+struct malloc_frag {
+	ulong free;
+	ulong largest;
+	ulong chunks;
+};
+
+/**
+ * malloc_frag() - Measure the fragmentation of the heap
+ *
+ * @frag:	Returns the free space, zero before mem_malloc_init()
+ */
+void malloc_frag(struct malloc_frag *frag);
+
 #ifdef __cplusplus
 };  /* end of extern "C" */
 #endif
@@ -0,0 +1,136 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __MALLOC_SLAB_H
+#define __MALLOC_SLAB_H
+
+/*
+ * Small allocations are served from pages of same-sized objects, one set of
+ * pages per size class. The pages sit in a region of their own, so free()
+ * knows a slab object from its address and the page holding it tells its
+ * size class. Requests larger than the largest class, or for which no page
+ * is left, go to the general allocator.
+ */
+#define MALLOC_SLAB_MAX		512	/* largest size class */
+#define MALLOC_SLAB_CLASSES	10
+#define MALLOC_SLAB_NONE	0xffff	/* no page */
+
+/**
+ * struct malloc_slab_page - a page of the slab region
+ *
+ * @free:	Freed objects of the page, linked through their first word
+ * @next:	Next page in the list the page is on
+ * @prev:	Previous page in the list the page is on
+ * @inuse:	Objects allocated from the page
+ * @carved:	Objects handed out from the page since it was last empty
+ * @cls:	Size class of the page
+ */
+struct malloc_slab_page {
+	void *free;
+	u16 next;
+	u16 prev;
+	u16 inuse;
+	u16 carved;
+	u8 cls;
+};
+
+/**
+ * struct malloc_slab_class - a size class
+ *
+ * @size:	Object size
+ * @per_page:	Objects per page
+ * @partial:	First page with free objects, MALLOC_SLAB_NONE if none
+ * @pages:	Pages in use by the class
+ * @inuse:	Objects allocated
+ * @peak:	Highest value of @inuse
+ * @allocs:	Allocations served
+ * @fails:	Allocations passed on because no page was left
+ */
+struct malloc_slab_class {
+	u16 size;
+	u16 per_page;
+	u16 partial;
+	u16 pages;
+	ulong inuse;
+	ulong peak;
+	ulong allocs;
+	ulong fails;
+};
+
+/**
+ * struct malloc_slab - a slab region
+ *
+ * @start:	Address of the first page
+ * @page_shift:	log2 of the page size
+ * @num_pages:	Pages in the region
+ * @used_pages:	Pages handed out at least once, the next one comes after
+ * @free_pages:	First page given back when it became empty
+ * @cls:	Size classes
+ * @page:	Page descriptors
+ */
+struct malloc_slab {
+	ulong start;
+	uint page_shift;
+	uint num_pages;
+	uint used_pages;
+	u16 free_pages;
+	struct malloc_slab_class cls[MALLOC_SLAB_CLASSES];
+	struct malloc_slab_page page[];
+};
+
+/**
+ * malloc_slab_init() - Set up a slab region
+ *
+ * The descriptors are placed at the start of the region, the pages follow.
+ *
+ * @base:	Start of the region
+ * @size:	Size of the region
+ * @page_shift:	log2 of the page size, at least log2(MALLOC_SLAB_MAX)
+ * @return the slab, or NULL if the region is too small
+ */
+struct malloc_slab *malloc_slab_init(ulong base, ulong size, uint page_shift);
+
+/**
+ * malloc_slab_alloc() - Allocate a small object
+ *
+ * @slab:	Slab to allocate from
+ * @bytes:	Size of the object, at most MALLOC_SLAB_MAX
+ * @return object, aligned to 16 bytes, or NULL if no page is left
+ */
+void *malloc_slab_alloc(struct malloc_slab *slab, size_t bytes);
+
+/**
+ * malloc_slab_free() - Free an object from malloc_slab_alloc()
+ *
+ * @slab:	Slab holding @ptr
+ * @ptr:	Object to free
+ */
+void malloc_slab_free(struct malloc_slab *slab, void *ptr);
+
+/**
+ * malloc_slab_size() - Get the usable size of an object
+ *
+ * @slab:	Slab holding @ptr
+ * @ptr:	Object
+ * @return the size of its class
+ */
+size_t malloc_slab_size(struct malloc_slab *slab, const void *ptr);
+
+/* Check whether @ptr was allocated from @slab, which may be NULL */
+static inline bool malloc_slab_owns(struct malloc_slab *slab, const void *ptr)
+{
+	return slab && (ulong)ptr - slab->start <
+		((ulong)slab->num_pages << slab->page_shift);
+}
+
+/**
+ * malloc_slab_stats() - Print the state of every size class
+ *
+ * @slab:	Slab to show
+ */
+void malloc_slab_stats(struct malloc_slab *slab);
+
+#endif
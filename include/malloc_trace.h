@@ -0,0 +1,96 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __MALLOC_TRACE_H
+#define __MALLOC_TRACE_H
+
+/*
+ * Each live allocation from the malloc() heap or from sysmem is kept in a
+ * hash table by address, with its size, call site, owner and time of
+ * allocation. Totals are kept per call site and per owner: the command
+ * being run or the uclass of the device being bound or probed, for sysmem
+ * the name of the region. All tables are set up once at the end of the
+ * heap, so tracing never allocates and costs a hash lookup per call.
+ */
+
+#if CONFIG_IS_ENABLED(MALLOC_TRACE)
+/**
+ * malloc_trace_size() - Get the space the tracer needs
+ *
+ * @return size in bytes
+ */
+ulong malloc_trace_size(void);
+
+/**
+ * malloc_trace_init() - Start tracing
+ *
+ * @base:	Start of malloc_trace_size() bytes for the tables
+ */
+void malloc_trace_init(ulong base);
+
+/**
+ * malloc_trace_alloc() - Record an allocation from the heap
+ *
+ * @ptr:	Memory allocated, nothing is recorded if NULL
+ * @size:	Size requested
+ * @site:	Return address of the allocation call
+ */
+void malloc_trace_alloc(const void *ptr, ulong size, const void *site);
+
+/**
+ * malloc_trace_free() - Record that heap memory was freed
+ *
+ * @ptr:	Memory freed, may be NULL or memory allocated untraced
+ */
+void malloc_trace_free(const void *ptr);
+
+/**
+ * malloc_trace_sysmem_alloc() - Record an allocated sysmem region
+ *
+ * @name:	Name of the region, which is its owner
+ * @base:	Start of the region
+ * @size:	Size of the region
+ * @site:	Return address of the sysmem_alloc*() call
+ */
+void malloc_trace_sysmem_alloc(const char *name, ulong base, ulong size,
+			       const void *site);
+
+/**
+ * malloc_trace_sysmem_free() - Record that a sysmem region was freed
+ *
+ * @base:	Start of the region
+ */
+void malloc_trace_sysmem_free(ulong base);
+
+/**
+ * malloc_trace_owner() - Charge the following allocations to an owner
+ *
+ * @name:	Name of the owner, NULL for none. Must stay valid.
+ * @return the previous owner, to be set back afterwards
+ */
+const char *malloc_trace_owner(const char *name);
+
+/**
+ * malloc_trace_show() - Print the totals and the top consumers
+ *
+ * @top:	Number of owners and call sites to show
+ */
+void malloc_trace_show(int top);
+#else
+static inline void malloc_trace_alloc(const void *ptr, ulong size,
+				      const void *site) {}
+static inline void malloc_trace_free(const void *ptr) {}
+static inline void malloc_trace_sysmem_alloc(const char *name, ulong base,
+					     ulong size, const void *site) {}
+static inline void malloc_trace_sysmem_free(ulong base) {}
+
+static inline const char *malloc_trace_owner(const char *name)
+{
+	return NULL;
+}
+#endif
+
+#endif
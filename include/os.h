@@ -156,6 +156,27 @@ void os_free(void *ptr);
  */
 void *os_realloc(void *ptr, size_t length);
 
+/**
+ * Map part of a file into memory, read only
+ *
+ * Changes made to the file through its file descriptor are visible in the
+ * mapping.
+ *
+ * \param fd		File descriptor as returned by os_open()
+ * \param offset	File offset of the first byte to map
+ * \param length	Number of bytes to map
+ * \return pointer to the byte at offset, or NULL on error
+ */
+const void *os_mmap_file(int fd, off_t offset, size_t length);
+
+/**
+ * Release a mapping made by os_mmap_file()
+ *
+ * \param ptr		Pointer returned by os_mmap_file()
+ * \param length	Number of bytes mapped
+ */
+void os_munmap_file(const void *ptr, size_t length);
+
 /**
  * Access to the usleep function of the os
  *
@@ -0,0 +1,162 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:     GPL-2.0+
+ */
+
+#ifndef _CHARGE_ANIM_H_
+#define _CHARGE_ANIM_H_
+
+#include <video.h>
+
+/*
+ * Charge animation container, all fields are little endian:
+ *
+ *   struct charge_anim_header
+ *   struct charge_anim_frame[frame_num]
+ *   frame data, every frame starts on a CHARGE_ANIM_ALIGN boundary
+ *
+ * Frame data is a list of runs, each one is a struct charge_anim_run followed
+ * by 'len' pixels in frame buffer byte order, padded to 4 bytes. The list
+ * ends with a run whose 'len' is 0. A key frame covers the whole picture, a
+ * delta frame only holds the pixels which differ from the previous frame.
+ * Pixels are stored as the frame buffer is scanned out, i.e. any rotation is
+ * applied by the image tool (tools/mkchargeanim.py).
+ */
+#define CHARGE_ANIM_MAGIC		"CANM"
+#define CHARGE_ANIM_VERSION		1
+#define CHARGE_ANIM_ALIGN		512
+#define CHARGE_ANIM_MAX_FRAMES		16
+
+#define CHARGE_ANIM_FRAME_KEY		BIT(0)
+
+struct charge_anim_header {
+	char magic[4];
+	u16 version;
+	u16 frame_num;
+	u16 width;
+	u16 height;
+	u8 bytes_pp;
+	u8 reserved[3];
+	u32 size;		/* total container size in bytes */
+};
+
+struct charge_anim_frame {
+	u32 offset;		/* bytes from the container start */
+	u32 size;		/* encoded size in bytes */
+	u16 flags;		/* CHARGE_ANIM_FRAME_xxx */
+	u16 reserved;
+};
+
+struct charge_anim_run {
+	u16 y;
+	u16 x;
+	u16 len;		/* pixels, 0 terminates the frame */
+	u16 reserved;
+};
+
+/**
+ * struct charge_anim - a charge animation being played
+ *
+ * Encoded frames are read into @buf at their container offset and stay there,
+ * so every frame is read from storage only once. Reading is done frame by
+ * frame by charge_anim_prefetch() while the previous frame is on screen.
+ *
+ * @name:	Container file name
+ * @read:	Read @len bytes at @offset of the container into @buf
+ * @buf:	Buffer holding the whole container
+ * @hdr:	Container header, at the start of @buf
+ * @frames:	Frame table, follows @hdr
+ * @loaded:	Bitmap of frames already read into @buf
+ * @cur:	Frame currently in the frame buffer, -1 if unknown
+ * @video:	Video device to draw on
+ */
+struct charge_anim {
+	const char *name;
+	int (*read)(struct charge_anim *anim, void *buf, ulong offset,
+		    ulong len);
+	void *buf;
+	struct charge_anim_header *hdr;
+	struct charge_anim_frame *frames;
+	u32 loaded;
+	int cur;
+	struct udevice *video;
+};
+
+/**
+ * charge_anim_open() - Read the container header and frame table
+ *
+ * @anim:	Animation to set up
+ * @name:	Container file name
+ * @buf:	Buffer for the container
+ * @buf_size:	Size of @buf in bytes
+ * @return 0 if OK, -ENOENT if there is no container, other -ve on error
+ */
+int charge_anim_open(struct charge_anim *anim, const char *name,
+		     void *buf, ulong buf_size);
+
+/**
+ * charge_anim_parse() - Check the container header and frame table
+ *
+ * They are converted to CPU byte order in place.
+ *
+ * @anim:	Animation, with @name and @buf set and the first
+ *		CHARGE_ANIM_ALIGN bytes of the container in @buf
+ * @buf_size:	Size of @buf in bytes
+ * @return 0 if OK, -EINVAL if the container is malformed or does not match
+ *	the display, -ENOSPC if it does not fit in @buf, other -ve on error
+ */
+int charge_anim_parse(struct charge_anim *anim, ulong buf_size);
+
+/**
+ * charge_anim_show() - Draw a frame into the frame buffer
+ *
+ * If @idx follows the frame currently shown only its delta is applied,
+ * otherwise decoding restarts from the closest preceding key frame. Only the
+ * rows touched are flushed from the data cache.
+ *
+ * @anim:	Animation
+ * @idx:	Frame index
+ * @return 0 if OK, -ve on error
+ */
+int charge_anim_show(struct charge_anim *anim, int idx);
+
+/**
+ * charge_anim_prefetch() - Read one frame which is not loaded yet
+ *
+ * Frames are read in playing order starting after the current frame. Call
+ * this while a frame is displayed, so that the next charge_anim_show() does
+ * not need to wait for storage.
+ *
+ * @anim:	Animation
+ * @return 1 if a frame was read, 0 if all frames are loaded, -ve on error
+ */
+int charge_anim_prefetch(struct charge_anim *anim);
+
+/**
+ * charge_anim_invalidate() - Forget what the frame buffer holds
+ *
+ * Call this when anything else has drawn into the frame buffer, e.g. text
+ * over the picture, so the next charge_anim_show() starts from a key frame.
+ * A delta frame would leave such pixels in place where it does not change.
+ *
+ * @anim:	Animation
+ */
+static inline void charge_anim_invalidate(struct charge_anim *anim)
+{
+	anim->cur = -1;
+}
+
+/**
+ * charge_anim_apply() - Apply the runs of one encoded frame to a surface
+ *
+ * @dst:	Surface to draw on, must match the container geometry
+ * @data:	Encoded frame
+ * @size:	Size of @data in bytes
+ * @y0, @y1:	Updated with the range of rows written [y0, y1)
+ * @return 0 if OK, -EINVAL if the frame is malformed
+ */
+int charge_anim_apply(const struct video_surface *dst, const void *data,
+		      ulong size, int *y0, int *y1);
+
+#endif
@@ -17,4 +17,10 @@
  * @return:	0 on success, -ve on error
  */
 int rksfc_scan_namespace(void);
+
+/**
+ * rksfc_print_stats - print the transfer counters of the RK SFC controller
+ * and the read counters of the SPI Nand driver
+ */
+void rksfc_print_stats(void);
 #endif
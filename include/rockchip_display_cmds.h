@@ -68,6 +68,13 @@ struct lcd {
 	unsigned char rot;
 //	bool bgr;
 	bool transp;
+	/* double buffer : drm_fb_mem is always the drawing (back) buffer */
+	unsigned long fb_mem[2];
+	unsigned char front;
+	bool dbuf;
+	/* damaged framebuffer rows since the last flip [y0, y1) */
+	unsigned int dirty_y0;
+	unsigned int dirty_y1;
 };
 
 /*----------------------------------------------------------------------------*/
@@ -93,6 +100,19 @@ int lcd_settransp(unsigned long transp);
 int lcd_gettransp(void);
 int lcd_show_logo(void);
 unsigned long lcd_get_mem(void);
+int lcd_set_dbuf(bool enable);
+int lcd_flip(void);
+
+/*----------------------------------------------------------------------------*/
+/* console background pixel value (0xRRGGBB), clr if lcd is not initialized */
+static inline u32 lcd_bg_colour(u32 clr)
+{
+	struct lcd_fb_bit *bg = lcd_getbg();
+
+	if (bg == NULL)
+		return clr & 0xffffff;
+	return bg->r << 16 | bg->g << 8 | bg->b;
+}
 
 /*----------------------------------------------------------------------------*/
 #endif	// #define _ROCKCHIP_DISPLAY_CMDS_H_
@@ -39,8 +39,9 @@ typedef struct entry {
 	int flags;
 } ENTRY;
 
-/* Opaque type for internal use.  */
+/* Opaque types for internal use.  */
 struct _ENTRY;
+struct htab_chunk;
 
 /*
  * Family of hash table handling functions.  The functions also
@@ -53,6 +54,12 @@ struct hsearch_data {
 	struct _ENTRY *table;
 	unsigned int size;
 	unsigned int filled;
+#ifdef CONFIG_HASHTABLE_ARENA
+	struct htab_chunk *arena;	/* storage for keys and values */
+	unsigned int first;		/* entries in iteration order */
+	unsigned int last;
+	int sorted;			/* iteration order is key order */
+#endif
 /*
  * Callback function which will check whether the given change for variable
  * "__item" to "newval" may be applied or not, and possibly apply such change.
@@ -0,0 +1,114 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __SMP_JOB_H
+#define __SMP_JOB_H
+
+/*
+ * Jobs run on all CPUs: the boot CPU submits a function and its argument
+ * to a queue which every CPU takes jobs from in turn, the boot CPU too
+ * while it waits for them. Secondary CPUs are started on first use and
+ * powered down again before an OS starts, see smp_job_stop().
+ *
+ * A job may run on any CPU, at the same time as others, so it must only
+ * work on the memory given to it. The rules for a job are:
+ *
+ * - no console: no printf(), puts() or debug() output
+ * - no driver, device tree or timer call; library code calling
+ *   WATCHDOG_RESET() makes a driver call on boards with a hardware watchdog
+ * - no malloc() or free(), and no global state other than its own
+ * - no submitting, waiting for or stopping jobs
+ *
+ * Memory copies, decompression, checksums and hashes qualify. Jobs are
+ * submitted from U-Boot proper after relocation, on the boot CPU only.
+ */
+
+typedef void (*smp_job_func)(void *arg);
+typedef void (*smp_job_range_func)(void *arg, ulong start, ulong end);
+
+/**
+ * smp_job_cpus() - Get the number of CPUs running jobs
+ *
+ * Secondary CPUs are started if they are not running yet.
+ *
+ * @return number of CPUs, 1 if jobs only run on the boot CPU
+ */
+uint smp_job_cpus(void);
+
+/**
+ * smp_job_cpu() - Get the CPU a job runs on
+ *
+ * For per-CPU scratch memory, allocated before submitting the jobs.
+ *
+ * @return 0 for the boot CPU, up to smp_job_cpus() - 1
+ */
+uint smp_job_cpu(void);
+
+/**
+ * smp_job_submit() - Queue a job
+ *
+ * If the queue is full, the boot CPU runs jobs until there is room.
+ *
+ * @func:	Function to call, on any CPU
+ * @arg:	Argument to pass it
+ */
+void smp_job_submit(smp_job_func func, void *arg);
+
+/**
+ * smp_job_wait() - Run jobs until all those submitted are finished
+ */
+void smp_job_wait(void);
+
+/**
+ * smp_job_for() - Run a function over a range on all CPUs
+ *
+ * [0, @count) is split into a few pieces per CPU, each a multiple of @grain
+ * but for the last one, and @func is called for each piece as a job. Then
+ * this waits for all jobs, like smp_job_wait().
+ *
+ * @count:	Size of the range, e.g. the number of buffers or bytes
+ * @grain:	Smallest piece worth a job, at least 1
+ * @func:	Function to call with @arg and the piece [start, end)
+ * @arg:	Argument to pass it
+ */
+void smp_job_for(ulong count, ulong grain, smp_job_range_func func,
+		 void *arg);
+
+/**
+ * smp_job_stop() - Power down the secondary CPUs
+ *
+ * Jobs still queued are finished first. An OS expects to start secondary
+ * CPUs itself, so this is called before starting one. Jobs submitted later
+ * start the CPUs again.
+ */
+void smp_job_stop(void);
+
+/**
+ * smp_job_secondary() - Run jobs on a secondary CPU
+ *
+ * Called by the architecture on each CPU it starts, with the MMU and caches
+ * set up as on the boot CPU. Returns when smp_job_stop() is called, then
+ * the CPU is to power down.
+ */
+void smp_job_secondary(void);
+
+/*
+ * Provided by the architecture, the defaults run all jobs on the boot CPU:
+ *
+ * smp_job_arch_start() starts at most @max secondary CPUs, numbered from 1,
+ * which call smp_job_secondary(), and returns how many it started.
+ * smp_job_arch_stop() waits for them to power down after it returns.
+ * smp_job_arch_kick() wakes up all CPUs waiting in smp_job_arch_idle(),
+ * which may also return for no reason. smp_job_arch_cpu() gives the number
+ * of the CPU calling it.
+ */
+uint smp_job_arch_start(uint max);
+void smp_job_arch_stop(void);
+void smp_job_arch_kick(void);
+void smp_job_arch_idle(void);
+uint smp_job_arch_cpu(void);
+
+#endif
@@ -28,6 +28,7 @@ struct spl_image_info {
 #if CONFIG_IS_ENABLED(ATF)
 	uintptr_t entry_point_bl32;
 	uintptr_t entry_point_bl33;
+	void *fdt_addr_bl33;		/* Set if BL33 is Linux, for its x0 */
 #endif
 #if CONFIG_IS_ENABLED(LOAD_FIT)
 	void *fdt_addr;
@@ -70,6 +71,42 @@ struct spl_load_info {
 int spl_load_simple_fit(struct spl_image_info *spl_image,
 			struct spl_load_info *info, ulong sector, void *fdt);
 
+/**
+ * struct spl_fit_stats - data moved by the last spl_load_simple_fit()
+ *
+ * @read:	Bytes read from the device, including the FIT structure
+ * @copied:	Bytes copied in memory after reading
+ * @loaded:	Bytes of image data placed at their load addresses
+ * @compressed:	Bytes of compressed image data decompressed
+ * @decompressed: Bytes these decompressed to, included in @loaded
+ * @decomp_us:	Microseconds spent decompressing
+ */
+struct spl_fit_stats {
+	ulong read;
+	ulong copied;
+	ulong loaded;
+	ulong compressed;
+	ulong decompressed;
+	ulong decomp_us;
+};
+
+/**
+ * spl_fit_get_stats() - Get the data moved loading the last FIT
+ *
+ * @return the statistics
+ */
+const struct spl_fit_stats *spl_fit_get_stats(void);
+
+/**
+ * board_spl_fit_buffer() - Get a buffer to read the FIT structure to
+ *
+ * This defaults to the space just below CONFIG_SYS_TEXT_BASE.
+ *
+ * @size:	Size of the buffer
+ * @return buffer, aligned to ARCH_DMA_MINALIGN
+ */
+void *board_spl_fit_buffer(ulong size);
+
 #define SPL_COPY_PAYLOAD_ONLY	1
 
 /* SPL common functions */
@@ -285,7 +322,7 @@ void spl_invoke_atf(struct spl_image_info *spl_image);
  * bl31_entry - Fill bl31_params structure, and jump to bl31
  */
 void bl31_entry(uintptr_t bl31_entry, uintptr_t bl32_entry,
-		uintptr_t bl33_entry, uintptr_t fdt_addr);
+		uintptr_t bl33_entry, uintptr_t bl33_arg, uintptr_t fdt_addr);
 
 /**
  * spl_optee_entry - entry function for optee
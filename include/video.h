@@ -90,8 +90,50 @@ struct video_priv {
 	ushort *cmap;
 };
 
-/* Placeholder - there are no video operations at present */
+/**
+ * struct video_surface - A pixel buffer for 2D operations
+ *
+ * This describes either a device frame buffer (see video_get_surface()) or
+ * any other image in memory, such as a decoded logo.
+ *
+ * @base:	Address of the top-left pixel
+ * @line_length:	Bytes from one row to the next. This may be negative
+ *		for bottom-up images such as BMP data
+ * @xsize:	Width in pixels
+ * @ysize:	Height in pixels
+ * @bytes_pp:	Bytes per pixel (1 to 4). Colours are given as the pixel
+ *		value in memory byte order, i.e. 0xRRGGBB for a 24-bit BGR
+ *		frame buffer
+ */
+struct video_surface {
+	void *base;
+	int line_length;
+	ushort xsize;
+	ushort ysize;
+	uchar bytes_pp;
+};
+
+/**
+ * struct video_ops - 2D acceleration hooks of a video device
+ *
+ * All members are optional. A hook may return -ENOSYS for a request it
+ * cannot handle (e.g. unsupported pixel size), in which case the software
+ * implementation is used instead. Hooks are responsible for any cache
+ * maintenance their hardware needs.
+ */
 struct video_ops {
+	int (*fill_rect)(struct udevice *dev, const struct video_surface *dst,
+			 int x, int y, int w, int h, u32 colour);
+	int (*copy_rect)(struct udevice *dev, const struct video_surface *dst,
+			 int dx, int dy, const struct video_surface *src,
+			 int sx, int sy, int w, int h);
+	int (*blend_rect)(struct udevice *dev,
+			  const struct video_surface *dst, int dx, int dy,
+			  const struct video_surface *src, int sx, int sy,
+			  int w, int h, uint alpha);
+	int (*rotate_copy)(struct udevice *dev,
+			   const struct video_surface *dst, int dx, int dy,
+			   const struct video_surface *src, int rot);
 };
 
 #define video_get_ops(dev)        ((struct video_ops *)(dev)->driver->ops)
@@ -176,6 +218,92 @@ int video_get_ysize(struct udevice *dev);
  */
 void video_set_flush_dcache(struct udevice *dev, bool flush);
 
+/**
+ * video_get_surface() - Describe the frame buffer of a video device
+ *
+ * @dev:	Video device
+ * @surface:	Returns the frame buffer description
+ */
+void video_get_surface(struct udevice *dev, struct video_surface *surface);
+
+/**
+ * video_fill_rect() - Fill a rectangle with a colour
+ *
+ * The rectangle is clipped to the surface. This uses the fill_rect() hook of
+ * @dev if there is one, otherwise the software implementation.
+ *
+ * @dev:	Video device whose hooks to use, or NULL for software only
+ * @dst:	Surface to draw on
+ * @x, @y:	Top-left corner in pixels
+ * @w, @h:	Size in pixels
+ * @colour:	Pixel value
+ * @return 0 if OK, -ve on error
+ */
+int video_fill_rect(struct udevice *dev, const struct video_surface *dst,
+		    int x, int y, int w, int h, u32 colour);
+
+/**
+ * video_copy_rect() - Copy a rectangle between (or within) surfaces
+ *
+ * Overlapping source and destination areas are handled, so this can be used
+ * for scrolling. Both surfaces must have the same bytes per pixel.
+ *
+ * @dev:	Video device whose hooks to use, or NULL for software only
+ * @dst:	Destination surface
+ * @dx, @dy:	Destination position in pixels
+ * @src:	Source surface
+ * @sx, @sy:	Source position in pixels
+ * @w, @h:	Size in pixels
+ * @return 0 if OK, -ve on error
+ */
+int video_copy_rect(struct udevice *dev, const struct video_surface *dst,
+		    int dx, int dy, const struct video_surface *src,
+		    int sx, int sy, int w, int h);
+
+/**
+ * video_blend_rect() - Blend a 32-bit ARGB rectangle onto a surface
+ *
+ * The per-pixel alpha of @src is scaled by @alpha.
+ *
+ * @dev:	Video device whose hooks to use, or NULL for software only
+ * @dst:	Destination surface (24 or 32 bits per pixel)
+ * @dx, @dy:	Destination position in pixels
+ * @src:	Source surface, 32 bits per pixel with alpha in the top byte
+ * @sx, @sy:	Source position in pixels
+ * @w, @h:	Size in pixels
+ * @alpha:	Global alpha, 0 (transparent) to 255 (opaque)
+ * @return 0 if OK, -ve on error
+ */
+int video_blend_rect(struct udevice *dev, const struct video_surface *dst,
+		     int dx, int dy, const struct video_surface *src,
+		     int sx, int sy, int w, int h, uint alpha);
+
+/**
+ * video_rotate_copy() - Copy a whole surface rotated by a multiple of 90 deg
+ *
+ * @dev:	Video device whose hooks to use, or NULL for software only
+ * @dst:	Destination surface
+ * @dx, @dy:	Destination position of the rotated image in pixels
+ * @src:	Source surface
+ * @rot:	Clockwise rotation in 90 degree steps, as video_priv.rot
+ * @return 0 if OK, -ERANGE if the rotated image does not fit, other -ve
+ *	on error
+ */
+int video_rotate_copy(struct udevice *dev, const struct video_surface *dst,
+		      int dx, int dy, const struct video_surface *src, int rot);
+
+/* Software implementations, used when a device has no hook */
+int video_sw_fill_rect(const struct video_surface *dst, int x, int y,
+		       int w, int h, u32 colour);
+int video_sw_copy_rect(const struct video_surface *dst, int dx, int dy,
+		       const struct video_surface *src, int sx, int sy,
+		       int w, int h);
+int video_sw_blend_rect(const struct video_surface *dst, int dx, int dy,
+			const struct video_surface *src, int sx, int sy,
+			int w, int h, uint alpha);
+int video_sw_rotate_copy(const struct video_surface *dst, int dx, int dy,
+			 const struct video_surface *src, int rot);
+
 #endif /* CONFIG_DM_VIDEO */
 
 #ifndef CONFIG_DM_VIDEO
@@ -38,4 +38,24 @@ int rockchip_show_bmp(const char *bmp);
 int rockchip_show_logo(void);
 void rockchip_display_fixup(void *blob);
 
+#ifdef CONFIG_DRM_ROCKCHIP_PANEL_ASYNC
+/*
+ * rockchip_display_poll() - carry on panel power on sequences in progress
+ *
+ * Cheap to call often, e.g. from board_idle_poll(). It talks to the PMIC
+ * and panel, so it must not be called from inside another driver.
+ *
+ * @return -EAGAIN if a panel is still powering up, otherwise 0
+ */
+int rockchip_display_poll(void);
+
+/*
+ * rockchip_display_wait() - finish panel power on sequences in progress
+ */
+void rockchip_display_wait(void);
+#else
+static inline int rockchip_display_poll(void) { return 0; }
+static inline void rockchip_display_wait(void) {}
+#endif
+
 #endif
@@ -0,0 +1,288 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <chunked_decomp.h>
+#include <image.h>
+#include <malloc.h>
+#include <smp_job.h>
+#include <u-boot/crc.h>
+#include <u-boot/zlib.h>
+#include <asm/unaligned.h>
+#include <linux/sizes.h>
+
+#define GZIP_EXTRA_FIELD	4
+#define GZIP_TRAILER_SIZE	8
+
+/* Per CPU, for the inflate state and window */
+#define CHUNKED_ARENA_SIZE	SZ_64K
+
+struct chunked_arena {
+	u8 *base;
+	ulong used;
+};
+
+/**
+ * struct chunked_job - a chunk to decompress
+ *
+ * @comp:	Compression type
+ * @arena:	CHUNKED_ARENA_SIZE bytes per CPU for gzip
+ * @src:	Compressed data: deflate data followed by the gzip trailer, or
+ *		an LZ4 frame
+ * @src_len:	Size of @src, without the gzip trailer
+ * @dst:	Where the chunk goes
+ * @size:	Its decompressed size
+ * @ret:	Returns 0 if OK, -ve on error
+ */
+struct chunked_job {
+	int comp;
+	u8 *arena;
+	const u8 *src;
+	ulong src_len;
+	u8 *dst;
+	ulong size;
+	int ret;
+};
+
+/* Find the index in @src, returning its size in @idx_lenp */
+static const struct chunked_index *chunked_find(int comp, const u8 *src,
+						ulong len, ulong *idx_lenp)
+{
+	const u8 *p, *end;
+	ulong sublen;
+
+	switch (comp) {
+#ifdef CONFIG_GZIP
+	case IH_COMP_GZIP:
+		if (len < 12 || src[0] != 0x1f || src[1] != 0x8b ||
+		    src[2] != Z_DEFLATED || !(src[3] & GZIP_EXTRA_FIELD))
+			return NULL;
+		p = src + 12;
+		end = p + get_unaligned_le16(src + 10);
+		if (end > src + len)
+			return NULL;
+		for (; p + 4 <= end; p += 4 + sublen) {
+			sublen = get_unaligned_le16(p + 2);
+			if (p[0] == CHUNKED_GZIP_SI1 &&
+			    p[1] == CHUNKED_GZIP_SI2 && p + 4 + sublen <= end) {
+				*idx_lenp = sublen;
+				return (const struct chunked_index *)(p + 4);
+			}
+		}
+		return NULL;
+#endif
+#ifdef CONFIG_LZ4
+	case IH_COMP_LZ4:
+		if (len < 8 || get_unaligned_le32(src) != CHUNKED_LZ4_MAGIC)
+			return NULL;
+		*idx_lenp = get_unaligned_le32(src + 4);
+		if (*idx_lenp > len - 8)
+			return NULL;
+		return (const struct chunked_index *)(src + 8);
+#endif
+	default:
+		return NULL;
+	}
+}
+
+/* Find the index of a chunked image and check that it fits the image */
+static const struct chunked_index *chunked_check(int comp, const void *src,
+						 ulong len)
+{
+	const struct chunked_index *idx;
+	ulong idx_len, count, chunk_size, size, offset, clen;
+	uint i;
+
+	idx = chunked_find(comp, src, len, &idx_len);
+	if (!idx || idx_len < sizeof(*idx) ||
+	    get_unaligned_le32(&idx->magic) != CHUNKED_MAGIC)
+		return NULL;
+	count = get_unaligned_le32(&idx->count);
+	chunk_size = get_unaligned_le32(&idx->chunk_size);
+	size = get_unaligned_le32(&idx->size);
+	if (!chunk_size || !size || (size - 1) / chunk_size + 1 != count ||
+	    (idx_len - sizeof(*idx)) / sizeof(idx->entry[0]) < count)
+		return NULL;
+
+	for (i = 0; i < count; i++) {
+		offset = get_unaligned_le32(&idx->entry[i].offset);
+		clen = get_unaligned_le32(&idx->entry[i].len);
+		if (offset > len || clen > len - offset)
+			return NULL;
+	}
+
+	return idx;
+}
+
+ulong chunked_get_size(int comp, const void *src, ulong len)
+{
+	const struct chunked_index *idx = chunked_check(comp, src, len);
+
+	return idx ? get_unaligned_le32(&idx->size) : 0;
+}
+
+#ifdef CONFIG_GZIP
+static void *chunked_zalloc(void *opaque, uInt items, uInt size)
+{
+	struct chunked_arena *arena = opaque;
+	ulong bytes = ALIGN((ulong)items * size, 16);
+	void *ptr;
+
+	if (bytes > CHUNKED_ARENA_SIZE - arena->used)
+		return NULL;
+	ptr = arena->base + arena->used;
+	arena->used += bytes;
+
+	return ptr;
+}
+
+static void chunked_zfree(void *opaque, void *ptr, uInt size)
+{
+}
+
+static int chunked_gunzip(struct chunked_job *job)
+{
+	struct chunked_arena arena;
+	const u8 *trailer = job->src + job->src_len;
+	z_stream s;
+	int ret;
+
+	arena.base = job->arena + smp_job_cpu() * CHUNKED_ARENA_SIZE;
+	arena.used = 0;
+	memset(&s, '\0', sizeof(s));
+	s.zalloc = chunked_zalloc;
+	s.zfree = chunked_zfree;
+	s.opaque = &arena;
+	if (inflateInit2(&s, -MAX_WBITS) != Z_OK)
+		return -ENOMEM;
+	s.next_in = (u8 *)job->src;
+	s.avail_in = job->src_len;
+	s.next_out = job->dst;
+	s.avail_out = job->size;
+	ret = inflate(&s, Z_FINISH);
+	inflateEnd(&s);
+	if (ret != Z_STREAM_END || s.avail_out)
+		return -EINVAL;
+
+	/* the trailer has the CRC32 and size of the chunk */
+	if (crc32(0, job->dst, job->size) != get_unaligned_le32(trailer) ||
+	    get_unaligned_le32(trailer + 4) != job->size)
+		return -EINVAL;
+
+	return 0;
+}
+#endif
+
+#ifdef CONFIG_LZ4
+static int chunked_unlz4(struct chunked_job *job)
+{
+	size_t size = job->size;
+
+	if (ulz4fn(job->src, job->src_len, job->dst, &size) ||
+	    size != job->size)
+		return -EINVAL;
+
+	return 0;
+}
+#endif
+
+/* Runs on any CPU, see smp_job.h */
+static void chunked_run(void *arg)
+{
+	struct chunked_job *job = arg;
+
+	switch (job->comp) {
+#ifdef CONFIG_GZIP
+	case IH_COMP_GZIP:
+		job->ret = chunked_gunzip(job);
+		break;
+#endif
+#ifdef CONFIG_LZ4
+	case IH_COMP_LZ4:
+		job->ret = chunked_unlz4(job);
+		break;
+#endif
+	}
+}
+
+/* Set up @job for chunk @i, on the boot CPU */
+static int chunked_prepare(struct chunked_job *job,
+			   const struct chunked_index *idx, uint i,
+			   const u8 *src, u8 *dst)
+{
+	ulong chunk_size = get_unaligned_le32(&idx->chunk_size);
+	ulong size = get_unaligned_le32(&idx->size);
+	int offset = 0;
+
+	job->src = src + get_unaligned_le32(&idx->entry[i].offset);
+	job->src_len = get_unaligned_le32(&idx->entry[i].len);
+	job->dst = dst + i * chunk_size;
+	job->size = min(chunk_size, size - i * chunk_size);
+
+	if (job->comp == IH_COMP_GZIP) {
+		if (job->src_len < 10 + GZIP_TRAILER_SIZE ||
+		    job->src[0] != 0x1f || job->src[1] != 0x8b)
+			return -EINVAL;
+		offset = gzip_parse_header(job->src, job->src_len);
+		if (offset < 0 ||
+		    job->src_len - GZIP_TRAILER_SIZE < offset)
+			return -EINVAL;
+		job->src_len -= offset + GZIP_TRAILER_SIZE;
+	}
+	job->src += offset;
+
+	return 0;
+}
+
+int chunked_decomp(int comp, void *dst, ulong dst_len, const void *src,
+		   ulong *lenp)
+{
+	const struct chunked_index *idx;
+	struct chunked_job *jobs;
+	u8 *arena = NULL;
+	ulong count, size;
+	int ret = 0;
+	uint i;
+
+	idx = chunked_check(comp, src, *lenp);
+	if (!idx)
+		return -ENOENT;
+	count = get_unaligned_le32(&idx->count);
+	size = get_unaligned_le32(&idx->size);
+	if (size > dst_len) {
+		*lenp = size;
+		return -ENOBUFS;
+	}
+
+	jobs = calloc(count, sizeof(*jobs));
+	if (comp == IH_COMP_GZIP)
+		arena = malloc(smp_job_cpus() * CHUNKED_ARENA_SIZE);
+	if (!jobs || (comp == IH_COMP_GZIP && !arena)) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	debug("chunked: %lu chunks on %u CPUs\n", count, smp_job_cpus());
+	for (i = 0; i < count; i++) {
+		jobs[i].comp = comp;
+		jobs[i].arena = arena;
+		ret = chunked_prepare(&jobs[i], idx, i, src, dst);
+		if (ret)
+			break;
+		smp_job_submit(chunked_run, &jobs[i]);
+	}
+	smp_job_wait();
+
+	for (i = 0; i < count && !ret; i++)
+		ret = jobs[i].ret;
+	if (!ret)
+		*lenp = size;
+out:
+	free(arena);
+	free(jobs);
+
+	return ret;
+}
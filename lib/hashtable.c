@@ -60,12 +60,159 @@
 typedef struct _ENTRY {
 	int used;
 	ENTRY entry;
+#ifdef CONFIG_HASHTABLE_ARENA
+	unsigned int hash;	/* full hash of entry.key */
+	unsigned int prev;	/* neighbours in iteration order, 0 for none */
+	unsigned int next;
+#endif
 } _ENTRY;
 
 
 static void _hdelete(const char *key, struct hsearch_data *htab, ENTRY *ep,
 	int idx);
 
+#ifdef CONFIG_HASHTABLE_ARENA
+/*
+ * Keys and values are packed into arena chunks instead of taking one
+ * malloc() each. Strings never move, so a pointer returned by hsearch_r()
+ * stays valid until that variable is changed or deleted, as it did with
+ * strdup(). A chunk is freed once all strings in it are dead.
+ */
+#define HTAB_CHUNK_MIN		4096
+#define HTAB_CHUNK_MAX		(64 << 10)
+
+struct htab_chunk {
+	struct htab_chunk *next;
+	size_t size;		/* bytes in data[] */
+	size_t used;
+	unsigned int live;	/* strings in use */
+	char data[];
+};
+
+static char *htab_strdup(struct hsearch_data *htab, const char *str)
+{
+	struct htab_chunk *chunk = htab->arena;
+	size_t len = strlen(str) + 1;
+	size_t size;
+	char *p;
+
+	if (chunk && !chunk->live)
+		chunk->used = 0;
+
+	if (!chunk || chunk->size - chunk->used < len) {
+		/* grow the chunks while the table grows */
+		size = chunk ? chunk->size * 2 : HTAB_CHUNK_MIN;
+		if (size > HTAB_CHUNK_MAX)
+			size = HTAB_CHUNK_MAX;
+		if (size < len)
+			size = len;
+
+		chunk = malloc(sizeof(*chunk) + size);
+		if (!chunk)
+			return NULL;
+		chunk->size = size;
+		chunk->used = 0;
+		chunk->live = 0;
+		chunk->next = htab->arena;
+		htab->arena = chunk;
+	}
+
+	p = chunk->data + chunk->used;
+	memcpy(p, str, len);
+	chunk->used += len;
+	chunk->live++;
+
+	return p;
+}
+
+static void htab_strfree(struct hsearch_data *htab, const char *str)
+{
+	struct htab_chunk **cp, *chunk;
+
+	for (cp = &htab->arena; (chunk = *cp); cp = &chunk->next) {
+		if (str < chunk->data || str >= chunk->data + chunk->size)
+			continue;
+
+		/* the newest chunk is kept for the next strings */
+		if (!--chunk->live && chunk != htab->arena) {
+			*cp = chunk->next;
+			free(chunk);
+		}
+		return;
+	}
+}
+
+static void htab_free_strings(struct hsearch_data *htab)
+{
+	struct htab_chunk *chunk;
+
+	while ((chunk = htab->arena)) {
+		htab->arena = chunk->next;
+		free(chunk);
+	}
+}
+
+/* FNV-1a, the full value is kept in the entry to skip most strcmp() */
+static unsigned int htab_hash(const char *key)
+{
+	unsigned int hash = 2166136261u;
+
+	while (*key) {
+		hash ^= (unsigned char)*key++;
+		hash *= 16777619;
+	}
+
+	return hash;
+}
+
+static void htab_link(struct hsearch_data *htab, unsigned int idx)
+{
+	_ENTRY *e = &htab->table[idx];
+
+	e->prev = htab->last;
+	e->next = 0;
+	if (htab->last) {
+		if (strcmp(htab->table[htab->last].entry.key, e->entry.key) > 0)
+			htab->sorted = 0;
+		htab->table[htab->last].next = idx;
+	} else {
+		htab->first = idx;
+	}
+	htab->last = idx;
+}
+
+static void htab_unlink(struct hsearch_data *htab, unsigned int idx)
+{
+	_ENTRY *e = &htab->table[idx];
+
+	if (e->prev)
+		htab->table[e->prev].next = e->next;
+	else
+		htab->first = e->next;
+	if (e->next)
+		htab->table[e->next].prev = e->prev;
+	else
+		htab->last = e->prev;
+}
+#else
+#define htab_strdup(htab, str)		strdup(str)
+#define htab_strfree(htab, str)		free((void *)(str))
+
+static void htab_free_strings(struct hsearch_data *htab)
+{
+	int i;
+
+	for (i = 1; i <= htab->size; ++i) {
+		if (htab->table[i].used > 0) {
+			ENTRY *ep = &htab->table[i].entry;
+
+			free((void *)ep->key);
+			free(ep->data);
+		}
+	}
+}
+#endif
+
 /*
  * hcreate()
  */
@@ -116,6 +263,12 @@ int hcreate_r(size_t nel, struct hsearch_data *htab)
 
 	htab->size = nel;
 	htab->filled = 0;
+#ifdef CONFIG_HASHTABLE_ARENA
+	htab->arena = NULL;
+	htab->first = 0;
+	htab->last = 0;
+	htab->sorted = 1;
+#endif
 
 	/* allocate memory and zero out */
 	htab->table = (_ENTRY *) calloc(htab->size + 1, sizeof(_ENTRY));
@@ -138,8 +291,6 @@ int hcreate_r(size_t nel, struct hsearch_data *htab)
 
 void hdestroy_r(struct hsearch_data *htab)
 {
-	int i;
-
 	/* Test for correct arguments.  */
 	if (htab == NULL) {
 		__set_errno(EINVAL);
@@ -147,14 +298,7 @@ void hdestroy_r(struct hsearch_data *htab)
 	}
 
 	/* free used memory */
-	for (i = 1; i <= htab->size; ++i) {
-		if (htab->table[i].used > 0) {
-			ENTRY *ep = &htab->table[i].entry;
-
-			free((void *)ep->key);
-			free(ep->data);
-		}
-	}
+	htab_free_strings(htab);
 	free(htab->table);
 
 	/* the sign for an existing table is an value != NULL in htable */
@@ -224,9 +368,16 @@ int hmatch_r(const char *match, int last_idx, ENTRY ** retval,
  */
 static inline int _compare_and_overwrite_entry(ENTRY item, ACTION action,
 	ENTRY **retval, struct hsearch_data *htab, int flag,
-	unsigned int hval, unsigned int idx)
+	unsigned int hval, unsigned int hash, unsigned int idx)
 {
-	if (htab->table[idx].used == hval
+#ifdef CONFIG_HASHTABLE_ARENA
+	int same_hash = htab->table[idx].used > 0 &&
+			htab->table[idx].hash == hash;
+#else
+	int same_hash = htab->table[idx].used == hval;
+#endif
+
+	if (same_hash
 	    && strcmp(item.key, htab->table[idx].entry.key) == 0) {
 		/* Overwrite existing value? */
 		if ((action == ENTER) && (item.data != NULL)) {
@@ -252,8 +403,20 @@ static inline int _compare_and_overwrite_entry(ENTRY item, ACTION action,
 				return 0;
 			}
 
-			free(htab->table[idx].entry.data);
-			htab->table[idx].entry.data = strdup(item.data);
+#ifdef CONFIG_HASHTABLE_ARENA
+			char *data = htab->table[idx].entry.data;
+			size_t len = strlen(item.data);
+
+			/* a value which does not grow is updated in place */
+			if (len <= strlen(data)) {
+				memmove(data, item.data, len + 1);
+				*retval = &htab->table[idx].entry;
+				return idx;
+			}
+#endif
+			htab_strfree(htab, htab->table[idx].entry.data);
+			htab->table[idx].entry.data = htab_strdup(htab,
+								  item.data);
 			if (!htab->table[idx].entry.data) {
 				__set_errno(ENOMEM);
 				*retval = NULL;
@@ -271,13 +434,18 @@ static inline int _compare_and_overwrite_entry(ENTRY item, ACTION action,
 int hsearch_r(ENTRY item, ACTION action, ENTRY ** retval,
 	      struct hsearch_data *htab, int flag)
 {
-	unsigned int hval;
-	unsigned int count;
-	unsigned int len = strlen(item.key);
+	unsigned int hval, hash;
 	unsigned int idx;
 	unsigned int first_deleted = 0;
 	int ret;
 
+#ifdef CONFIG_HASHTABLE_ARENA
+	hash = htab_hash(item.key);
+	hval = hash;
+#else
+	unsigned int count;
+	unsigned int len = strlen(item.key);
+
 	/* Compute an value for the given string. Perhaps use a better method. */
 	hval = len;
 	count = len;
@@ -285,6 +453,8 @@ int hsearch_r(ENTRY item, ACTION action, ENTRY ** retval,
 		hval <<= 4;
 		hval += item.key[count];
 	}
+	hash = hval;
+#endif
 
 	/*
 	 * First hash function:
@@ -309,7 +479,7 @@ int hsearch_r(ENTRY item, ACTION action, ENTRY ** retval,
 			first_deleted = idx;
 
 		ret = _compare_and_overwrite_entry(item, action, retval, htab,
-			flag, hval, idx);
+			flag, hval, hash, idx);
 		if (ret != -1)
 			return ret;
 
@@ -338,7 +508,7 @@ int hsearch_r(ENTRY item, ACTION action, ENTRY ** retval,
 
 			/* If entry is found use it. */
 			ret = _compare_and_overwrite_entry(item, action, retval,
-				htab, flag, hval, idx);
+				htab, flag, hval, hash, idx);
 			if (ret != -1)
 				return ret;
 		}
@@ -365,8 +535,8 @@ int hsearch_r(ENTRY item, ACTION action, ENTRY ** retval,
 			idx = first_deleted;
 
 		htab->table[idx].used = hval;
-		htab->table[idx].entry.key = strdup(item.key);
-		htab->table[idx].entry.data = strdup(item.data);
+		htab->table[idx].entry.key = htab_strdup(htab, item.key);
+		htab->table[idx].entry.data = htab_strdup(htab, item.data);
 		if (!htab->table[idx].entry.key ||
 		    !htab->table[idx].entry.data) {
 			__set_errno(ENOMEM);
@@ -375,6 +545,10 @@ int hsearch_r(ENTRY item, ACTION action, ENTRY ** retval,
 		}
 
 		++htab->filled;
+#ifdef CONFIG_HASHTABLE_ARENA
+		htab->table[idx].hash = hash;
+		htab_link(htab, idx);
+#endif
 
 		/* This is a new entry, so look up a possible callback */
 		env_callback_init(&htab->table[idx].entry);
@@ -430,8 +604,11 @@ static void _hdelete(const char *key, struct hsearch_data *htab, ENTRY *ep,
 {
 	/* free used ENTRY */
 	debug("hdelete: DELETING key \"%s\"\n", key);
-	free((void *)ep->key);
-	free(ep->data);
+#ifdef CONFIG_HASHTABLE_ARENA
+	htab_unlink(htab, idx);
+#endif
+	htab_strfree(htab, ep->key);
+	htab_strfree(htab, ep->data);
 	ep->callback = NULL;
 	ep->flags = 0;
 	htab->table[idx].used = -1;
@@ -528,6 +705,31 @@ static int cmpkey(const void *p1, const void *p2)
 	return (strcmp(e1->key, e2->key));
 }
 
+#ifdef CONFIG_HASHTABLE_ARENA
+/*
+ * Put the iteration order in key order. Entries are usually imported from a
+ * sorted environment and only a few are added later, so this is rarely
+ * needed and the export does not have to sort.
+ */
+static void htab_sort(struct hsearch_data *htab)
+{
+	ENTRY *list[htab->filled + 1];
+	unsigned int i, n = 0;
+
+	for (i = htab->first; i; i = htab->table[i].next)
+		list[n++] = &htab->table[i].entry;
+
+	qsort(list, n, sizeof(ENTRY *), cmpkey);
+
+	htab->first = 0;
+	htab->last = 0;
+	for (i = 0; i < n; i++)
+		htab_link(htab, container_of(list[i], _ENTRY, entry) -
+			  htab->table);
+	htab->sorted = 1;
+}
+#endif
+
 static int match_string(int flag, const char *str, const char *pat, void *priv)
 {
 	switch (flag & H_MATCH_METHOD) {
@@ -609,7 +811,14 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 	 * search used entries,
 	 * save addresses and compute total length
 	 */
+#ifdef CONFIG_HASHTABLE_ARENA
+	if (!htab->sorted)
+		htab_sort(htab);
+
+	for (i = htab->first, n = 0, totlen = 0; i; i = htab->table[i].next) {
+#else
 	for (i = 1, n = 0, totlen = 0; i <= htab->size; ++i) {
+#endif
 
 		if (htab->table[i].used > 0) {
 			ENTRY *ep = &htab->table[i].entry;
@@ -651,8 +860,10 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 	}
 #endif
 
+#ifndef CONFIG_HASHTABLE_ARENA
 	/* Sort list by keys */
 	qsort(list, n, sizeof(ENTRY *), cmpkey);
+#endif
 
 	/* Check if the user supplied buffer size is sufficient */
 	if (size) {
@@ -969,7 +1180,11 @@ int hwalk_r(struct hsearch_data *htab, int (*callback)(ENTRY *))
 	int i;
 	int retval;
 
+#ifdef CONFIG_HASHTABLE_ARENA
+	for (i = htab->first; i; i = htab->table[i].next) {
+#else
 	for (i = 1; i <= htab->size; ++i) {
+#endif
 		if (htab->table[i].used > 0) {
 			retval = callback(&htab->table[i].entry);
 			if (retval)
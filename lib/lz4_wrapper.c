@@ -8,6 +8,7 @@
 #include <compiler.h>
 #include <linux/kernel.h>
 #include <linux/types.h>
+#include <asm/unaligned.h>
 
 static u16 LZ4_readLE16(const void *src) { return le16_to_cpu(*(u16 *)src); }
 static void LZ4_copy4(void *dst, const void *src) { *(u32 *)dst = *(u32 *)src; }
@@ -77,6 +78,17 @@ bool lz4_is_valid_header(const unsigned char *h)
 	return true;
 }
 
+u64 lz4_get_content_size(const void *h, size_t len)
+{
+	const struct lz4_frame_header *hdr = h;
+
+	if (len < sizeof(*hdr) + sizeof(u64) ||
+	    !lz4_is_valid_header(h) || !hdr->has_content_size)
+		return 0;
+
+	return get_unaligned_le64(h + sizeof(*hdr));
+}
+
 int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
 {
 	const void *end = dst + *dstn;
@@ -125,7 +137,8 @@ int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
 
 		if (b.not_compressed) {
 			size_t size = min((ptrdiff_t)b.size, end - out);
-			memcpy(out, in, size);
+			/* in place, the output may run into this block */
+			memmove(out, in, size);
 			out += size;
 			if (size < b.size) {
 				ret = -ENOBUFS;	/* output overrun */
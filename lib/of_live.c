@@ -332,6 +332,13 @@ int of_live_build(const void *fdt_blob, struct device_node **rootp)
 		debug("Failed to scan live tree aliases: err=%d\n", ret);
 		return ret;
 	}
+#if CONFIG_IS_ENABLED(OF_LIVE_INDEX)
+	ret = of_index_build();
+	if (ret) {
+		debug("Failed to index live tree: err=%d\n", ret);
+		return ret;
+	}
+#endif
 	debug("%s: stop\n", __func__);
 
 	return ret;
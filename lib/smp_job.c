@@ -0,0 +1,185 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <smp_job.h>
+
+#define SMP_JOB_QUEUE		64
+
+/* Pieces per CPU in smp_job_for(), to even out the work */
+#define SMP_JOB_FOR_PIECES	4
+
+struct smp_job {
+	smp_job_func func;
+	void *arg;
+};
+
+struct smp_job_range {
+	smp_job_range_func func;
+	void *arg;
+	ulong start;
+	ulong end;
+};
+
+/**
+ * struct smp_job_queue - jobs shared by all CPUs
+ *
+ * Only the boot CPU submits jobs and changes @cpus. Job n is in
+ * @job[n % SMP_JOB_QUEUE] until it is taken, when it is copied out; the
+ * slot is reused once more than n jobs are finished, as then job n must
+ * have been taken.
+ *
+ * @head:	Jobs taken
+ * @tail:	Jobs submitted
+ * @done:	Jobs finished
+ * @stop:	Secondary CPUs are to power down
+ * @cpus:	CPUs running jobs, 0 before they are started
+ * @job:	Jobs submitted
+ */
+static struct smp_job_queue {
+	ulong head;
+	ulong tail;
+	ulong done;
+	bool stop;
+	uint cpus;
+	struct smp_job job[SMP_JOB_QUEUE];
+} queue;
+
+__weak uint smp_job_arch_start(uint max)
+{
+	return 0;
+}
+
+__weak void smp_job_arch_stop(void)
+{
+}
+
+__weak void smp_job_arch_kick(void)
+{
+}
+
+__weak void smp_job_arch_idle(void)
+{
+}
+
+__weak uint smp_job_arch_cpu(void)
+{
+	return 0;
+}
+
+/* Take the next job and run it, return false if there is none */
+static bool smp_job_run(void)
+{
+	struct smp_job job;
+	ulong head;
+
+	head = __atomic_load_n(&queue.head, __ATOMIC_ACQUIRE);
+	do {
+		if (head == __atomic_load_n(&queue.tail, __ATOMIC_ACQUIRE))
+			return false;
+		job = queue.job[head % SMP_JOB_QUEUE];
+	} while (!__atomic_compare_exchange_n(&queue.head, &head, head + 1,
+					      false, __ATOMIC_ACQ_REL,
+					      __ATOMIC_ACQUIRE));
+
+	job.func(job.arg);
+	__atomic_fetch_add(&queue.done, 1, __ATOMIC_RELEASE);
+	smp_job_arch_kick();
+
+	return true;
+}
+
+uint smp_job_cpus(void)
+{
+	if (!queue.cpus) {
+		__atomic_store_n(&queue.stop, false, __ATOMIC_RELEASE);
+		queue.cpus = 1 + smp_job_arch_start(CONFIG_SMP_JOB_CPUS - 1);
+		debug("smp_job: %u CPUs\n", queue.cpus);
+	}
+
+	return queue.cpus;
+}
+
+uint smp_job_cpu(void)
+{
+	return smp_job_arch_cpu();
+}
+
+void smp_job_submit(smp_job_func func, void *arg)
+{
+	ulong tail = queue.tail;
+	struct smp_job *job = &queue.job[tail % SMP_JOB_QUEUE];
+
+	smp_job_cpus();
+	while (tail - __atomic_load_n(&queue.done, __ATOMIC_ACQUIRE) >=
+	       SMP_JOB_QUEUE) {
+		if (!smp_job_run())
+			smp_job_arch_idle();
+	}
+	job->func = func;
+	job->arg = arg;
+	__atomic_store_n(&queue.tail, tail + 1, __ATOMIC_RELEASE);
+	smp_job_arch_kick();
+}
+
+void smp_job_wait(void)
+{
+	while (__atomic_load_n(&queue.done, __ATOMIC_ACQUIRE) != queue.tail) {
+		if (!smp_job_run())
+			smp_job_arch_idle();
+	}
+}
+
+static void smp_job_range_run(void *arg)
+{
+	struct smp_job_range *range = arg;
+
+	range->func(range->arg, range->start, range->end);
+}
+
+void smp_job_for(ulong count, ulong grain, smp_job_range_func func,
+		 void *arg)
+{
+	struct smp_job_range range[SMP_JOB_QUEUE];
+	ulong pieces, size, start;
+	uint i;
+
+	if (!count)
+		return;
+	grain = max(grain, 1UL);
+	pieces = min((ulong)smp_job_cpus() * SMP_JOB_FOR_PIECES,
+		     DIV_ROUND_UP(count, grain));
+	pieces = min(pieces, (ulong)SMP_JOB_QUEUE);
+	size = roundup(DIV_ROUND_UP(count, pieces), grain);
+
+	for (i = 0, start = 0; start < count; i++, start += size) {
+		range[i].func = func;
+		range[i].arg = arg;
+		range[i].start = start;
+		range[i].end = min(start + size, count);
+		smp_job_submit(smp_job_range_run, &range[i]);
+	}
+	smp_job_wait();
+}
+
+void smp_job_stop(void)
+{
+	if (queue.cpus > 1) {
+		smp_job_wait();
+		__atomic_store_n(&queue.stop, true, __ATOMIC_RELEASE);
+		smp_job_arch_kick();
+		smp_job_arch_stop();
+	}
+	queue.cpus = 0;
+}
+
+void smp_job_secondary(void)
+{
+	while (!__atomic_load_n(&queue.stop, __ATOMIC_ACQUIRE)) {
+		if (!smp_job_run())
+			smp_job_arch_idle();
+	}
+}
@@ -8,6 +8,7 @@
 #include <sysmem.h>
 #include <lmb.h>
 #include <malloc.h>
+#include <malloc_trace.h>
 #include <asm/io.h>
 
 DECLARE_GLOBAL_DATA_PTR;
@@ -319,7 +320,8 @@ static void *sysmem_alloc_align_base(enum memblk_id id,
 				     const char *mem_name,
 				     phys_addr_t base,
 				     phys_size_t size,
-				     ulong align)
+				     ulong align,
+				     const void *site)
 {
 	struct sysmem *sysmem = &plat_sysmem;
 	struct memblk_attr attr;
@@ -488,6 +490,8 @@ static void *sysmem_alloc_align_base(enum memblk_id id,
 			mem->attr = attr;
 			sysmem->allocated_cnt++;
 			list_add_tail(&mem->node, &sysmem->allocated_head);
+			malloc_trace_sysmem_alloc(mem->attr.name, paddr,
+						  alloc_size, site);
 
 			/* Add overflow check magic */
 			if (mem->attr.flags & M_ATTR_OFC) {
@@ -544,7 +548,8 @@ void *sysmem_alloc(enum memblk_id id, phys_size_t size)
 					NULL,
 					SYSMEM_ALLOC_ANYWHERE,
 					size,
-					SYSMEM_ALLOC_NO_ALIGN);
+					SYSMEM_ALLOC_NO_ALIGN,
+					__builtin_return_address(0));
 	if (!paddr)
 		sysmem_dump();
 
@@ -559,7 +564,8 @@ void *sysmem_alloc_by_name(const char *name, phys_size_t size)
 					name,
 					SYSMEM_ALLOC_ANYWHERE,
 					size,
-					SYSMEM_ALLOC_NO_ALIGN);
+					SYSMEM_ALLOC_NO_ALIGN,
+					__builtin_return_address(0));
 	if (!paddr)
 		sysmem_dump();
 
@@ -574,7 +580,8 @@ void *sysmem_alloc_base(enum memblk_id id, phys_addr_t base, phys_size_t size)
 					NULL,
 					base,
 					size,
-					SYSMEM_ALLOC_NO_ALIGN);
+					SYSMEM_ALLOC_NO_ALIGN,
+					__builtin_return_address(0));
 	if (!paddr)
 		sysmem_dump();
 
@@ -590,7 +597,8 @@ void *sysmem_alloc_base_by_name(const char *name,
 					name,
 					base,
 					size,
-					SYSMEM_ALLOC_NO_ALIGN);
+					SYSMEM_ALLOC_NO_ALIGN,
+					__builtin_return_address(0));
 	if (!paddr)
 		sysmem_dump();
 
@@ -606,7 +614,8 @@ void *sysmem_fdt_reserve_alloc_base(const char *name,
 					name,
 					base,
 					size,
-					SYSMEM_ALLOC_NO_ALIGN);
+					SYSMEM_ALLOC_NO_ALIGN,
+					__builtin_return_address(0));
 	if (!paddr)
 		sysmem_dump();
 
@@ -677,6 +686,7 @@ int sysmem_free(phys_addr_t base)
 			 (ulong)(mem->base + mem->size));
 		sysmem->allocated_cnt--;
 		list_del(&mem->node);
+		malloc_trace_sysmem_free(mem->base);
 		free(mem);
 	} else {
 		SYSMEM_E("Failed to free \"%s\" at 0x%08lx\n",
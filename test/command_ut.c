@@ -12,9 +12,57 @@ static const char test_cmd[] = "setenv list 1\n setenv list ${list}2; "
 		"setenv list ${list}3\0"
 		"setenv list ${list}4";
 
+/* find_cmd() as it was before the command list was searched by name */
+static cmd_tbl_t *find_cmd_linear(const char *cmd, int len)
+{
+	cmd_tbl_t *start = ll_entry_start(cmd_tbl_t, cmd);
+	const int count = ll_entry_count(cmd_tbl_t, cmd);
+	cmd_tbl_t *cmdtp, *found = NULL;
+	int n_found = 0;
+
+	for (cmdtp = start; cmdtp != start + count; cmdtp++) {
+		if (strncmp(cmd, cmdtp->name, len) == 0) {
+			if (len == strlen(cmdtp->name))
+				return cmdtp;
+			found = cmdtp;
+			n_found++;
+		}
+	}
+
+	return n_found == 1 ? found : NULL;
+}
+
+/* Every command and every abbreviation still finds the same entry */
+static void test_find_cmd(void)
+{
+	cmd_tbl_t *start = ll_entry_start(cmd_tbl_t, cmd);
+	const int count = ll_entry_count(cmd_tbl_t, cmd);
+	cmd_tbl_t *cmdtp;
+	char name[64];
+	int len;
+
+	for (cmdtp = start; cmdtp != start + count; cmdtp++) {
+		assert(find_cmd(cmdtp->name) == cmdtp);
+		assert(strlen(cmdtp->name) + 3 <= sizeof(name));
+		for (len = 0; len <= strlen(cmdtp->name); len++) {
+			strncpy(name, cmdtp->name, len);
+			name[len] = '\0';
+			assert(find_cmd(name) == find_cmd_linear(name, len));
+			strcpy(name + len, ".b");
+			assert(find_cmd(name) == find_cmd_linear(name, len));
+		}
+	}
+	assert(find_cmd("ut_cmd") != NULL);
+	assert(find_cmd("no_such_command") == NULL);
+	/* listed as question_mark, so not where its name sorts */
+	assert(find_cmd("?") != NULL);
+	assert(find_cmd("?") == find_cmd_linear("?", 1));
+}
+
 static int do_ut_cmd(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
 	printf("%s: Testing commands\n", __func__);
+	test_find_cmd();
 	run_command("env default -f -a", 0);
 
 	/* commands separated by \n */
@@ -8,10 +8,12 @@
 
 #include <common.h>
 #include <bootm.h>
+#include <chunked_decomp.h>
 #include <command.h>
 #include <malloc.h>
 #include <mapmem.h>
 #include <asm/io.h>
+#include <asm/unaligned.h>
 
 #include <u-boot/zlib.h>
 #include <bzlib.h>
@@ -117,6 +119,28 @@ static const char lz4_compressed[] =
 	"\x9d\x12\x8c\x9d";
 static const unsigned long lz4_compressed_size = 276;
 
+/* lz4 -z --content-size /tmp/plain.txt > /tmp/plain.lz4 */
+static const char lz4_sized_compressed[] =
+	"\x04\x22\x4d\x18\x6c\x40\x5e\x01\x00\x00\x00\x00\x00\x00\x0c\x01"
+	"\x01\x00\x00\xff\x19\x49\x20\x61\x6d\x20\x61\x20\x68\x69\x67\x68"
+	"\x6c\x79\x20\x63\x6f\x6d\x70\x72\x65\x73\x73\x61\x62\x6c\x65\x20"
+	"\x62\x69\x74\x20\x6f\x66\x20\x74\x65\x78\x74\x2e\x0a\x28\x00\x3d"
+	"\xf1\x25\x54\x68\x65\x72\x65\x20\x61\x72\x65\x20\x6d\x61\x6e\x79"
+	"\x20\x6c\x69\x6b\x65\x20\x6d\x65\x2c\x20\x62\x75\x74\x20\x74\x68"
+	"\x69\x73\x20\x6f\x6e\x65\x20\x69\x73\x20\x6d\x69\x6e\x65\x2e\x0a"
+	"\x49\x66\x20\x49\x20\x77\x32\x00\xd1\x6e\x79\x20\x73\x68\x6f\x72"
+	"\x74\x65\x72\x2c\x20\x74\x45\x00\xf4\x0b\x77\x6f\x75\x6c\x64\x6e"
+	"\x27\x74\x20\x62\x65\x20\x6d\x75\x63\x68\x20\x73\x65\x6e\x73\x65"
+	"\x20\x69\x6e\x0a\xcf\x00\x50\x69\x6e\x67\x20\x6d\x12\x00\x00\x32"
+	"\x00\xf0\x11\x20\x66\x69\x72\x73\x74\x20\x70\x6c\x61\x63\x65\x2e"
+	"\x20\x41\x74\x20\x6c\x65\x61\x73\x74\x20\x77\x69\x74\x68\x20\x6c"
+	"\x7a\x6f\x2c\x63\x00\xf5\x14\x77\x61\x79\x2c\x0a\x77\x68\x69\x63"
+	"\x68\x20\x61\x70\x70\x65\x61\x72\x73\x20\x74\x6f\x20\x62\x65\x68"
+	"\x61\x76\x65\x20\x70\x6f\x6f\x72\x6c\x79\x4e\x00\x30\x61\x63\x65"
+	"\x27\x01\x01\x95\x00\x01\x2d\x01\xb0\x0a\x6d\x65\x73\x73\x61\x67"
+	"\x65\x73\x2e\x0a\x00\x00\x00\x00\x9d\x12\x8c\x9d";
+static const unsigned long lz4_sized_compressed_size = 284;
+
 
 #define TEST_BUFFER_SIZE	512
 
@@ -267,6 +291,24 @@ static int compress_using_lz4(void *in, unsigned long in_size,
 	return 0;
 }
 
+/* As above, with the decompressed size in the frame header */
+static int compress_using_lz4_sized(void *in, unsigned long in_size,
+				    void *out, unsigned long out_max,
+				    unsigned long *out_size)
+{
+	assert(in_size == strlen(plain));
+	assert(memcmp(plain, in, in_size) == 0);
+
+	if (lz4_sized_compressed_size > out_max)
+		return -1;
+
+	memcpy(out, lz4_sized_compressed, lz4_sized_compressed_size);
+	if (out_size)
+		*out_size = lz4_sized_compressed_size;
+
+	return 0;
+}
+
 static int uncompress_using_lz4(void *in, unsigned long in_size,
 				void *out, unsigned long out_max,
 				unsigned long *out_size)
@@ -448,10 +490,225 @@ static int run_bootm_test(int comp_type, mutate_func compress)
 	return 0;
 }
 
+/* Size of the data which gzip decompresses in place */
+#define INPLACE_GZIP_SIZE	0x40000
+
+/*
+ * Fill @buf with data which compresses to about half its size: stretches
+ * of the plain text between pseudo-random ones
+ */
+static void fill_inplace_data(u8 *buf, ulong size)
+{
+	ulong plain_len = strlen(plain);
+	u32 seed = 1;
+	ulong i;
+
+	for (i = 0; i < size; i++) {
+		if ((i / plain_len) & 1) {
+			seed = seed * 1103515245 + 12345;
+			buf[i] = seed >> 16;
+		} else {
+			buf[i] = plain[i % plain_len];
+		}
+	}
+}
+
+/* As bootm_decomp_margin() */
+static ulong inplace_margin(int comp_type, ulong image_len, ulong size)
+{
+	if (comp_type == IH_COMP_GZIP)
+		return (size >> 8) + 65536;
+
+	return (image_len >> 8) + 32 + 8;
+}
+
+/**
+ * run_bootm_inplace_test() - Test decompressing an image over itself
+ *
+ * The image is put at the end of the window it decompresses to, first with
+ * just the safety margin past the decompressed data, then with a byte less,
+ * then without, when it must be refused before anything is written. The
+ * compressed data must be larger than the margin for the image to start
+ * inside the window.
+ *
+ * @comp_type:	Compression type to test
+ * @compress:	Our function to compress data, giving the decompressed size
+ * @data:	Data to compress
+ * @unc_len:	Size of the data
+ * @return 0 if OK, non-zero on failure
+ */
+static int run_bootm_inplace_test(int comp_type, mutate_func compress,
+				  const void *data, ulong unc_len)
+{
+	const ulong load_addr = 0x100000;
+	ulong compress_size = unc_len + 0x1000;
+	ulong image_start, load_end;
+	void *buf;
+	int err;
+
+	printf("Testing in place: %s\n", genimg_get_comp_name(comp_type));
+	buf = malloc(compress_size);
+	if (!buf)
+		return -ENOMEM;
+	compress((void *)data, unc_len, buf, compress_size, &compress_size);
+
+	image_start = load_addr + unc_len - compress_size +
+		inplace_margin(comp_type, compress_size, unc_len);
+	if (image_start <= load_addr || image_start >= load_addr + unc_len) {
+		err = -EINVAL;
+		goto out;
+	}
+	memcpy(map_sysmem(image_start, compress_size), buf, compress_size);
+	err = bootm_decomp_image(comp_type, load_addr, image_start,
+				 IH_TYPE_KERNEL, map_sysmem(load_addr, 0),
+				 map_sysmem(image_start, 0), compress_size,
+				 unc_len, &load_end);
+	if (err || load_end != load_addr + unc_len ||
+	    memcmp(map_sysmem(load_addr, unc_len), data, unc_len)) {
+		err = -EINVAL;
+		goto out;
+	}
+
+	/* a byte short of the margin, it might overwrite itself */
+	image_start--;
+	memcpy(map_sysmem(image_start, compress_size), buf, compress_size);
+	err = bootm_decomp_image(comp_type, load_addr, image_start,
+				 IH_TYPE_KERNEL, map_sysmem(load_addr, 0),
+				 map_sysmem(image_start, 0), compress_size,
+				 unc_len, &load_end);
+	if (err != -ENOSPC ||
+	    memcmp(map_sysmem(image_start, compress_size), buf,
+		   compress_size)) {
+		err = -EINVAL;
+		goto out;
+	}
+
+	/* ending with the decompressed data, it would overwrite itself */
+	image_start = load_addr + unc_len - compress_size;
+	memcpy(map_sysmem(image_start, compress_size), buf, compress_size);
+	err = bootm_decomp_image(comp_type, load_addr, image_start,
+				 IH_TYPE_KERNEL, map_sysmem(load_addr, 0),
+				 map_sysmem(image_start, 0), compress_size,
+				 unc_len, &load_end);
+	if (err != -ENOSPC ||
+	    memcmp(map_sysmem(image_start, compress_size), buf,
+		   compress_size)) {
+		err = -EINVAL;
+		goto out;
+	}
+
+	/* decompressing backwards over it is no better */
+	image_start = load_addr - compress_size / 2;
+	memcpy(map_sysmem(image_start, compress_size), buf, compress_size);
+	err = bootm_decomp_image(comp_type, load_addr, image_start,
+				 IH_TYPE_KERNEL, map_sysmem(load_addr, 0),
+				 map_sysmem(image_start, 0), compress_size,
+				 unc_len, &load_end);
+	err = err == -ENOSPC ? 0 : -EINVAL;
+out:
+	free(buf);
+
+	return err;
+}
+
+#ifdef CONFIG_CHUNKED_DECOMP
+/**
+ * run_chunked_test() - Test decompressing an image in chunks
+ *
+ * The image is two chunks of the plain text with an index, laid out as
+ * tools/mkchunked.py does it.
+ *
+ * @comp_type:	Compression type to test
+ * @compress:	Our function to compress data
+ * @return 0 if OK, non-zero on failure
+ */
+static int run_chunked_test(int comp_type, mutate_func compress)
+{
+	const ulong load_addr = 0x1000;
+	const ulong image_start = 0x4000;
+	ulong compress_size = 1024;
+	ulong unc_len = strlen(plain);
+	ulong idx_len, first, image_len, load_end;
+	struct chunked_index *idx;
+	u8 *image, *buf;
+	int err;
+
+	printf("Testing chunked: %s\n", genimg_get_comp_name(comp_type));
+	buf = malloc(compress_size);
+	if (!buf)
+		return -ENOMEM;
+	compress((void *)plain, unc_len, buf, compress_size, &compress_size);
+
+	image = map_sysmem(image_start, 0);
+	idx_len = sizeof(*idx) + 2 * sizeof(idx->entry[0]);
+	if (comp_type == IH_COMP_GZIP) {
+		/* the index is the extra field of the first member */
+		memcpy(image, buf, 10);
+		image[3] |= 4;
+		put_unaligned_le16(4 + idx_len, image + 10);
+		image[12] = CHUNKED_GZIP_SI1;
+		image[13] = CHUNKED_GZIP_SI2;
+		put_unaligned_le16(idx_len, image + 14);
+		idx = (struct chunked_index *)(image + 16);
+		memcpy(image + 16 + idx_len, buf + 10, compress_size - 10);
+		put_unaligned_le32(0, &idx->entry[0].offset);
+		first = 16 + idx_len + compress_size - 10;
+	} else {
+		put_unaligned_le32(CHUNKED_LZ4_MAGIC, image);
+		put_unaligned_le32(idx_len, image + 4);
+		idx = (struct chunked_index *)(image + 8);
+		memcpy(image + 8 + idx_len, buf, compress_size);
+		put_unaligned_le32(8 + idx_len, &idx->entry[0].offset);
+		first = 8 + idx_len + compress_size;
+	}
+	put_unaligned_le32(CHUNKED_MAGIC, &idx->magic);
+	put_unaligned_le32(2, &idx->count);
+	put_unaligned_le32(unc_len, &idx->chunk_size);
+	put_unaligned_le32(unc_len * 2, &idx->size);
+	put_unaligned_le32(first - get_unaligned_le32(&idx->entry[0].offset),
+			   &idx->entry[0].len);
+	put_unaligned_le32(first, &idx->entry[1].offset);
+	put_unaligned_le32(compress_size, &idx->entry[1].len);
+	memcpy(image + first, buf, compress_size);
+	image_len = first + compress_size;
+
+	err = bootm_decomp_image(comp_type, load_addr, image_start,
+				 IH_TYPE_KERNEL, map_sysmem(load_addr, 0),
+				 image, image_len, 0x2000, &load_end);
+	if (err || load_end != load_addr + unc_len * 2 ||
+	    memcmp(map_sysmem(load_addr, unc_len), plain, unc_len) ||
+	    memcmp(map_sysmem(load_addr + unc_len, unc_len), plain, unc_len)) {
+		err = -EINVAL;
+		goto out;
+	}
+
+	/* no room for the second chunk */
+	err = bootm_decomp_image(comp_type, load_addr, image_start,
+				 IH_TYPE_KERNEL, map_sysmem(load_addr, 0),
+				 image, image_len, unc_len * 2 - 1, &load_end);
+	if (!err) {
+		err = -EINVAL;
+		goto out;
+	}
+
+	/* a corrupt second chunk must be noticed */
+	memset(image + first + compress_size / 2, '\x49', compress_size / 2);
+	err = bootm_decomp_image(comp_type, load_addr, image_start,
+				 IH_TYPE_KERNEL, map_sysmem(load_addr, 0),
+				 image, image_len, 0x2000, &load_end);
+	err = err ? 0 : -EINVAL;
+out:
+	free(buf);
+
+	return err;
+}
+#endif
+
 static int do_ut_image_decomp(cmd_tbl_t *cmdtp, int flag, int argc,
 			      char *const argv[])
 {
 	int err = 0;
+	u8 *data;
 
 	err = run_bootm_test(IH_COMP_GZIP, compress_using_gzip);
 	err |= run_bootm_test(IH_COMP_BZIP2, compress_using_bzip2);
@@ -459,6 +716,21 @@ static int do_ut_image_decomp(cmd_tbl_t *cmdtp, int flag, int argc,
 	err |= run_bootm_test(IH_COMP_LZO, compress_using_lzo);
 	err |= run_bootm_test(IH_COMP_LZ4, compress_using_lz4);
 	err |= run_bootm_test(IH_COMP_NONE, compress_using_none);
+	data = malloc(INPLACE_GZIP_SIZE);
+	if (data) {
+		fill_inplace_data(data, INPLACE_GZIP_SIZE);
+		err |= run_bootm_inplace_test(IH_COMP_GZIP, compress_using_gzip,
+					      data, INPLACE_GZIP_SIZE);
+		free(data);
+	} else {
+		err |= -ENOMEM;
+	}
+	err |= run_bootm_inplace_test(IH_COMP_LZ4, compress_using_lz4_sized,
+				      plain, strlen(plain));
+#ifdef CONFIG_CHUNKED_DECOMP
+	err |= run_chunked_test(IH_COMP_GZIP, compress_using_gzip);
+	err |= run_chunked_test(IH_COMP_LZ4, compress_using_lz4);
+#endif
 
 	printf("ut_image_decomp %s\n", err == 0 ? "ok" : "FAILED");
 
@@ -6,6 +6,8 @@
 
 #include <common.h>
 #include <dm.h>
+#include <os.h>
+#include <sandboxblockdev.h>
 #include <usb.h>
 #include <asm/state.h>
 #include <dm/test.h>
@@ -168,3 +170,46 @@ static int dm_test_blk_get_from_parent(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_blk_get_from_parent, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/* Test that blocks are mapped in place, or read if they cannot be mapped */
+static int dm_test_blk_map(struct unit_test_state *uts)
+{
+	const char *fname = "blk_map.img";
+	u8 data[4 * 512], buf[2 * 512];
+	struct udevice *dev, *blk;
+	struct blk_desc *desc;
+	struct blk_map map;
+	int fd, i;
+
+	for (i = 0; i < sizeof(data); i++)
+		data[i] = i * 7;
+	fd = os_open(fname, OS_O_RDWR | OS_O_CREAT);
+	ut_assert(fd >= 0);
+	ut_asserteq(sizeof(data), os_write(fd, data, sizeof(data)));
+	os_close(fd);
+
+	/* a host device maps its backing file */
+	ut_assertok(host_dev_bind(0, (char *)fname));
+	ut_assertok(host_get_dev_err(0, &desc));
+	ut_assertok(blk_dmap(desc, 1, 2, buf, &map));
+	ut_assert(map.mapped);
+	ut_assert(map.buf != buf);
+	ut_assertok(memcmp(data + 512, map.buf, 2 * 512));
+	blk_dunmap(desc, &map);
+	ut_assert(!map.mapped);
+	ut_asserteq(-EINVAL, blk_dmap(desc, 3, 2, buf, &map));
+	ut_assertok(host_dev_bind(0, NULL));
+	os_unlink(fname);
+
+	/* sandbox mmc cannot map, its blocks are read into the buffer */
+	ut_assertok(uclass_get_device(UCLASS_MMC, 0, &dev));
+	ut_assertok(blk_get_from_parent(dev, &blk));
+	desc = dev_get_uclass_platdata(blk);
+	ut_assertok(blk_dmap(desc, 0, 2, buf, &map));
+	ut_assert(!map.mapped);
+	ut_asserteq_ptr(buf, map.buf);
+	blk_dunmap(desc, &map);
+
+	return 0;
+}
+DM_TEST(dm_test_blk_map, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
@@ -13,6 +13,8 @@
 #include <dm/test.h>
 #include <dm/root.h>
 #include <dm/device-internal.h>
+#include <dm/lists.h>
+#include <dm/of_access.h>
 #include <dm/uclass-internal.h>
 #include <dm/util.h>
 #include <test/ut.h>
@@ -419,3 +421,168 @@ static int dm_test_first_next_ok_device(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_first_next_ok_device, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/* What the live tree and driver indexes replace: walks */
+static struct device_node *walk_phandle(phandle handle)
+{
+	struct device_node *np;
+
+	for_each_of_allnodes(np)
+		if (np->phandle == handle)
+			break;
+
+	return np;
+}
+
+static struct device_node *walk_compatible(struct device_node *from,
+					   const char *compat)
+{
+	struct device_node *np;
+
+	for_each_of_allnodes_from(from, np)
+		if (of_device_is_compatible(np, compat, NULL, NULL))
+			break;
+
+	return np;
+}
+
+static struct driver *walk_driver(const char *compat,
+				  const struct udevice_id **idp)
+{
+	struct driver *drv = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	const struct udevice_id *id;
+	struct driver *entry;
+
+	for (entry = drv; entry != drv + n_ents; entry++) {
+		for (id = entry->of_match; id && id->compatible; id++) {
+			if (!strcmp(id->compatible, compat)) {
+				*idp = id;
+				return entry;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/* The indexes find the same nodes and drivers as walks do */
+static int dm_test_of_index(struct unit_test_state *uts)
+{
+	const struct udevice_id *id, *walk_id;
+	struct device_node *np, *found, *walk;
+	const char *compat;
+	struct driver *drv;
+	int i;
+
+	for_each_of_allnodes(np) {
+		if (np->phandle)
+			ut_asserteq_ptr(walk_phandle(np->phandle),
+					of_find_node_by_phandle(np->phandle));
+
+		for (i = 0; !of_property_read_string_index(np, "compatible", i,
+							   &compat); i++) {
+			found = NULL;
+			walk = NULL;
+			do {
+				found = of_find_compatible_node(found, NULL,
+								compat);
+				walk = walk_compatible(walk, compat);
+				ut_asserteq_ptr(walk, found);
+			} while (found);
+
+			drv = lists_driver_lookup_compat(compat, &id);
+			ut_asserteq_ptr(walk_driver(compat, &walk_id), drv);
+			if (drv)
+				ut_asserteq_ptr(walk_id, id);
+		}
+	}
+
+	/* searching from a node which does not match walks on from it */
+	np = of_find_node_by_path("/b-test");
+	ut_assertnonnull(np);
+	ut_asserteq_ptr(walk_compatible(np, "denx,u-boot-fdt-test"),
+			of_find_compatible_node(np, NULL,
+						"denx,u-boot-fdt-test"));
+	ut_asserteq_ptr(walk_compatible(NULL, "DENX,U-Boot-FDT-Test"),
+			of_find_compatible_node(NULL, NULL,
+						"DENX,U-Boot-FDT-Test"));
+	ut_asserteq_ptr(NULL, of_find_compatible_node(NULL, NULL, "no,such"));
+	ut_asserteq_ptr(NULL, of_find_node_by_phandle(0xfffffff0));
+	ut_asserteq_ptr(NULL, lists_driver_lookup_compat("no,such", &id));
+
+	return 0;
+}
+DM_TEST(dm_test_of_index, DM_TESTF_LIVE_TREE);
+
+#define OF_INDEX_LOOPS	100
+
+static void of_index_report(const char *what, ulong walk, ulong indexed)
+{
+	printf("%-10s %8lu us walking, %8lu us indexed\n", what, walk,
+	       indexed);
+}
+
+/*
+ * Time the lookups done while binding the tree and probing its devices:
+ * drivers by compatible string, nodes by phandle and by compatible string.
+ */
+static int dm_test_of_index_bench(struct unit_test_state *uts)
+{
+	const struct udevice_id *id;
+	struct device_node *np;
+	ulong start, walk;
+	const char *compat;
+	int n, i;
+
+	start = timer_get_us();
+	for (n = 0; n < OF_INDEX_LOOPS; n++)
+		for_each_of_allnodes(np)
+			for (i = 0; !of_property_read_string_index(np,
+					"compatible", i, &compat); i++)
+				walk_driver(compat, &id);
+	walk = timer_get_us() - start;
+	start = timer_get_us();
+	for (n = 0; n < OF_INDEX_LOOPS; n++)
+		for_each_of_allnodes(np)
+			for (i = 0; !of_property_read_string_index(np,
+					"compatible", i, &compat); i++)
+				lists_driver_lookup_compat(compat, &id);
+	of_index_report("driver", walk, timer_get_us() - start);
+
+	start = timer_get_us();
+	for (n = 0; n < OF_INDEX_LOOPS; n++)
+		for_each_of_allnodes(np)
+			if (np->phandle)
+				walk_phandle(np->phandle);
+	walk = timer_get_us() - start;
+	start = timer_get_us();
+	for (n = 0; n < OF_INDEX_LOOPS; n++)
+		for_each_of_allnodes(np)
+			if (np->phandle)
+				of_find_node_by_phandle(np->phandle);
+	of_index_report("phandle", walk, timer_get_us() - start);
+
+	start = timer_get_us();
+	for (n = 0; n < OF_INDEX_LOOPS; n++)
+		for_each_of_allnodes(np)
+			if (!of_property_read_string_index(np, "compatible", 0,
+							   &compat))
+				walk_compatible(NULL, compat);
+	walk = timer_get_us() - start;
+	start = timer_get_us();
+	for (n = 0; n < OF_INDEX_LOOPS; n++)
+		for_each_of_allnodes(np)
+			if (!of_property_read_string_index(np, "compatible", 0,
+							   &compat))
+				of_find_compatible_node(NULL, NULL, compat);
+	of_index_report("compatible", walk, timer_get_us() - start);
+
+	/* and a real bind of the whole tree */
+	start = timer_get_us();
+	ut_assertok(dm_scan_fdt(gd->fdt_blob, false));
+	printf("%-10s %8lu us\n", "bind", timer_get_us() - start);
+
+	return 0;
+}
+DM_TEST(dm_test_of_index_bench, DM_TESTF_LIVE_TREE);
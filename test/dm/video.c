@@ -8,12 +8,14 @@
 #include <common.h>
 #include <bzlib.h>
 #include <dm.h>
+#include <malloc.h>
 #include <mapmem.h>
 #include <os.h>
 #include <video.h>
 #include <video_console.h>
 #include <dm/test.h>
 #include <dm/uclass-internal.h>
+#include <power/charge_anim.h>
 #include <test/ut.h>
 
 /*
@@ -351,3 +353,190 @@ static int dm_test_video_truetype_bs(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_video_truetype_bs, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/* Test the software 2D operations on a 24bpp surface */
+static int dm_test_video_2d(struct unit_test_state *uts)
+{
+	struct video_surface surf, src;
+	u8 buf[8 * 6 * 3], img[2 * 3 * 4];
+	u8 *pix;
+	int i;
+
+	surf.base = buf;
+	surf.line_length = 8 * 3;
+	surf.xsize = 8;
+	surf.ysize = 6;
+	surf.bytes_pp = 3;
+
+	/* whole surface, then a rectangle clipped at the right edge */
+	ut_assertok(video_fill_rect(NULL, &surf, 0, 0, 8, 6, 0x112233));
+	for (i = 0; i < 8 * 6; i++) {
+		ut_asserteq(0x33, buf[i * 3]);
+		ut_asserteq(0x22, buf[i * 3 + 1]);
+		ut_asserteq(0x11, buf[i * 3 + 2]);
+	}
+	ut_assertok(video_fill_rect(NULL, &surf, 6, 1, 5, 2, 0xaabbcc));
+	ut_asserteq(0x33, buf[(1 * 8 + 5) * 3]);
+	ut_asserteq(0xcc, buf[(1 * 8 + 6) * 3]);
+	ut_asserteq(0xcc, buf[(2 * 8 + 7) * 3]);
+	ut_asserteq(0x33, buf[(3 * 8 + 7) * 3]);
+
+	/* overlapping copy downwards, as a console scroll in reverse */
+	ut_assertok(video_copy_rect(NULL, &surf, 0, 2, &surf, 0, 1, 8, 3));
+	ut_asserteq(0xcc, buf[(1 * 8 + 6) * 3]);
+	ut_asserteq(0xcc, buf[(2 * 8 + 6) * 3]);
+	ut_asserteq(0xcc, buf[(3 * 8 + 7) * 3]);
+	ut_asserteq(0x33, buf[(4 * 8 + 7) * 3]);
+
+	/* opaque and transparent ARGB pixels */
+	src.base = img;
+	src.line_length = 2 * 4;
+	src.xsize = 2;
+	src.ysize = 3;
+	src.bytes_pp = 4;
+	memset(img, '\0', sizeof(img));
+	img[0] = 0x55;
+	img[3] = 0xff;
+	ut_assertok(video_blend_rect(NULL, &surf, 0, 0, &src, 0, 0, 2, 1,
+				     255));
+	ut_asserteq(0x55, buf[0]);
+	ut_asserteq(0x33, buf[3]);
+
+	/* 2x3 image rotated clockwise becomes 3x2 */
+	surf.bytes_pp = 4;
+	surf.line_length = 8 * 4;
+	surf.ysize = 3;
+	img[1 * 4] = 0x77;
+	ut_assertok(video_rotate_copy(NULL, &surf, 0, 0, &src, 1));
+	pix = buf + 2 * 4;
+	ut_asserteq(0x55, pix[0]);
+	pix = buf + 8 * 4 + 2 * 4;
+	ut_asserteq(0x77, pix[0]);
+	ut_asserteq(-ERANGE, video_rotate_copy(NULL, &surf, 6, 0, &src, 1));
+
+	return 0;
+}
+DM_TEST(dm_test_video_2d, 0);
+
+#ifdef CONFIG_CHARGE_ANIM_CONTAINER
+/* Add a run of @len pixels of @colour to a 16bpp charge animation frame */
+static void *charge_anim_test_run(void *p, int x, int y, int len, u16 colour)
+{
+	struct charge_anim_run *run = p;
+	u16 *pix = p + sizeof(*run);
+	int i;
+
+	run->y = cpu_to_le16(y);
+	run->x = cpu_to_le16(x);
+	run->len = cpu_to_le16(len);
+	run->reserved = 0;
+	for (i = 0; i < len; i++)
+		pix[i] = cpu_to_le16(colour);
+
+	return p + sizeof(*run) + ALIGN(len * sizeof(u16), 4);
+}
+
+/* Test that text drawn between two delta frames does not stay around */
+static int dm_test_video_charge_anim(struct unit_test_state *uts)
+{
+	char saved[CHARGE_ANIM_ALIGN];
+	struct charge_anim_header *hdr;
+	struct charge_anim_frame *frames;
+	struct video_surface surface;
+	struct charge_anim anim;
+	struct udevice *dev;
+	void *buf, *p, *start;
+	u16 *row10, *row20;
+	int x, y;
+
+	ut_assertok(uclass_get_device(UCLASS_VIDEO, 0, &dev));
+	video_get_surface(dev, &surface);
+	buf = calloc(1, 3 << 20);
+	ut_assertnonnull(buf);
+
+	/* a container as tools/mkchargeanim.py makes it, already read in */
+	hdr = buf;
+	frames = buf + sizeof(*hdr);
+	memcpy(hdr->magic, CHARGE_ANIM_MAGIC, sizeof(hdr->magic));
+	hdr->version = cpu_to_le16(CHARGE_ANIM_VERSION);
+	hdr->frame_num = cpu_to_le16(3);
+	hdr->width = cpu_to_le16(surface.xsize);
+	hdr->height = cpu_to_le16(surface.ysize);
+	hdr->bytes_pp = surface.bytes_pp;
+
+	/* a grey key frame, then two deltas */
+	p = buf + CHARGE_ANIM_ALIGN;
+	frames[0].offset = cpu_to_le32(p - buf);
+	frames[0].flags = cpu_to_le16(CHARGE_ANIM_FRAME_KEY);
+	for (y = 0; y < surface.ysize; y++)
+		p = charge_anim_test_run(p, 0, y, surface.xsize, 0x1111);
+	p = charge_anim_test_run(p, 0, 0, 0, 0);
+	frames[0].size = cpu_to_le32(p - buf - CHARGE_ANIM_ALIGN);
+
+	start = p = buf + ALIGN(p - buf, CHARGE_ANIM_ALIGN);
+	frames[1].offset = cpu_to_le32(p - buf);
+	p = charge_anim_test_run(p, 100, 10, 10, 0x2222);
+	p = charge_anim_test_run(p, 0, 0, 0, 0);
+	frames[1].size = cpu_to_le32(p - start);
+
+	start = p = buf + ALIGN(p - buf, CHARGE_ANIM_ALIGN);
+	frames[2].offset = cpu_to_le32(p - buf);
+	p = charge_anim_test_run(p, 100, 10, 10, 0x3333);
+	p = charge_anim_test_run(p, 0, 20, 10, 0x3333);
+	p = charge_anim_test_run(p, 0, 0, 0, 0);
+	frames[2].size = cpu_to_le32(p - start);
+	hdr->size = cpu_to_le32(p - buf);
+
+	/* set up as charge_anim_open() leaves it, with all frames loaded */
+	memset(&anim, '\0', sizeof(anim));
+	anim.name = "test.anim";
+	anim.buf = buf;
+	anim.cur = -1;
+
+	/* the frame table must stay inside the container */
+	memcpy(saved, buf, sizeof(saved));
+	frames[2].size = cpu_to_le32(p - start + CHARGE_ANIM_ALIGN);
+	ut_asserteq(-EINVAL, charge_anim_parse(&anim, 3 << 20));
+	memcpy(buf, saved, sizeof(saved));
+	hdr->magic[0] = 'X';
+	ut_asserteq(-EINVAL, charge_anim_parse(&anim, 3 << 20));
+	memcpy(buf, saved, sizeof(saved));
+	ut_asserteq(-ENOSPC, charge_anim_parse(&anim, CHARGE_ANIM_ALIGN));
+	memcpy(buf, saved, sizeof(saved));
+
+	ut_assertok(charge_anim_parse(&anim, 3 << 20));
+	ut_asserteq(3, anim.hdr->frame_num);
+	ut_asserteq_ptr(dev, anim.video);
+	anim.loaded = BIT(3) - 1;
+
+	row10 = surface.base + 10 * surface.line_length;
+	row20 = surface.base + 20 * surface.line_length;
+	ut_assertok(charge_anim_show(&anim, 0));
+	ut_assertok(charge_anim_show(&anim, 1));
+	ut_asserteq(0x2222, row10[100]);
+
+	/* text over part of what frame 2 changes, and more */
+	for (x = 0; x < 20; x++)
+		row20[x] = 0xffff;
+
+	/* the delta leaves the text where it does not change */
+	ut_assertok(charge_anim_show(&anim, 2));
+	ut_asserteq(0x3333, row20[0]);
+	ut_asserteq(0xffff, row20[10]);
+
+	/* once invalidated, the frame is drawn whole */
+	charge_anim_invalidate(&anim);
+	ut_assertok(charge_anim_show(&anim, 2));
+	ut_asserteq(0x3333, row20[0]);
+	ut_asserteq(0x3333, row20[9]);
+	ut_asserteq(0x1111, row20[10]);
+	ut_asserteq(0x1111, row20[19]);
+	ut_asserteq(0x3333, row10[100]);
+	ut_asserteq(0x1111, row10[99]);
+
+	free(buf);
+
+	return 0;
+}
+DM_TEST(dm_test_video_charge_anim, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+#endif
@@ -0,0 +1,143 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <malloc.h>
+#include <search.h>
+#include <test/env.h>
+#include <test/ut.h>
+
+#define HTAB_VARS		200
+#define HTAB_GET_LOOPS		50
+#define HTAB_SET_LOOPS		10
+#define HTAB_IO_LOOPS		20
+#define HTAB_ENV_SIZE		0x4000
+
+static char htab_names[HTAB_VARS][8];
+
+/* Sorted "varNNN=..." list, like a stored environment */
+static ulong htab_env(char *buf, const char *fmt)
+{
+	ulong len = 0;
+	int i;
+
+	for (i = 0; i < HTAB_VARS; i++) {
+		len += sprintf(buf + len, "var%03d=", i);
+		len += sprintf(buf + len, fmt, i) + 1;
+	}
+	buf[len] = '\0';
+
+	return len;
+}
+
+static void htab_report(const char *what, int ops, ulong us)
+{
+	printf("%-8s %6d ops %8lu us %6lu ns/op\n", what, ops, us,
+	       ops ? us * 1000 / ops : 0);
+}
+
+/*
+ * Time the operations boot scripts do on the environment. Build with and
+ * without CONFIG_HASHTABLE_ARENA to compare both implementations.
+ */
+static int env_test_htab_bench(struct unit_test_state *uts)
+{
+	struct hsearch_data htab;
+	char *env, *res, *p;
+	char name[16], value[32];
+	ulong len, start;
+	ENTRY e, *ep;
+	int i, n;
+
+	env = malloc(HTAB_ENV_SIZE);
+	res = malloc(HTAB_ENV_SIZE);
+	ut_assertnonnull(env);
+	ut_assertnonnull(res);
+	memset(&htab, '\0', sizeof(htab));
+	len = htab_env(env, "setenv bootargs ${bootargs} opt%d=1");
+	for (i = 0; i < HTAB_VARS; i++)
+		sprintf(htab_names[i], "var%03d", i);
+
+	start = timer_get_us();
+	for (n = 0; n < HTAB_IO_LOOPS; n++)
+		ut_assert(himport_r(&htab, env, len + 1, '\0', 0, 0, 0, NULL));
+	htab_report("import", n, timer_get_us() - start);
+	ut_asserteq(HTAB_VARS, htab.filled);
+
+	start = timer_get_us();
+	for (n = 0; n < HTAB_GET_LOOPS; n++) {
+		for (i = 0; i < HTAB_VARS; i++) {
+			e.key = htab_names[i];
+			e.data = NULL;
+			hsearch_r(e, FIND, &ep, &htab, 0);
+			ut_assertnonnull(ep);
+		}
+	}
+	htab_report("get", n * HTAB_VARS, timer_get_us() - start);
+	e.key = "var";
+	hsearch_r(e, FIND, &ep, &htab, 0);
+	ut_asserteq_ptr(NULL, ep);
+
+	/* exporting what was imported gives the same list back */
+	start = timer_get_us();
+	for (n = 0; n < HTAB_IO_LOOPS; n++)
+		ut_assert(hexport_r(&htab, '\0', 0, &res, HTAB_ENV_SIZE,
+				    0, NULL) > 0);
+	htab_report("export", n, timer_get_us() - start);
+	ut_assertok(memcmp(env, res, len + 1));
+
+	/* overwrite every variable, growing and shrinking the values */
+	start = timer_get_us();
+	for (n = 0; n < HTAB_SET_LOOPS; n++) {
+		sprintf(value, n & 1 ? "%d" : "a longer value %d", n);
+		for (i = 0; i < HTAB_VARS; i++) {
+			e.key = htab_names[i];
+			e.data = value;
+			hsearch_r(e, ENTER, &ep, &htab, 0);
+			ut_assertnonnull(ep);
+			ut_asserteq_str(value, ep->data);
+		}
+	}
+	htab_report("set", n * HTAB_VARS, timer_get_us() - start);
+
+	/* new variables out of order and deletes keep the export sorted */
+	start = timer_get_us();
+	for (i = HTAB_VARS - 1; i >= 0; i--) {
+		sprintf(name, "new%03d", i);
+		e.key = name;
+		e.data = "1";
+		hsearch_r(e, ENTER, &ep, &htab, 0);
+		ut_assertnonnull(ep);
+	}
+	for (i = 0; i < HTAB_VARS; i++) {
+		sprintf(name, "new%03d", i);
+		ut_assert(hdelete_r(name, &htab, 0));
+	}
+	htab_report("add/del", 2 * HTAB_VARS, timer_get_us() - start);
+
+	ut_asserteq(HTAB_VARS, htab.filled);
+	n = HTAB_SET_LOOPS - 1;
+	sprintf(value, n & 1 ? "%d" : "a longer value %d", n);
+	for (i = 0; i < HTAB_VARS; i++) {
+		e.key = htab_names[i];
+		hsearch_r(e, FIND, &ep, &htab, 0);
+		ut_assertnonnull(ep);
+		ut_asserteq_str(value, ep->data);
+	}
+	ut_assert(hexport_r(&htab, '\0', 0, &res, HTAB_ENV_SIZE, 0, NULL) > 0);
+	for (i = 0, p = res; *p && i < HTAB_VARS; i++) {
+		ut_assertok(strncmp(p, htab_names[i], strlen(htab_names[i])));
+		p += strlen(p) + 1;
+	}
+	ut_asserteq(HTAB_VARS, i);
+
+	hdestroy_r(&htab);
+	free(res);
+	free(env);
+
+	return 0;
+}
+ENV_TEST(env_test_htab_bench, 0);
@@ -0,0 +1,97 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <cli_hush.h>
+#include <test/env.h>
+#include <test/ut.h>
+
+#define HUSH_RUNS	50
+
+/* Scan for a boot partition the way boot.scr does, with lots of loops */
+static const char hush_script[] =
+	"setenv found\n"
+	"setenv tries\n"
+	"for dev in 0 1 2 3; do\n"
+	"  for part in 1 2 3 4; do\n"
+	"    if test -n \"${found}\"; then\n"
+	"      true\n"
+	"    elif test \"${dev}:${part}\" = \"2:3\"; then\n"
+	"      setenv found ${dev}:${part}\n"
+	"    else\n"
+	"      setenv tries ${tries}.\n"
+	"    fi\n"
+	"  done\n"
+	"done\n";
+
+static int hush_check(struct unit_test_state *uts)
+{
+	ut_asserteq_str("2:3", env_get("found"));
+	ut_asserteq_str("..........", env_get("tries"));
+
+	return 0;
+}
+
+/* Time the same script run with and without the cache */
+static int env_test_hush_cache_bench(struct unit_test_state *uts)
+{
+	struct hush_cache_stats before, after;
+	ulong start, parsed, cached;
+	int n;
+
+	ut_assertok(env_set("hush_script", hush_script));
+
+	start = timer_get_us();
+	for (n = 0; n < HUSH_RUNS; n++) {
+		hush_cache_flush();
+		ut_assertok(run_command("run hush_script", 0));
+	}
+	parsed = timer_get_us() - start;
+	ut_assertok(hush_check(uts));
+
+	hush_cache_get_stats(&before);
+	start = timer_get_us();
+	for (n = 0; n < HUSH_RUNS; n++)
+		ut_assertok(run_command("run hush_script", 0));
+	cached = timer_get_us() - start;
+	hush_cache_get_stats(&after);
+	ut_assertok(hush_check(uts));
+
+	/* "run hush_script" and the script itself */
+	ut_asserteq(2 * HUSH_RUNS, after.hits - before.hits);
+	ut_asserteq(0, after.misses - before.misses);
+	printf("parsed %lu us, cached %lu us for %d runs, %lu bytes cached\n",
+	       parsed, cached, n, after.bytes);
+	env_set("hush_script", NULL);
+
+	return 0;
+}
+ENV_TEST(env_test_hush_cache_bench, 0);
+
+/* A cached script still runs what comes after an exit which is not taken */
+static int env_test_hush_cache_exit(struct unit_test_state *uts)
+{
+	static const char script[] =
+		"setenv after\n"
+		"if test \"${stop}\" = 1; then exit; fi\n"
+		"setenv after 1\n";
+
+	hush_cache_flush();
+	env_set("stop", "1");
+	ut_assertok(run_command_list(script, -1, 0));
+	ut_asserteq_ptr(NULL, env_get("after"));
+	ut_assertok(run_command_list(script, -1, 0));
+	ut_asserteq_ptr(NULL, env_get("after"));
+
+	env_set("stop", "0");
+	ut_assertok(run_command_list(script, -1, 0));
+	ut_asserteq_str("1", env_get("after"));
+	env_set("stop", NULL);
+	env_set("after", NULL);
+
+	return 0;
+}
+ENV_TEST(env_test_hush_cache_exit, 0);
@@ -0,0 +1,238 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <env_journal.h>
+#include <errno.h>
+#include <test/env.h>
+#include <test/ut.h>
+
+#define JRN_BLKSZ	64
+#define JRN_SIZE	(2 * 512)
+#define JRN_IMAGE_SIZE	512
+
+/*
+ * Journal in RAM which loses power at write number @fail_at: that write is
+ * either dropped or only half done (@tear), all later writes are lost.
+ */
+struct jrn_dev {
+	char mem[JRN_SIZE];
+	int writes;
+	int fail_at;
+	bool tear;
+};
+
+static int jrn_dev_read(struct env_journal *jrn, ulong offset, ulong len,
+			void *buf)
+{
+	struct jrn_dev *dev = jrn->priv;
+
+	memcpy(buf, dev->mem + offset, len);
+
+	return 0;
+}
+
+static int jrn_dev_write(struct env_journal *jrn, ulong offset, ulong len,
+			 const void *buf)
+{
+	struct jrn_dev *dev = jrn->priv;
+
+	if (dev->fail_at >= 0 && dev->writes >= dev->fail_at) {
+		if (dev->writes++ == dev->fail_at && dev->tear)
+			memcpy(dev->mem + offset, buf, len / 2);
+		return -EIO;
+	}
+	dev->writes++;
+	memcpy(dev->mem + offset, buf, len);
+
+	return 0;
+}
+
+static void jrn_setup(struct env_journal *jrn, struct jrn_dev *dev,
+		      char *image)
+{
+	memset(jrn, '\0', sizeof(*jrn));
+	jrn->size = JRN_SIZE;
+	jrn->blksz = JRN_BLKSZ;
+	jrn->read = jrn_dev_read;
+	jrn->write = jrn_dev_write;
+	jrn->priv = dev;
+	jrn->image = image;
+	jrn->image_size = JRN_IMAGE_SIZE;
+	dev->writes = 0;
+	dev->fail_at = -1;
+}
+
+/* Build an image from a NULL-terminated list of sorted "name=value" */
+static ulong jrn_image(char *buf, const char *const vars[])
+{
+	ulong len = 0;
+
+	for (; *vars; vars++) {
+		strcpy(buf + len, *vars);
+		len += strlen(*vars) + 1;
+	}
+	buf[len] = '\0';
+
+	return len;
+}
+
+static const char *const jrn_steps[][6] = {
+	{ "arch=arm", "board=odroidgoa", "bootdelay=0", NULL },
+	{ "arch=arm", "board=odroidgoa", "bootdelay=3", NULL },
+	{ "arch=arm", "board=odroidgoa", "bootdelay=3", "serial#=1234", NULL },
+	{ "arch=arm", "bootdelay=3", "serial#=1234", NULL },
+	/* long values, so that the first half fills up and is compacted */
+	{ "arch=arm", "bootargs=console=ttyFIQ0 root=/dev/mmcblk0p2 rw "
+	  "rootwait quiet splash loglevel=0 fbcon=rotate:3",
+	  "bootdelay=3", "serial#=1234", NULL },
+	{ "arch=arm", "bootargs=console=ttyFIQ0 root=/dev/mmcblk0p2 rw "
+	  "rootwait", "bootcmd=run distro_bootcmd", "bootdelay=3",
+	  "serial#=1234", NULL },
+};
+
+static bool jrn_is(struct env_journal *jrn, const char *image, ulong len)
+{
+	return jrn->image_len == len && !memcmp(jrn->image, image, len);
+}
+
+static int jrn_check(struct unit_test_state *uts, struct jrn_dev *dev,
+		     u32 base_crc, const char *expect, ulong len)
+{
+	char image[JRN_IMAGE_SIZE];
+	struct env_journal jrn;
+
+	jrn_setup(&jrn, dev, image);
+	ut_assertok(env_journal_load(&jrn, base_crc));
+	ut_assert(jrn_is(&jrn, expect, len));
+
+	return 0;
+}
+
+/* Every save survives a power loss at any of its writes */
+static int env_test_journal_power_loss(struct unit_test_state *uts)
+{
+	static struct jrn_dev dev, saved;
+	char image[JRN_IMAGE_SIZE], before[JRN_IMAGE_SIZE];
+	char after[JRN_IMAGE_SIZE];
+	ulong before_len, after_len;
+	struct env_journal jrn;
+	bool compacted = false;
+	int step, fail, writes, half, ret;
+	u32 base_crc = 0x12345678;
+
+	memset(dev.mem, '\0', sizeof(dev.mem));
+	jrn_setup(&jrn, &dev, image);
+	ut_asserteq(-ENOENT, env_journal_load(&jrn, base_crc));
+
+	before_len = 0;
+	before[0] = '\0';
+	for (step = 0; step < ARRAY_SIZE(jrn_steps); step++) {
+		after_len = jrn_image(after, jrn_steps[step]);
+		saved = dev;
+
+		/* count the writes of this save */
+		jrn_setup(&jrn, &dev, image);
+		env_journal_load(&jrn, base_crc);
+		half = jrn.half;
+		ut_assertok(env_journal_save(&jrn, after, after_len));
+		writes = dev.writes;
+		ut_assert(writes > 0);
+		if (step && jrn.half != half)
+			compacted = true;
+
+		for (fail = 0; fail < writes * 2; fail++) {
+			dev = saved;
+			jrn_setup(&jrn, &dev, image);
+			env_journal_load(&jrn, base_crc);
+			dev.fail_at = fail / 2;
+			dev.tear = fail & 1;
+			ut_asserteq(-EIO, env_journal_save(&jrn, after,
+							  after_len));
+
+			/*
+			 * A torn last block may still hold the commit, so
+			 * either environment is fine, but nothing in between.
+			 * The first save has nothing to fall back to.
+			 */
+			jrn_setup(&jrn, &dev, image);
+			ret = env_journal_load(&jrn, base_crc);
+			if (!step && ret == -ENOENT)
+				continue;
+			ut_assertok(ret);
+			ut_assert((step && jrn_is(&jrn, before, before_len)) ||
+				  jrn_is(&jrn, after, after_len));
+		}
+
+		/* power back, do the save for real */
+		dev = saved;
+		jrn_setup(&jrn, &dev, image);
+		env_journal_load(&jrn, base_crc);
+		ut_assertok(env_journal_save(&jrn, after, after_len));
+		ut_assertok(jrn_check(uts, &dev, base_crc, after, after_len));
+
+		memcpy(before, after, after_len + 1);
+		before_len = after_len;
+	}
+	ut_assert(compacted);
+
+	/* saving the same environment again writes nothing */
+	jrn_setup(&jrn, &dev, image);
+	ut_assertok(env_journal_load(&jrn, base_crc));
+	ut_assertok(env_journal_save(&jrn, before, before_len));
+	ut_asserteq(0, dev.writes);
+
+	return 0;
+}
+ENV_TEST(env_test_journal_power_loss, 0);
+
+static int env_test_journal_legacy(struct unit_test_state *uts)
+{
+	static const char *const vars[] = { "a=1", "b=2", NULL };
+	static const char *const vars2[] = { "a=1", "b=3", NULL };
+	static struct jrn_dev dev;
+	char image[JRN_IMAGE_SIZE], env[JRN_IMAGE_SIZE];
+	struct env_journal jrn;
+	ulong len;
+
+	memset(dev.mem, '\0', sizeof(dev.mem));
+	len = jrn_image(env, vars);
+	jrn_setup(&jrn, &dev, image);
+	ut_asserteq(-ENOENT, env_journal_load(&jrn, 1));
+	ut_assertok(env_journal_save(&jrn, env, len));
+	ut_assertok(jrn_check(uts, &dev, 1, env, len));
+
+	/* the legacy environment was rewritten behind the journal's back */
+	jrn_setup(&jrn, &dev, image);
+	ut_asserteq(-ESTALE, env_journal_load(&jrn, 2));
+
+	/* after a legacy save the journal is dropped */
+	jrn_setup(&jrn, &dev, image);
+	ut_assertok(env_journal_load(&jrn, 1));
+	ut_assertok(env_journal_erase(&jrn, 2));
+	jrn_setup(&jrn, &dev, image);
+	ut_asserteq(-ENOENT, env_journal_load(&jrn, 2));
+
+	/* saves from before the erase are not replayed over a new journal */
+	ut_assertok(env_journal_save(&jrn, env, len));
+	len = jrn_image(env, vars2);
+	ut_assertok(env_journal_save(&jrn, env, len));
+	ut_assertok(env_journal_erase(&jrn, 3));
+	jrn_setup(&jrn, &dev, image);
+	ut_asserteq(-ENOENT, env_journal_load(&jrn, 3));
+	len = jrn_image(env, vars);
+	ut_assertok(env_journal_save(&jrn, env, len));
+	ut_assertok(jrn_check(uts, &dev, 3, env, len));
+
+	/* an environment larger than a half goes to the legacy block */
+	memset(env, 'x', JRN_IMAGE_SIZE - 1);
+	memcpy(env, "big=", 4);
+	env[JRN_IMAGE_SIZE - 1] = '\0';
+	ut_asserteq(-ENOSPC, env_journal_save(&jrn, env, JRN_IMAGE_SIZE - 1));
+
+	return 0;
+}
+ENV_TEST(env_test_journal_legacy, 0);
@@ -8,6 +8,7 @@ import os
 import pytest
 import struct
 import u_boot_utils as util
+import zlib
 
 # Define a base ITS which we can adjust using % and a dictionary
 base_its = '''
@@ -426,3 +427,296 @@ def test_fit(u_boot_console):
         # Go back to the original U-Boot with the correct dtb.
         cons.config.dtb = old_dtb
         cons.restart_uboot()
+
+# A FIT with external data and several hashes per image, for checking the
+# hashes while the FIT is loaded
+verify_its = '''
+/dts-v1/;
+
+/ {
+        description = "FIT with external data";
+        #address-cells = <1>;
+
+        images {
+                kernel@1 {
+                        data = /incbin/("%(kernel)s");
+                        type = "kernel";
+                        arch = "sandbox";
+                        os = "linux";
+                        compression = "none";
+                        load = <0x40000>;
+                        entry = <0x40000>;
+                        hash@1 {
+                                algo = "sha256";
+                        };
+                        hash@2 {
+                                algo = "crc32";
+                        };
+                };
+                ramdisk@1 {
+                        data = /incbin/("%(ramdisk)s");
+                        type = "ramdisk";
+                        arch = "sandbox";
+                        os = "linux";
+                        compression = "none";
+                        hash@1 {
+                                algo = "sha1";
+                        };
+                };
+        };
+        configurations {
+                default = "conf@1";
+                conf@1 {
+                        kernel = "kernel@1";
+                        ramdisk = "ramdisk@1";
+                };
+        };
+};
+'''
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('fit_verify_on_load')
+def test_fit_verify_load(u_boot_console):
+    """Test that 'load' checks the hashes of a FIT with external data"""
+
+    cons = u_boot_console
+    mkimage = cons.config.build_dir + '/tools/mkimage'
+    kernel = os.path.join(cons.config.result_dir, 'verify-kernel.bin')
+    ramdisk = os.path.join(cons.config.result_dir, 'verify-ramdisk.bin')
+    its = os.path.join(cons.config.result_dir, 'verify.its')
+    fit = os.path.join(cons.config.result_dir, 'verify.fit')
+
+    # the kernel spans several chunks of the load
+    with open(kernel, 'wb') as fd:
+        fd.write(os.urandom(3 * 1024 * 1024 + 100))
+    with open(ramdisk, 'wb') as fd:
+        fd.write(os.urandom(5000))
+    with open(its, 'w') as fd:
+        print >> fd, verify_its % {'kernel': kernel, 'ramdisk': ramdisk}
+    util.run_and_log(cons, [mkimage, '-E', '-f', its, fit])
+
+    load = 'sb load hostfs 0 1000000 %s' % fit
+    output = cons.run_command(load)
+    assert 'while loading' in output
+    assert 'Image kernel@1: sha256+ (' in output
+    assert 'crc32+ (' in output
+    assert 'Image ramdisk@1: sha1+ (' in output
+    assert 'Bad hash value' not in output
+
+    # bootm and iminfo take the hashes checked while loading
+    output = cons.run_command('iminfo 1000000')
+    assert 'sha256-loaded+' in output
+    assert 'sha1-loaded+' in output
+
+    # but only once, the images may have been changed since
+    output = cons.run_command('iminfo 1000000')
+    assert '-loaded' not in output
+    assert 'sha256+' in output
+
+    # a change in the last image's data is noticed as it is loaded
+    with open(fit, 'r+b') as fd:
+        fd.seek(-10, os.SEEK_END)
+        byte = fd.read(1)
+        fd.seek(-10, os.SEEK_END)
+        fd.write(chr(ord(byte) ^ 0xff))
+    output = cons.run_command(load)
+    assert 'Image ramdisk@1: sha1- (' in output
+    assert 'Bad hash value' in output
+    output = cons.run_command('iminfo 1000000')
+    assert 'sha1-loaded' not in output
+    assert "Bad hash value for 'hash@1' hash node in 'ramdisk@1'" in output
+
+# A FIT with one kernel and the device trees of many boards
+index_boards = 50
+
+index_fdt = '''
+/dts-v1/;
+
+/ {
+        model = "Board %(n)d";
+        compatible = "vendor,board-%(n)d", "vendor,family";
+};
+'''
+
+# Not a configuration, the index is tampered with to point at it
+index_decoy = '''
+        decoy {
+                kernel = "kernel@1";
+                fdt = "fdt@37";
+        };'''
+
+def fdt_scan(fname):
+    """Scan a device tree blob
+
+    Returns:
+        Tuple: contents of the file, dictionary of node offsets by path,
+        dictionary of (file position, size) of property values by path
+    """
+    with open(fname, 'rb') as fd:
+        data = fd.read()
+    hdr = struct.unpack('>10L', data[:40])
+    off_struct, off_strings = hdr[2], hdr[3]
+    nodes, props, path = {}, {}, []
+    pos = off_struct
+    while True:
+        tag, = struct.unpack('>L', data[pos:pos + 4])
+        offset = pos - off_struct
+        pos += 4
+        if tag == 1:    # FDT_BEGIN_NODE
+            end = data.index('\0', pos)
+            path.append(data[pos:end])
+            nodes['/'.join(path) or '/'] = offset
+            pos = (end + 4) & ~3
+        elif tag == 2:  # FDT_END_NODE
+            path.pop()
+        elif tag == 3:  # FDT_PROP
+            size, nameoff = struct.unpack('>LL', data[pos:pos + 8])
+            name = data[off_strings + nameoff:
+                        data.index('\0', off_strings + nameoff)]
+            props['/'.join(path) + '/' + name] = (pos + 8, size)
+            pos = (pos + 8 + size + 3) & ~3
+        elif tag == 9:  # FDT_END
+            return data, nodes, props
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('fit_index')
+@pytest.mark.buildconfigspec('fit_best_match')
+def test_fit_index(u_boot_console):
+    """Test that U-Boot finds the same nodes with and without an index"""
+
+    def make_fname(leaf):
+        return os.path.join(cons.config.build_dir, 'index-' + leaf)
+
+    def make_fit(index):
+        images = ['''
+                kernel@1 {
+                        data = /incbin/("%s");
+                        type = "kernel";
+                        arch = "sandbox";
+                        os = "linux";
+                        compression = "none";
+                        load = <0x40000>;
+                        entry = <0x40000>;
+                };''' % kernel]
+        confs = []
+        for n in range(1, index_boards + 1):
+            src = make_fname('%d.dts' % n)
+            dtb = make_fname('%d.dtb' % n)
+            with open(src, 'w') as fd:
+                print >> fd, index_fdt % {'n': n}
+            util.run_and_log(cons, ['dtc', src, '-O', 'dtb', '-o', dtb])
+            images.append('''
+                fdt@%d {
+                        data = /incbin/("%s");
+                        type = "flat_dt";
+                        arch = "sandbox";
+                        compression = "none";
+                };''' % (n, dtb))
+            confs.append('''
+                conf@%d {
+                        kernel = "kernel@1";
+                        fdt = "fdt@%d";
+                };''' % (n, n))
+        its = make_fname('fit.its')
+        fit = make_fname('fit%s.fit' % ('-index' if index else ''))
+        with open(its, 'w') as fd:
+            print >> fd, '/dts-v1/;\n/ {%s' % index_decoy
+            print >> fd, '\timages {%s\n\t};' % ''.join(images)
+            print >> fd, ('\tconfigurations {\n\t\tdefault = "conf@1";%s\n'
+                          '\t};\n};' % ''.join(confs))
+        args = [mkimage, '-f', its, fit]
+        if index:
+            args.insert(1, '-I')
+        output = util.run_and_log(cons, args)
+        if index:
+            assert ('Index:           %d images, %d configurations, '
+                    '%d compatibles' % (index_boards + 1, index_boards,
+                                        2 * index_boards)) in output
+        return fit
+
+    def bootm(conf):
+        """Return which configuration and FDT bootm picks"""
+        output = cons.run_command('bootm start 1000000%s' % conf)
+        return [line.strip() for line in output.splitlines()
+                if 'Using' in line or 'Trying' in line]
+
+    cons = u_boot_console
+    mkimage = cons.config.build_dir + '/tools/mkimage'
+    kernel = make_fname('kernel.bin')
+    with open(kernel, 'wb') as fd:
+        fd.write(os.urandom(4096))
+
+    expect = {}
+    for index in [False, True]:
+        fit = make_fit(index)
+        cons.run_command('sb load hostfs 0 1000000 %s' % fit)
+        output = cons.run_command('iminfo 1000000')
+        assert ('Index:' in output) == index
+        for n in [1, 37, index_boards]:
+            picked = bootm('#conf@%d' % n)
+            assert "Using 'conf@%d' configuration" % n in picked
+            assert "Trying 'fdt@%d' fdt subimage" % n in picked
+            assert picked == expect.setdefault(n, picked)
+
+    # a change in the FIT leaves the index out of date, it is not used then
+    cons.run_command('fdt addr 1000000')
+    cons.run_command('fdt resize')
+    cons.run_command('fdt mknode /images extra@1')
+    output = cons.run_command('iminfo 1000000')
+    assert 'Index:           out of date' in output
+    assert bootm('#conf@37') == expect[37]
+
+    def tamper(fit):
+        """Point the index entry of board 36 at the decoy, as board 37
+
+        Sorted in, it comes before the entry of conf@37. It is not a
+        configuration, so U-Boot must skip it and still pick conf@37.
+        """
+        data, nodes, props = fdt_scan(fit)
+        pos, size = props['/index/compatibles']
+        cells = struct.unpack('>%dL' % (size / 4), data[pos:pos + size])
+        board = lambda n: zlib.crc32('vendor,board-%d' % n) & 0xffffffff
+        entries = []
+        for entry in zip(cells[::2], cells[1::2]):
+            if entry == (board(36), nodes['/configurations/conf@36']):
+                entry = (board(37), nodes['/decoy'])
+            entries.append(entry)
+        entries.sort()
+        assert entries.index((board(37), nodes['/decoy'])) + 1 == \
+            entries.index((board(37), nodes['/configurations/conf@37']))
+        data = (data[:pos] + struct.pack('>%dL' % len(cells),
+                                         *sum(entries, ())) +
+                data[pos + size:])
+        tampered = fit.replace('.fit', '-tampered.fit')
+        with open(tampered, 'wb') as fd:
+            fd.write(data)
+        return tampered
+
+    # without a configuration name, the best match for U-Boot's own
+    # compatible strings is taken, through the index of compatible strings
+    fits = [make_fit(False), make_fit(True)]
+    fits.append(tamper(fits[1]))
+    src = make_fname('control.dts')
+    dtb = make_fname('control.dtb')
+    old_dtb = cons.config.dtb
+    try:
+        for board, n in [(37, 37), (99, 1)]:
+            with open(src, 'w') as fd:
+                print >> fd, base_fdt.replace(
+                    'compatible = "sandbox";',
+                    'compatible = "vendor,board-%d", "vendor,family";' %
+                    board)
+            util.run_and_log(cons, ['dtc', src, '-O', 'dtb', '-o', dtb])
+            cons.config.dtb = dtb
+            cons.restart_uboot()
+            first = None
+            for fit in fits:
+                cons.run_command('sb load hostfs 0 1000000 %s' % fit)
+                picked = bootm('')
+                assert "Using 'conf@%d' configuration" % n in picked
+                assert "Trying 'fdt@%d' fdt subimage" % n in picked
+                assert picked == (first or picked)
+                first = picked
+    finally:
+        cons.config.dtb = old_dtb
+        cons.restart_uboot()
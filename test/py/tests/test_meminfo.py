@@ -0,0 +1,32 @@
+# Copyright (c) 2017 Rockchip Electronics Co., Ltd
+#
+# SPDX-License-Identifier: GPL-2.0
+
+import pytest
+
+@pytest.mark.buildconfigspec('cmd_meminfo')
+def test_meminfo(u_boot_console):
+    """Test that meminfo shows the heap fragmentation."""
+
+    response = u_boot_console.run_command('meminfo')
+    assert('DRAM:' in response)
+    assert('% fragmented' in response)
+
+@pytest.mark.buildconfigspec('cmd_meminfo')
+@pytest.mark.buildconfigspec('malloc_trace')
+def test_meminfo_trace(u_boot_console):
+    """Test that meminfo lists the top owners and call sites."""
+
+    response = u_boot_console.run_command('meminfo 5')
+    assert('untracked' in response)
+    lines = response.splitlines()
+    owners = [n for n, l in enumerate(lines) if l.startswith('owner ')]
+    sites = [n for n, l in enumerate(lines) if l.startswith('site ')]
+    assert(len(owners) == 1 and len(sites) == 1)
+    # at most 5 rows per table, separated by a blank line
+    assert(1 <= sites[0] - owners[0] - 2 <= 5)
+    assert(1 <= len(lines) - sites[0] - 1 <= 5)
+
+    # the devices bound and probed at start-up are charged to their uclass
+    response = u_boot_console.run_command('meminfo 32')
+    assert('root' in response)
@@ -0,0 +1,12 @@
+# Copyright (c) 2017 Rockchip Electronics Co., Ltd
+#
+# SPDX-License-Identifier: GPL-2.0
+
+import pytest
+
+@pytest.mark.boardspec('sandbox')
+def test_sfc_nor_read(u_boot_console):
+    """Test SFC SPI Nor reads against a fake controller."""
+
+    response = u_boot_console.run_command('ut_sfc_nor')
+    assert('ut_sfc_nor ok' in response)
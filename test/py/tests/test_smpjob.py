@@ -0,0 +1,22 @@
+# Copyright (c) 2017 Rockchip Electronics Co., Ltd
+#
+# SPDX-License-Identifier: GPL-2.0
+
+import pytest
+
+@pytest.mark.buildconfigspec('cmd_smpjob')
+def test_smpjob(u_boot_console):
+    """Test that jobs on all CPUs give the same results as on the boot CPU."""
+
+    response = u_boot_console.run_command('smpjob 100000')
+    assert('CPUs, 64 buffers of 16384 bytes' in response)
+    for name in ('memset', 'memcpy', 'crc32', 'sha256'):
+        assert(name in response)
+    assert('mismatch' not in response)
+
+@pytest.mark.buildconfigspec('cmd_smpjob')
+def test_smpjob_usage(u_boot_console):
+    """Test that a size smaller than one byte per buffer is refused."""
+
+    response = u_boot_console.run_command('smpjob 10')
+    assert('Usage:' in response)
@@ -0,0 +1,108 @@
+# Copyright (c) 2017 Rockchip Electronics Co., Ltd
+#
+# SPDX-License-Identifier: GPL-2.0
+
+# Check how much data SPL copies in memory when loading a FIT with external
+# data. Sandbox SPL loads u-boot.img, if present next to U-Boot, reading it
+# as a block device with 512-byte sectors would, then reports what it moved.
+# With a compressed payload SPL also reports what it decompressed.
+
+import os
+import pytest
+import re
+import u_boot_utils as util
+
+BLKSZ = 512
+PAYLOAD_SIZE = 300004
+
+def load_fit(cons, fit, align, comp=None):
+    """Make u-boot.img for SPL, restart and return SPL's statistics
+
+    Args:
+        cons: Console
+        fit: Filename of the FIT to create
+        align: Alignment to give mkimage with -B, or None
+        comp: Tool to compress the payload with, 'lz4' or 'lzma', or None
+
+    Returns:
+        Tuple of bytes read, copied and loaded, then bytes decompressed from
+        and to, which are None without compression
+    """
+    mkimage = cons.config.build_dir + '/tools/mkimage'
+    payload = os.path.join(cons.config.result_dir, 'spl-fit-payload.bin')
+    dtb = os.path.join(cons.config.build_dir, 'u-boot.dtb')
+    with open(payload, 'wb') as fd:
+        if comp:
+            # compressible, yet not entirely
+            block = os.urandom(1024)
+            fd.write((block * (PAYLOAD_SIZE // 1024 + 1))[:PAYLOAD_SIZE])
+        else:
+            fd.write(os.urandom(PAYLOAD_SIZE))
+    if comp:
+        util.run_and_log(cons, [comp, '-f', '-k', payload])
+        payload += '.' + comp
+
+    args = [mkimage, '-f', 'auto', '-A', 'sandbox', '-T', 'firmware',
+            '-C', comp or 'none', '-O', 'u-boot', '-a', '100000',
+            '-e', '100000', '-E', '-d', payload, '-b', dtb]
+    if align:
+        args += ['-B', '%x' % align]
+    util.run_and_log(cons, args + [fit])
+
+    cons.restart_uboot()
+    output = cons.get_spawn_output().replace('\r', '')
+    m = re.search('SPL: FIT read (\d+) bytes, copied (\d+), loaded (\d+)',
+                  output)
+    assert m
+    stats = [int(val) for val in m.groups()]
+    m = re.search('SPL: FIT decompressed (\d+) to (\d+) bytes', output)
+    return stats + ([int(val) for val in m.groups()] if m else [None, None])
+
+@pytest.mark.boardspec('sandbox_spl')
+@pytest.mark.buildconfigspec('spl_load_fit')
+def test_spl_fit(u_boot_console):
+    """Test that SPL reads aligned external data to its load address"""
+
+    cons = u_boot_console
+    fit = os.path.join(cons.config.build_dir, 'u-boot.img')
+    dtb_size = os.path.getsize(os.path.join(cons.config.build_dir,
+                                            'u-boot.dtb'))
+    try:
+        # only the last, partial sector of U-Boot is copied, and the FDT
+        # which is appended to U-Boot at an unaligned address
+        read, copied, loaded, comp, decomp = load_fit(cons, fit, BLKSZ)
+        assert loaded == PAYLOAD_SIZE + dtb_size
+        assert copied == PAYLOAD_SIZE % BLKSZ + dtb_size
+        assert comp is None
+
+        # packed data loads as well, through a bounce at worst
+        read, copied, loaded, comp, decomp = load_fit(cons, fit, None)
+        assert loaded == PAYLOAD_SIZE + dtb_size
+        assert copied <= loaded
+    finally:
+        if os.path.exists(fit):
+            os.remove(fit)
+        cons.restart_uboot()
+
+@pytest.mark.boardspec('sandbox_spl')
+@pytest.mark.buildconfigspec('spl_load_fit')
+@pytest.mark.buildconfigspec('spl_lz4')
+@pytest.mark.buildconfigspec('spl_lzma')
+def test_spl_fit_comp(u_boot_console):
+    """Test that SPL decompresses a payload to its load address"""
+
+    cons = u_boot_console
+    fit = os.path.join(cons.config.build_dir, 'u-boot.img')
+    dtb_size = os.path.getsize(os.path.join(cons.config.build_dir,
+                                            'u-boot.dtb'))
+    try:
+        for comp in ['lz4', 'lzma']:
+            read, copied, loaded, comp_size, decomp = load_fit(cons, fit,
+                                                               BLKSZ, comp)
+            assert decomp == PAYLOAD_SIZE
+            assert comp_size < PAYLOAD_SIZE / 2
+            assert loaded == PAYLOAD_SIZE + dtb_size
+    finally:
+        if os.path.exists(fit):
+            os.remove(fit)
+        cons.restart_uboot()
@@ -0,0 +1,154 @@
+/*
+ * (C) Copyright 2017 Rockchip Electronics Co., Ltd
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ *
+ * Reads of the Rockchip SFC SPI Nor driver, which is built here on top of
+ * a fake controller with a quad I/O chip behind it: see snor_read().
+ */
+
+#include <common.h>
+#include <command.h>
+#include <malloc.h>
+#include <linux/compat.h>
+
+#include "../drivers/rkflash/sfc_nor.c"
+
+/*
+ * The chip in continuous read mode takes no command byte, a mode byte of
+ * SNOR_CONT_MODE_BITS keeps it there. A transfer which fails does not reach
+ * the chip, so it stays in the mode it was in.
+ */
+static struct {
+	bool cont;		/* in continuous read mode */
+	bool bad;		/* got a transfer it does not understand */
+	int xfers;
+	int fail_at;		/* transfer which times out, -1 for none */
+	u32 max_size;		/* largest transfer */
+} chip;
+
+static u8 chip_byte(u32 addr)
+{
+	return addr ^ (addr >> 8) ^ (addr >> 16);
+}
+
+int sfc_request(u32 sfcmd, u32 sfctrl, u32 addr, void *data)
+{
+	union SFCCMD_DATA cmd;
+	u8 *buf = data;
+	u32 i;
+
+	cmd.d32 = sfcmd;
+	if (chip.xfers++ == chip.fail_at)
+		return SFC_RX_TIMEOUT;
+
+	if (cmd.b.rw != SFC_READ || cmd.b.readmode != chip.cont ||
+	    (!chip.cont && cmd.b.cmd != CMD_FAST_READ_A4)) {
+		chip.bad = true;
+		return SFC_ERROR;
+	}
+	chip.cont = (addr & 0xff) == SNOR_CONT_MODE_BITS;
+	addr >>= 8;
+
+	for (i = 0; i < cmd.b.datasize; i++)
+		buf[i] = chip_byte(addr + i);
+	if (cmd.b.datasize > chip.max_size)
+		chip.max_size = cmd.b.datasize;
+
+	return SFC_OK;
+}
+
+#define errcheck(statement) if (!(statement)) { \
+	printf("\tFailed: %s, sec %u n_sec %u cont_read %u fail_at %d\n", \
+	       #statement, sec, n_sec, cont_read, fail_at); \
+	return 1; \
+}
+
+/* Read @n_sec sectors at @sec and check what the chip saw */
+static int run_read_test(struct SFNOR_DEV *dev, u8 *buf, u32 sec, u32 n_sec,
+			 u8 cont_read, int fail_at)
+{
+	u32 i;
+	int ret;
+
+	memset(&chip, '\0', sizeof(chip));
+	chip.fail_at = fail_at;
+	dev->cont_read = cont_read;
+	memset(buf, '\0', n_sec << 9);
+
+	ret = snor_read(dev, sec, n_sec, buf);
+	/* the next command finds the chip out of continuous read mode */
+	errcheck(!chip.cont);
+	errcheck(!chip.bad);
+	if (fail_at >= 0 && fail_at < DIV_ROUND_UP(n_sec << 9,
+						   SFC_MAX_IOSIZE)) {
+		errcheck(ret < 0);
+		return 0;
+	}
+
+	errcheck(ret == n_sec);
+	errcheck(chip.max_size <= SFC_MAX_IOSIZE);
+	errcheck(chip.xfers == DIV_ROUND_UP(n_sec << 9, SFC_MAX_IOSIZE));
+	for (i = 0; i < n_sec << 9; i++)
+		errcheck(buf[i] == chip_byte((sec << 9) + i));
+
+	return 0;
+}
+
+static int do_ut_sfc_nor(cmd_tbl_t *cmdtp, int flag, int argc,
+			 char *const argv[])
+{
+	static const u32 sectors[] = { 1, 15, 16, 17, 30, 31, 100, 2048 };
+	struct SFNOR_DEV dev;
+	int err = 0;
+	int fail_at;
+	u8 cont_read;
+	u8 *buf;
+	uint i;
+
+	/* datasize is 14 bits wide */
+	if (SFC_MAX_DMA_IOSIZE >= 1 << 14) {
+		printf("\tFailed: SFC_MAX_DMA_IOSIZE too large\n");
+		err = 1;
+	}
+
+	for (i = 0; i < 8; i++) {
+		if (snor_read_dma_ok(i) != (i == 4)) {
+			printf("\tFailed: snor_read_dma_ok(%u)\n", i);
+			err = 1;
+		}
+	}
+
+	buf = malloc(2048 << 9);
+	if (!buf)
+		return CMD_RET_FAILURE;
+
+	memset(&dev, '\0', sizeof(dev));
+	dev.capacity = 4096;
+	dev.read_cmd = CMD_FAST_READ_A4;
+	dev.read_lines = DATA_LINES_X4;
+	dev.addr_mode = ADDR_MODE_3BYTE;
+
+	for (i = 0; i < ARRAY_SIZE(sectors); i++) {
+		for (cont_read = 0; cont_read < 2; cont_read++)
+			err |= run_read_test(&dev, buf, 7, sectors[i],
+					     cont_read, -1);
+	}
+
+	/* a read of 7 transfers failing in each of them */
+	for (fail_at = 0; fail_at < 7; fail_at++) {
+		for (cont_read = 0; cont_read < 2; cont_read++)
+			err |= run_read_test(&dev, buf, 7, 100, cont_read,
+					     fail_at);
+	}
+
+	free(buf);
+	printf("ut_sfc_nor %s\n", err == 0 ? "ok" : "FAILED");
+
+	return err ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	ut_sfc_nor,	1,	1,	do_ut_sfc_nor,
+	"Test of the SFC SPI Nor reads", ""
+);
@@ -24,6 +24,196 @@
 
 static image_header_t header;
 
+/* Properties of the index node, in the order of struct fit_index */
+static const char *const fit_index_props[] = {
+	FIT_INDEX_IMAGES_PROP,
+	FIT_INDEX_CONFS_PROP,
+	FIT_INDEX_COMPAT_PROP,
+};
+
+#define FIT_INDEX_PROPS		ARRAY_SIZE(fit_index_props)
+
+/* Entries of the index, pairs of a CRC32 and a node offset */
+struct fit_index {
+	fdt32_t *cell[FIT_INDEX_PROPS];
+	int count[FIT_INDEX_PROPS];
+};
+
+static int fit_index_add(struct fit_index *index, int prop, const char *str,
+			 int len, int noffset)
+{
+	fdt32_t *cell;
+	int n = index->count[prop];
+
+	cell = realloc(index->cell[prop], (n + 1) * 2 * sizeof(*cell));
+	if (!cell)
+		return -ENOMEM;
+	cell[2 * n] = cpu_to_fdt32(crc32(0, (const uint8_t *)str, len));
+	cell[2 * n + 1] = cpu_to_fdt32(noffset);
+	index->cell[prop] = cell;
+	index->count[prop]++;
+
+	return 0;
+}
+
+static int fit_index_cmp(const void *a, const void *b)
+{
+	const fdt32_t *x = a, *y = b;
+	int i;
+
+	for (i = 0; i < 2; i++) {
+		if (fdt32_to_cpu(x[i]) != fdt32_to_cpu(y[i]))
+			return fdt32_to_cpu(x[i]) < fdt32_to_cpu(y[i]) ? -1 : 1;
+	}
+
+	return 0;
+}
+
+static void fit_index_free(struct fit_index *index)
+{
+	int i;
+
+	for (i = 0; i < FIT_INDEX_PROPS; i++)
+		free(index->cell[i]);
+}
+
+/* Get the compatible strings of the FDT configuration @conf refers to */
+static const char *fit_conf_get_compat(const void *fit, int conf, int *lenp)
+{
+	const char *name;
+	const void *fdt;
+	size_t size;
+	int noffset;
+
+	name = fdt_getprop(fit, conf, FIT_FDT_PROP, NULL);
+	if (!name)
+		return NULL;
+	noffset = fit_image_get_node(fit, name);
+	if (noffset < 0 ||
+	    fit_image_get_data_and_size(fit, noffset, &fdt, &size) ||
+	    size < sizeof(struct fdt_header) || fdt_check_header(fdt) ||
+	    fdt_totalsize(fdt) > size)
+		return NULL;
+
+	return fdt_getprop(fdt, 0, "compatible", lenp);
+}
+
+/*
+ * Collect the entries of the index of @fit. Entries for a compatible
+ * string shared by several configurations follow the order of the
+ * configurations, which is the order U-Boot picks them in.
+ */
+static int fit_index_collect(const void *fit, struct fit_index *index)
+{
+	const char *name;
+	int parent, noffset, len, i, ret;
+
+	memset(index, '\0', sizeof(*index));
+	for (i = 0; i < 2; i++) {
+		parent = fdt_path_offset(fit, i ? FIT_CONFS_PATH :
+					 FIT_IMAGES_PATH);
+		if (parent < 0)
+			continue;
+		fdt_for_each_subnode(noffset, fit, parent) {
+			name = fdt_get_name(fit, noffset, &len);
+			ret = fit_index_add(index, i, name, len, noffset);
+			if (ret)
+				return ret;
+			if (!i)
+				continue;
+			name = fit_conf_get_compat(fit, noffset, &len);
+			while (name && len > 0) {
+				ret = fit_index_add(index, 2, name,
+						    strlen(name), noffset);
+				if (ret)
+					return ret;
+				len -= strlen(name) + 1;
+				name += strlen(name) + 1;
+			}
+		}
+	}
+	for (i = 0; i < FIT_INDEX_PROPS; i++) {
+		if (index->count[i])
+			qsort(index->cell[i], index->count[i],
+			      2 * sizeof(fdt32_t), fit_index_cmp);
+	}
+
+	return 0;
+}
+
+/*
+ * Add the index node to @fit, with entries of the final size. Node offsets
+ * change until the FIT is complete, so fit_index_update() sets them then.
+ * The node goes in before signing, as signatures cover it but not its
+ * properties.
+ */
+static int fit_index_add_node(void *fit)
+{
+	struct fit_index index;
+	int node, ret, i;
+
+	ret = fit_index_collect(fit, &index);
+	if (ret)
+		goto out;
+	node = fdt_subnode_offset(fit, 0, FIT_INDEX_NODENAME);
+	if (node == -FDT_ERR_NOTFOUND)
+		node = fdt_add_subnode(fit, 0, FIT_INDEX_NODENAME);
+	ret = node;
+	for (i = 0; ret >= 0 && i < FIT_INDEX_PROPS; i++)
+		ret = fdt_setprop(fit, node, fit_index_props[i],
+				  index.cell[i],
+				  index.count[i] * 2 * sizeof(fdt32_t));
+	if (ret >= 0)
+		ret = fdt_setprop_u32(fit, node, FIT_INDEX_SIZE_PROP, 0);
+	if (ret < 0)
+		ret = ret == -FDT_ERR_NOSPACE ? -ENOSPC : -EIO;
+	else
+		ret = 0;
+out:
+	fit_index_free(&index);
+
+	return ret;
+}
+
+/* Fill in the index of the complete FIT in @fname */
+static int fit_index_update(struct image_tool_params *params,
+			    const char *fname)
+{
+	struct fit_index index;
+	struct stat sbuf;
+	void *fit;
+	int fd, node, ret, i;
+
+	fd = mmap_fdt(params->cmdname, fname, 0, &fit, &sbuf, false);
+	if (fd < 0)
+		return -EIO;
+
+	if (fit_index_collect(fit, &index)) {
+		fprintf(stderr, "%s: Out of memory for the FIT index\n",
+			params->cmdname);
+		ret = -ENOMEM;
+		goto out;
+	}
+	node = fdt_path_offset(fit, FIT_INDEX_PATH);
+	ret = node < 0 ? node : 0;
+	for (i = 0; !ret && i < FIT_INDEX_PROPS; i++)
+		ret = fdt_setprop_inplace(fit, node, fit_index_props[i],
+					  index.cell[i],
+					  index.count[i] * 2 * sizeof(fdt32_t));
+	if (!ret)
+		ret = fdt_setprop_inplace_u32(fit, node, FIT_INDEX_SIZE_PROP,
+					      fdt_size_dt_struct(fit));
+	if (ret)
+		fprintf(stderr, "%s: Can't update the FIT index: %s\n",
+			params->cmdname, fdt_strerror(ret));
+out:
+	fit_index_free(&index);
+	munmap(fit, sbuf.st_size);
+	close(fd);
+
+	return ret ? -EIO : 0;
+}
+
 static int fit_add_file_data(struct image_tool_params *params, size_t size_inc,
 			     const char *tmpfile)
 {
@@ -56,6 +246,9 @@ static int fit_add_file_data(struct image_tool_params *params, size_t size_inc,
 		ret = fit_set_timestamp(ptr, 0, time);
 	}
 
+	if (!ret && params->fit_index)
+		ret = fit_index_add_node(ptr);
+
 	if (!ret) {
 		ret = fit_add_verification_data(params->keydir, dest_blob, ptr,
 						params->comment,
@@ -401,10 +594,14 @@ err_buf:
  *
  * This function cannot cope with FITs with 'data-offset' properties. All
  * data must be in 'data' properties on entry.
+ *
+ * With a block length given (-B), the FIT structure is padded to it and the
+ * data of each image starts on it, so that a loader can read the data from a
+ * block device straight to its load address.
  */
 static int fit_extract_data(struct image_tool_params *params, const char *fname)
 {
-	void *buf;
+	void *buf = NULL;
 	int buf_ptr;
 	int fit_size, new_size;
 	int fd;
@@ -413,20 +610,14 @@ static int fit_extract_data(struct image_tool_params *params, const char *fname)
 	int ret;
 	int images;
 	int node;
+	int align_size = params->bl_len ? params->bl_len : 4;
+	int count = 0;
 
 	fd = mmap_fdt(params->cmdname, fname, 0, &fdt, &sbuf, false);
 	if (fd < 0)
 		return -EIO;
 	fit_size = fdt_totalsize(fdt);
 
-	/* Allocate space to hold the image data we will extract */
-	buf = malloc(fit_size);
-	if (!buf) {
-		ret = -ENOMEM;
-		goto err_munmap;
-	}
-	buf_ptr = 0;
-
 	images = fdt_path_offset(fdt, FIT_IMAGES_PATH);
 	if (images < 0) {
 		debug("%s: Cannot find /images node: %d\n", __func__, images);
@@ -434,6 +625,18 @@ static int fit_extract_data(struct image_tool_params *params, const char *fname)
 		goto err_munmap;
 	}
 
+	/* Allocate space to hold the image data we will extract, padded */
+	for (node = fdt_first_subnode(fdt, images);
+	     node >= 0;
+	     node = fdt_next_subnode(fdt, node))
+		count++;
+	buf = calloc(1, fit_size + count * align_size);
+	if (!buf) {
+		ret = -ENOMEM;
+		goto err_munmap;
+	}
+	buf_ptr = 0;
+
 	for (node = fdt_first_subnode(fdt, images);
 	     node >= 0;
 	     node = fdt_next_subnode(fdt, node)) {
@@ -460,7 +663,7 @@ static int fit_extract_data(struct image_tool_params *params, const char *fname)
 		}
 		fdt_setprop_u32(fdt, node, "data-size", len);
 
-		buf_ptr += (len + 3) & ~3;
+		buf_ptr += (len + align_size - 1) & ~(align_size - 1);
 	}
 
 	/* Pack the FDT and place the data after it */
@@ -469,7 +672,17 @@ static int fit_extract_data(struct image_tool_params *params, const char *fname)
 	debug("Size reduced from %x to %x\n", fit_size, fdt_totalsize(fdt));
 	debug("External data size %x\n", buf_ptr);
 	new_size = fdt_totalsize(fdt);
-	new_size = (new_size + 3) & ~3;
+	new_size = (new_size + align_size - 1) & ~(align_size - 1);
+	if (params->bl_len) {
+		/*
+		 * Readers find the data after the FIT, so make it include the
+		 * pad. Past the end of the file, ftruncate() fills with zeroes.
+		 */
+		memset(fdt + fdt_totalsize(fdt), '\0',
+		       (new_size < sbuf.st_size ? new_size : sbuf.st_size) -
+		       fdt_totalsize(fdt));
+		fdt_set_totalsize(fdt, new_size);
+	}
 	munmap(fdt, sbuf.st_size);
 
 	if (ftruncate(fd, new_size)) {
@@ -698,6 +911,12 @@ static int fit_handle_file(struct image_tool_params *params)
 			goto err_system;
 	}
 
+	if (params->fit_index) {
+		ret = fit_index_update(params, tmpfile);
+		if (ret)
+			goto err_system;
+	}
+
 	if (rename (tmpfile, params->imagefile) == -1) {
 		fprintf (stderr, "%s: Can't rename %s to %s: %s\n",
 				params->cmdname, tmpfile, params->imagefile,
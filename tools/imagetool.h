@@ -75,8 +75,10 @@ struct image_tool_params {
 	struct content_info *content_head;	/* List of files to include */
 	struct content_info *content_tail;
 	bool external_data;	/* Store data outside the FIT */
+	bool fit_index;		/* Add an index of nodes to the FIT */
 	bool quiet;		/* Don't output text in normal operation */
 	unsigned int external_offset;	/* Add padding to external data */
+	unsigned int bl_len;	/* Align external data on this, 0 for 4 */
 	const char *engine_id;	/* Engine to use for signing */
 	char *extraparams;	/* Extra parameters for img creation (-X) */
 };
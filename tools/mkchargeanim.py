@@ -0,0 +1,165 @@
+#!/usr/bin/env python
+#
+# (C) Copyright 2017 Rockchip Electronics Co., Ltd
+#
+# SPDX-License-Identifier:	GPL-2.0+
+#
+
+"""
+Pack charge animation bitmaps into one delta-encoded container.
+
+  tools/mkchargeanim.py -o battery.anim battery_0.bmp ... battery_fail.bmp
+
+The bitmaps are given in the order of 'image[]' in
+drivers/power/charge_animation.c, the last one is the failure image. All of
+them must be uncompressed 24 or 32 bits per pixel and as large as the
+display. See include/power/charge_anim.h for the format.
+"""
+
+import optparse
+import struct
+import sys
+
+MAGIC = b'CANM'
+VERSION = 1
+ALIGN = 512
+MAX_FRAMES = 16
+FRAME_KEY = 1
+
+HEADER_FMT = '<4sHHHHB3xI'
+FRAME_FMT = '<IIHH'
+RUN_FMT = '<HHHH'
+
+# Unchanged pixels shorter than this do not split a run
+RUN_MERGE_GAP = 8
+
+
+class Bitmap(object):
+    def __init__(self, fname):
+        with open(fname, 'rb') as fd:
+            data = fd.read()
+        if data[:2] != b'BM':
+            raise ValueError('%s: not a bitmap' % fname)
+        offset, = struct.unpack_from('<I', data, 10)
+        width, height, planes, bits, compression = struct.unpack_from(
+            '<iiHHI', data, 18)
+        if bits not in (24, 32) or compression not in (0, 3):
+            raise ValueError('%s: %d bpp, compression %d not supported' %
+                             (fname, bits, compression))
+        self.width = width
+        self.height = abs(height)
+        self.bytes_pp = bits // 8
+        stride = (width * self.bytes_pp + 3) & ~3
+        self.rows = []
+        for y in range(self.height):
+            # bitmaps are bottom-up unless the height is negative
+            src = self.height - 1 - y if height > 0 else y
+            start = offset + src * stride
+            self.rows.append(data[start:start + width * self.bytes_pp])
+
+    def rotate(self, rot):
+        bpp = self.bytes_pp
+        if rot == 0:
+            return
+        if rot == 180:
+            self.rows = [b''.join(r[x:x + bpp]
+                                  for x in range(len(r) - bpp, -1, -bpp))
+                         for r in reversed(self.rows)]
+            return
+        pix = [[r[x:x + bpp] for x in range(0, len(r), bpp)]
+               for r in self.rows]
+        w, h = self.width, self.height
+        if rot == 90:
+            self.rows = [b''.join(pix[h - 1 - x][y] for x in range(h))
+                         for y in range(w)]
+        else:
+            self.rows = [b''.join(pix[x][w - 1 - y] for x in range(h))
+                         for y in range(w)]
+        self.width, self.height = h, w
+
+
+def encode(cur, prev, bpp):
+    """Return the runs of 'cur' differing from 'prev' (None: key frame)"""
+    out = []
+    for y, row in enumerate(cur.rows):
+        npix = len(row) // bpp
+        if prev is None:
+            spans = [(0, npix)]
+        else:
+            old = prev.rows[y]
+            spans = []
+            x = 0
+            while x < npix:
+                if row[x * bpp:(x + 1) * bpp] == old[x * bpp:(x + 1) * bpp]:
+                    x += 1
+                    continue
+                if spans and x - spans[-1][1] < RUN_MERGE_GAP:
+                    spans[-1] = (spans[-1][0], x + 1)
+                else:
+                    spans.append((x, x + 1))
+                x += 1
+        for x0, x1 in spans:
+            pixels = row[x0 * bpp:x1 * bpp]
+            out.append(struct.pack(RUN_FMT, y, x0, x1 - x0, 0))
+            out.append(pixels + b'\0' * (-len(pixels) % 4))
+    out.append(struct.pack(RUN_FMT, 0, 0, 0, 0))
+    return b''.join(out)
+
+
+def main():
+    parser = optparse.OptionParser(usage='%prog [options] bitmap...')
+    parser.add_option('-o', '--output', default='battery.anim',
+                      help='container file to write')
+    parser.add_option('-r', '--rotate', type='int', default=0,
+                      help='rotate bitmaps by 0, 90, 180 or 270 degrees')
+    parser.add_option('-k', '--key-every', type='int', default=0,
+                      help='also make every n-th frame a key frame')
+    opts, args = parser.parse_args()
+
+    if not args or len(args) > MAX_FRAMES:
+        parser.error('need 1 to %d bitmaps' % MAX_FRAMES)
+    if opts.rotate not in (0, 90, 180, 270):
+        parser.error('bad rotation %d' % opts.rotate)
+
+    bitmaps = [Bitmap(f) for f in args]
+    for bmp in bitmaps:
+        bmp.rotate(opts.rotate)
+    first = bitmaps[0]
+    for f, bmp in zip(args, bitmaps):
+        if (bmp.width, bmp.height, bmp.bytes_pp) != \
+           (first.width, first.height, first.bytes_pp):
+            sys.exit('%s: size differs from %s' % (f, args[0]))
+
+    frames = []
+    for i, bmp in enumerate(bitmaps):
+        # the failure image is shown on its own, make it a key frame
+        key = (i == 0 or i == len(bitmaps) - 1 or
+               (opts.key_every and i % opts.key_every == 0))
+        data = encode(bmp, None if key else bitmaps[i - 1], bmp.bytes_pp)
+        frames.append((data, FRAME_KEY if key else 0))
+
+    offset = struct.calcsize(HEADER_FMT) + \
+        len(frames) * struct.calcsize(FRAME_FMT)
+    table = []
+    body = []
+    for data, flags in frames:
+        pad = -offset % ALIGN
+        body.append(b'\0' * pad)
+        offset += pad
+        table.append(struct.pack(FRAME_FMT, offset, len(data), flags, 0))
+        body.append(data)
+        offset += len(data)
+
+    header = struct.pack(HEADER_FMT, MAGIC, VERSION, len(frames),
+                         first.width, first.height, first.bytes_pp, offset)
+    with open(opts.output, 'wb') as fd:
+        fd.write(header + b''.join(table) + b''.join(body))
+
+    for i, (data, flags) in enumerate(frames):
+        print('frame %d: %s %d bytes' %
+              (i, 'key' if flags & FRAME_KEY else 'delta', len(data)))
+    print('%s: %d bytes' % (opts.output, offset))
+
+
+if __name__ == '__main__':
+    main()
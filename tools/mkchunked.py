@@ -0,0 +1,123 @@
+#!/usr/bin/env python
+#
+# (C) Copyright 2017 Rockchip Electronics Co., Ltd
+#
+# SPDX-License-Identifier:	GPL-2.0+
+#
+
+"""
+Compress a kernel in chunks which U-Boot decompresses on all CPUs at once.
+
+  tools/mkchunked.py -c gzip -o Image.gz Image
+  tools/mkchunked.py -c lz4 -s 512K -o Image.lz4 Image
+
+The result is a gzip or LZ4 file which gunzip or lz4 decompress like any
+other. LZ4 chunks are compressed with the 'lz4' tool. See
+doc/README.chunked and include/chunked_decomp.h for the format.
+"""
+
+import optparse
+import struct
+import subprocess
+import sys
+import zlib
+
+MAGIC = 0x4b4e4843
+INDEX_FMT = '<IIII'
+ENTRY_FMT = '<II'
+GZIP_SI = b'UC'
+GZIP_FEXTRA = 4
+GZIP_OS_UNIX = 3
+LZ4_MAGIC = 0x184d2a55
+
+
+def gzip_member(data, level, extra=None):
+    """Compress data into a gzip member, with an extra field if given"""
+    comp = zlib.compressobj(level, zlib.DEFLATED, -zlib.MAX_WBITS)
+    body = comp.compress(data) + comp.flush()
+    header = struct.pack('<BBBBIBB', 0x1f, 0x8b, zlib.DEFLATED,
+                         GZIP_FEXTRA if extra is not None else 0, 0, 0,
+                         GZIP_OS_UNIX)
+    if extra is not None:
+        header += struct.pack('<H', len(extra)) + extra
+    return header + body + struct.pack('<II', zlib.crc32(data) & 0xffffffff,
+                                       len(data))
+
+
+def lz4_frame(data, level):
+    """Compress data into an LZ4 frame with the lz4 tool"""
+    proc = subprocess.Popen(['lz4', '-%d' % level, '-z', '-c', '-q'],
+                            stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+    out = proc.communicate(data)[0]
+    if proc.returncode:
+        sys.exit('lz4 failed')
+    return out
+
+
+def make_index(chunk_size, size, parts, base):
+    """Make the index of the parts which follow base bytes of header"""
+    index = struct.pack(INDEX_FMT, MAGIC, len(parts), chunk_size, size)
+    offset = base
+    for part in parts:
+        index += struct.pack(ENTRY_FMT, offset, len(part))
+        offset += len(part)
+    return index
+
+
+def parse_size(text):
+    mult = {'K': 1 << 10, 'M': 1 << 20}.get(text[-1:].upper(), 1)
+    return int(text.rstrip('kKmM')) * mult
+
+
+def main():
+    parser = optparse.OptionParser(usage='%prog [options] file')
+    parser.add_option('-c', '--comp', default='gzip',
+                      help='compression, gzip or lz4')
+    parser.add_option('-s', '--chunk-size', default='1M',
+                      help='decompressed size of a chunk, with K or M suffix')
+    parser.add_option('-l', '--level', type='int', default=9,
+                      help='compression level')
+    parser.add_option('-o', '--output', help='file to write')
+    opts, args = parser.parse_args()
+
+    if len(args) != 1 or not opts.output:
+        parser.error('need a file and an output file')
+    if opts.comp not in ('gzip', 'lz4'):
+        parser.error('bad compression %s' % opts.comp)
+    chunk_size = parse_size(opts.chunk_size)
+    if chunk_size <= 0:
+        parser.error('bad chunk size %s' % opts.chunk_size)
+
+    with open(args[0], 'rb') as fd:
+        data = fd.read()
+    if not data or len(data) >= 1 << 32:
+        sys.exit('%s: cannot chunk %d bytes' % (args[0], len(data)))
+    chunks = [data[i:i + chunk_size] for i in range(0, len(data), chunk_size)]
+    index_len = (struct.calcsize(INDEX_FMT) +
+                 len(chunks) * struct.calcsize(ENTRY_FMT))
+
+    if opts.comp == 'gzip':
+        # the index has a fixed size, so member 0 is made twice to fill it in
+        if 4 + index_len > 0xffff:
+            sys.exit('too many chunks for a gzip extra field')
+        subfield = GZIP_SI + struct.pack('<H', index_len)
+        parts = [gzip_member(chunks[0], opts.level,
+                             subfield + b'\0' * index_len)]
+        parts += [gzip_member(c, opts.level) for c in chunks[1:]]
+        index = make_index(chunk_size, len(data), parts, 0)
+        parts[0] = gzip_member(chunks[0], opts.level, subfield + index)
+        out = b''.join(parts)
+    else:
+        parts = [lz4_frame(c, opts.level) for c in chunks]
+        index = make_index(chunk_size, len(data), parts, 8 + index_len)
+        out = struct.pack('<II', LZ4_MAGIC, index_len) + index + \
+            b''.join(parts)
+
+    with open(opts.output, 'wb') as fd:
+        fd.write(out)
+    print('%s: %d chunks of %d bytes, %d bytes' %
+          (opts.output, len(chunks), chunk_size, len(out)))
+
+
+if __name__ == '__main__':
+    main()